@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "skin/image.h"
+#include "skin/skin_parser.h"
+#include "scene/mesh_builder.h"
+#include "scene/pose.h"
+#include "raytracer/intersection.h"
+
+// 基准测试公用数据
+//
+// Everything here is synthetic and seeded, so two runs on the same machine
+// trace exactly the same rays through exactly the same skins.
+
+namespace bench {
+
+constexpr uint32_t kSeed = 20240501;
+
+// Deterministic skin image (64x64 or legacy 64x32). Inner-layer pixels are
+// opaque noise; the outer-layer blocks are about half transparent, so outer
+// meshes exist and exercise the alpha pass-through path.
+inline Image makeSkinImage(int height = 64, uint32_t seed = kSeed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Image img(64, height);
+    for (Color& c : img.pixels) c = Color(unit(rng), unit(rng), unit(rng), 1.0f);
+
+    auto punch = [&](int x0, int y0, int w, int h) {
+        for (int y = y0; y < y0 + h && y < height; ++y)
+            for (int x = x0; x < x0 + w; ++x)
+                if (unit(rng) < 0.5f) img.pixels[y * 64 + x].a = 0.0f;
+    };
+    punch(32, 0, 32, 16);           // hat
+    if (height == 64) {
+        punch(0, 32, 56, 16);       // right pants, jacket, right sleeve
+        punch(0, 48, 16, 16);       // left pants
+        punch(48, 48, 16, 16);      // left sleeve
+    }
+    return img;
+}
+
+inline std::vector<uint8_t> toRGBA8(const Image& img) {
+    std::vector<uint8_t> out(img.pixels.size() * 4);
+    for (size_t i = 0; i < img.pixels.size(); ++i) {
+        const Color& c = img.pixels[i];
+        out[i * 4 + 0] = static_cast<uint8_t>(c.r * 255.0f + 0.5f);
+        out[i * 4 + 1] = static_cast<uint8_t>(c.g * 255.0f + 0.5f);
+        out[i * 4 + 2] = static_cast<uint8_t>(c.b * 255.0f + 0.5f);
+        out[i * 4 + 3] = static_cast<uint8_t>(c.a * 255.0f + 0.5f);
+    }
+    return out;
+}
+
+inline SkinData makeSkin(int height = 64, uint32_t seed = kSeed) {
+    std::vector<uint8_t> rgba = toRGBA8(makeSkinImage(height, seed));
+    return *SkinParser::parse(Rgba8View{rgba.data(), 64, height}).value;
+}
+
+// Scene built from the synthetic skin; poseIndex indexes getBuiltinPoses()
+inline Scene makeScene(int poseIndex = 0) {
+    std::vector<Pose> poses = getBuiltinPoses();
+    return MeshBuilder::buildScene(makeSkin(), poses[poseIndex % poses.size()]);
+}
+
+// Primary rays over a size x size grid of the scene's camera
+inline std::vector<Ray> cameraRays(const Scene& scene, int size) {
+    std::vector<Ray> rays;
+    rays.reserve(static_cast<size_t>(size) * size);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            rays.push_back(scene.camera.generateRay((x + 0.5f) / size, (y + 0.5f) / size, 1.0f));
+    return rays;
+}
+
+// Closest hits of cameraRays(); misses are dropped
+inline std::vector<HitResult> cameraHits(const Scene& scene, int size) {
+    std::vector<HitResult> hits;
+    for (const Ray& ray : cameraRays(scene, size)) {
+        HitResult hit = intersectScene(ray, scene);
+        if (hit.hit) hits.push_back(hit);
+    }
+    return hits;
+}
+
+}  // namespace bench
@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.h"
+#include "raytracer/shading.h"
+#include "raytracer/raytracer.h"
+
+// Kernels of the ray tracer, one ray (or one sample) per iteration.
+// Inputs are precomputed outside the timed loop and cycled through.
+
+// ── Intersection ────────────────────────────────────────────────────────────
+
+// Rays from the camera towards jittered points around a mesh's centroid;
+// roughly half of them hit, the rest graze past or go through transparent
+// outer-layer pixels
+static std::vector<Ray> raysTowards(const Scene& scene, const Mesh& mesh, int count) {
+    Vec3 center(0, 0, 0);
+    for (const Triangle& tri : mesh.triangles) center = center + tri.v0 + tri.v1 + tri.v2;
+    center = center / static_cast<float>(mesh.triangles.size() * 3);
+
+    std::mt19937 rng(bench::kSeed);
+    std::uniform_real_distribution<float> jitter(-4.0f, 4.0f);
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Vec3 target = center + Vec3(jitter(rng), jitter(rng), jitter(rng));
+        rays.emplace_back(scene.camera.position, (target - scene.camera.position).normalize());
+    }
+    return rays;
+}
+
+// Args: rotated (0/1), outer layer (0/1)
+static void BM_IntersectMesh(benchmark::State& state) {
+    const bool rotated = state.range(0) != 0;
+    const bool outer = state.range(1) != 0;
+    // "奔跑" rotates the limbs; the torso never rotates
+    Scene scene = bench::makeScene(rotated ? 2 : 0);
+
+    const Mesh* mesh = nullptr;
+    for (const Mesh& m : scene.meshes) {
+        if (m.hasRotation == rotated && m.isOuterLayer == outer) { mesh = &m; break; }
+    }
+    if (!mesh) {
+        state.SkipWithError("no matching mesh in scene");
+        return;
+    }
+    std::vector<Ray> rays = raysTowards(scene, *mesh, 1024);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(intersectMesh(rays[i], *mesh));
+        i = (i + 1) % rays.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IntersectMesh)
+    ->ArgNames({"rotated", "outer"})
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1});
+
+// Arg: pose index
+static void BM_IntersectScene(benchmark::State& state) {
+    Scene scene = bench::makeScene(static_cast<int>(state.range(0)));
+    std::vector<Ray> rays = bench::cameraRays(scene, 64);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(intersectScene(rays[i], scene));
+        i = (i + 1) % rays.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["meshes"] = static_cast<double>(scene.meshes.size());
+}
+BENCHMARK(BM_IntersectScene)->ArgName("pose")->Arg(0)->Arg(2);
+
+// ── Shadows / AO ────────────────────────────────────────────────────────────
+
+static void BM_IsInShadow(benchmark::State& state) {
+    Scene scene = bench::makeScene();
+    std::vector<HitResult> hits = bench::cameraHits(scene, 64);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const HitResult& h = hits[i];
+        benchmark::DoNotOptimize(isInShadow(h.point, h.normal, scene.light.position, scene));
+        i = (i + 1) % hits.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsInShadow);
+
+// Arg: area light samples
+static void BM_ComputeSoftShadow(benchmark::State& state) {
+    Scene scene = bench::makeScene();
+    std::vector<HitResult> hits = bench::cameraHits(scene, 64);
+    const int samples = static_cast<int>(state.range(0));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const HitResult& h = hits[i];
+        benchmark::DoNotOptimize(computeSoftShadow(h.point, h.normal, scene.light, scene,
+                                                   samples, static_cast<unsigned>(i)));
+        i = (i + 1) % hits.size();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_ComputeSoftShadow)->ArgName("samples")->Arg(1)->Arg(8)->Arg(32);
+
+// Arg: hemisphere samples
+static void BM_ComputeAO(benchmark::State& state) {
+    Scene scene = bench::makeScene();
+    std::vector<HitResult> hits = bench::cameraHits(scene, 64);
+    const int samples = static_cast<int>(state.range(0));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const HitResult& h = hits[i];
+        benchmark::DoNotOptimize(RayTracer::computeAO(h.point, h.normal, scene, samples,
+                                                      3.0f, static_cast<unsigned>(i)));
+        i = (i + 1) % hits.size();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_ComputeAO)->ArgName("samples")->Arg(4)->Arg(8)->Arg(16);
+
+// ── Shading ─────────────────────────────────────────────────────────────────
+
+// Arg: 0 = hard shadow ray inside shade(), 1 = precomputed shadow factor
+static void BM_Shade(benchmark::State& state) {
+    Scene scene = bench::makeScene();
+    std::vector<HitResult> hits = bench::cameraHits(scene, 64);
+    const float shadowFactor = state.range(0) ? 0.5f : -1.0f;
+    const Vec3 viewDir(0, 0, 1);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shade(hits[i], viewDir, scene.light, scene,
+                                       ShadingParams{}, shadowFactor));
+        i = (i + 1) % hits.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Shade)->ArgName("precomputed_shadow")->Arg(0)->Arg(1);
+
+// ── Camera / texture ────────────────────────────────────────────────────────
+
+static void BM_GenerateRay(benchmark::State& state) {
+    Scene scene = bench::makeScene();
+    const int size = 256;
+
+    int i = 0;
+    for (auto _ : state) {
+        float u = ((i % size) + 0.5f) / size;
+        float v = ((i / size) % size + 0.5f) / size;
+        benchmark::DoNotOptimize(scene.camera.generateRay(u, v, 16.0f / 9.0f));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateRay);
+
+// Arg: texture edge length
+static void BM_TextureRegionSample(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    std::mt19937 rng(bench::kSeed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    TextureRegion tex(size, size);
+    for (Color& c : tex.pixels) c = Color(unit(rng), unit(rng), unit(rng), 1.0f);
+    std::vector<float> uv(2048);
+    for (float& f : uv) f = unit(rng);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tex.sample(uv[i], uv[i + 1]));
+        i = (i + 2) % uv.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TextureRegionSample)->ArgName("size")->Arg(8)->Arg(64);
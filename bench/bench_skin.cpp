@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.h"
+#include "output/image_writer.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+// Skin loading, scene building and PNG output, one call per iteration
+
+static fs::path benchDir() {
+    fs::path dir = fs::temp_directory_path() / "mcskin_bench";
+    fs::create_directories(dir);
+    return dir;
+}
+
+// ── Skin parsing ────────────────────────────────────────────────────────────
+
+// Args: source (0 = PNG file, 1 = PNG in memory, 2 = decoded RGBA8),
+//       image height (64 = current format, 32 = legacy)
+static void BM_SkinParserParse(benchmark::State& state) {
+    const int source = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+
+    Image img = bench::makeSkinImage(height);
+    std::string path = (benchDir() / ("skin_" + std::to_string(height) + ".png")).string();
+    img.savePNG(path);
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> png((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> rgba = bench::toRGBA8(img);
+
+    for (auto _ : state) {
+        switch (source) {
+        case 0: benchmark::DoNotOptimize(SkinParser::parse(path)); break;
+        case 1: benchmark::DoNotOptimize(SkinParser::parseFromMemory(png.data(), png.size())); break;
+        default: benchmark::DoNotOptimize(SkinParser::parse(Rgba8View{rgba.data(), 64, height})); break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SkinParserParse)
+    ->ArgNames({"source", "height"})
+    ->ArgsProduct({{0, 1, 2}, {64, 32}});
+
+// ── Scene building ──────────────────────────────────────────────────────────
+
+// Arg: pose index
+static void BM_BuildScene(benchmark::State& state) {
+    SkinData skin = bench::makeSkin();
+    std::vector<Pose> poses = getBuiltinPoses();
+    const Pose& pose = poses[state.range(0) % poses.size()];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MeshBuilder::buildScene(skin, pose));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BuildScene)->ArgName("pose")->DenseRange(0, 5);
+
+// ── PNG output ──────────────────────────────────────────────────────────────
+
+// Arg: square image edge length
+static void BM_WritePNG(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    std::mt19937 rng(bench::kSeed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Smooth gradient with a little noise, closer to a render than pure noise
+    Image img(size, size);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            img.pixels[y * size + x] = Color(static_cast<float>(x) / size,
+                                             static_cast<float>(y) / size,
+                                             0.5f + 0.05f * unit(rng), 1.0f);
+    std::string path = (benchDir() / "out.png").string();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ImageWriter::writePNG(img, path));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size) * size * 4);
+}
+BENCHMARK(BM_WritePNG)->ArgName("size")->Arg(128)->Arg(512)->Unit(benchmark::kMillisecond);
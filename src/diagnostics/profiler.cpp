@@ -0,0 +1,206 @@
+#include "diagnostics/profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Profiler::enabled_{false};
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    int64_t start;
+    int64_t duration;
+    int64_t arg;
+};
+
+// Ring buffer of one thread at a time. The lock is only ever contended by
+// an export running while the owner records. The buffer is one row of the
+// trace: a thread that takes over a recycled buffer keeps its tid, and the
+// row shows the name of the last thread that set one.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0;      // write position
+    bool wrapped = false;
+    uint32_t tid = 0;
+    std::string name;     // guarded by Registry::mutex
+};
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> free;
+    size_t capacity = 1 << 16;
+    // Read by now() on every zone without the lock
+    std::atomic<int64_t> epochNs{steadyNs()};
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Per-thread handle: takes a buffer on first use, hands it back on exit
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+
+    ThreadBuffer* acquire() {
+        if (buffer) return buffer;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free.empty()) {
+            buffer = r.free.back();
+            r.free.pop_back();
+        } else {
+            r.buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = r.buffers.back().get();
+            buffer->events.resize(r.capacity);
+            buffer->tid = static_cast<uint32_t>(r.buffers.size());
+        }
+        return buffer;
+    }
+
+    ~ThreadSlot() {
+        if (!buffer) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free.push_back(buffer);
+    }
+};
+
+ThreadSlot& threadSlot() {
+    thread_local ThreadSlot slot;
+    return slot;
+}
+
+void appendEscaped(std::string& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+}
+
+}  // namespace
+
+void Profiler::enable(size_t eventsPerThread) {
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.capacity = std::max<size_t>(1, eventsPerThread);
+        r.epochNs.store(steadyNs(), std::memory_order_relaxed);
+        for (auto& b : r.buffers) {
+            std::lock_guard<std::mutex> bufLock(b->mutex);
+            b->events.assign(r.capacity, Event{});
+            b->next = 0;
+            b->wrapped = false;
+        }
+    }
+    enabled_.store(true);
+}
+
+void Profiler::disable() {
+    enabled_.store(false);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer* b = threadSlot().acquire();
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    b->name = name;
+}
+
+int64_t Profiler::now() {
+    return steadyNs() - registry().epochNs.load(std::memory_order_relaxed);
+}
+
+void Profiler::record(const char* name, const char* category,
+                      int64_t startNs, int64_t durationNs, int64_t arg) {
+    ThreadBuffer* b = threadSlot().acquire();
+    std::lock_guard<std::mutex> lock(b->mutex);
+    b->events[b->next] = Event{name, category, startNs, durationNs, arg};
+    if (++b->next == b->events.size()) {
+        b->next = 0;
+        b->wrapped = true;
+    }
+}
+
+size_t Profiler::eventCount() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    size_t n = 0;
+    for (auto& b : r.buffers) {
+        std::lock_guard<std::mutex> bufLock(b->mutex);
+        n += b->wrapped ? b->events.size() : b->next;
+    }
+    return n;
+}
+
+std::string Profiler::chromeTraceJson() {
+    std::vector<std::pair<Event, uint32_t>> events;   // event, tid
+    std::map<uint32_t, std::string> names;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto& b : r.buffers) {
+            if (!b->name.empty()) names[b->tid] = b->name;
+            std::lock_guard<std::mutex> bufLock(b->mutex);
+            size_t count = b->wrapped ? b->events.size() : b->next;
+            size_t first = b->wrapped ? b->next : 0;
+            for (size_t i = 0; i < count; ++i) {
+                events.emplace_back(b->events[(first + i) % b->events.size()], b->tid);
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const auto& a, const auto& b) { return a.first.start < b.first.start; });
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char buf[256];
+    bool first = true;
+    for (const auto& [tid, name] : names) {
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                      first ? "" : ",\n", tid);
+        out += buf;
+        appendEscaped(out, name);
+        out += "\"}}";
+        first = false;
+    }
+    for (const auto& [e, tid] : events) {
+        // Chrome expects microseconds; keep sub-µs precision
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                      "\"pid\":1,\"tid\":%u",
+                      first ? "" : ",\n", e.name, e.category,
+                      e.start / 1000.0, e.duration / 1000.0, tid);
+        out += buf;
+        if (e.arg != ProfileZone::NO_ARG) {
+            std::snprintf(buf, sizeof(buf), ",\"args\":{\"value\":%lld}",
+                          static_cast<long long>(e.arg));
+            out += buf;
+        }
+        out += "}";
+        first = false;
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::string json = chromeTraceJson();
+    size_t written = std::fwrite(json.data(), 1, json.size(), f);
+    return std::fclose(f) == 0 && written == json.size();
+}
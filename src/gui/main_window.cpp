@@ -11,12 +11,35 @@
 #include <QScrollArea>
 #include <QColorDialog>
 #include <QApplication>
+#include <QFile>
+#include <QStatusBar>
+#include <QCloseEvent>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QDir>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 #include "skin/skin_parser.h"
 #include "skin/skin_fetcher.h"
 #include "scene/mesh_builder.h"
 #include "raytracer/tile_renderer.h"
+#include "raytracer/progressive_renderer.h"
+#include "raytracer/autotuner.h"
 #include "output/image_writer.h"
+#include "output/export_queue.h"
+#include "output/render_job.h"
+
+// Ray-traced frame → QImage (detached copy, safe to hand to the UI thread)
+static QImage toQImage(const Image& frame)
+{
+    std::vector<uint8_t> rgba = ImageWriter::toRGBA8(frame);
+    QImage image(rgba.data(), frame.width, frame.height, frame.width * 4,
+                 QImage::Format_RGBA8888);
+    return image.copy();
+}
 
 // Event filter that blocks wheel events on unfocused widgets
 class NoScrollWheelFilter : public QObject {
@@ -42,12 +65,20 @@ MainWindow::MainWindow(QWidget* parent)
     setWindowTitle(tr("Minecraft 皮肤光线追踪渲染器"));
     resize(1100, 750);
     setupUi();
+    loadTuningProfile();
 }
 
 MainWindow::~MainWindow()
 {
-    if (renderThread_.joinable())
-        renderThread_.join();
+    // Stop the render threads before the widgets their updates target go
+    // away. A calibration in flight is cancelled and joined; its queued
+    // result is dropped with this object.
+    tuneCancel_.store(true);
+    if (tuneThread_.joinable())
+        tuneThread_.join();
+    progressive_.reset();
+    regionRenderer_.reset();
+    exportQueue_.reset();
 }
 
 void MainWindow::setupUi()
@@ -249,6 +280,12 @@ void MainWindow::setupUi()
     sppCount_->setValue(64);
     renderForm->addRow(tr("采样数 (AA):"), sppCount_);
 
+    // Progressive ray-traced viewport: coarse while moving, refines up to
+    // the export sample count when idle
+    rtPreviewCheck_ = new QCheckBox(tr("光追预览"), this);
+    rtPreviewCheck_->setChecked(false);
+    renderForm->addRow(rtPreviewCheck_);
+
     panel->addWidget(renderGroup);
 
     // Visual effects
@@ -278,6 +315,7 @@ void MainWindow::setupUi()
             gradientBgCheck_->isChecked(),
             static_cast<float>(gradientScale_->value()),
             bgCenterColor_, bgEdgeColor_);
+        restartRtPreview();
     };
 
     connect(bgCenterColorBtn_, &QPushButton::clicked, this, [this, setButtonColor, updateBgPreview]() {
@@ -334,6 +372,11 @@ void MainWindow::setupUi()
     lightRadius_->setValue(3.0);
     fxForm->addRow(tr("光源半径:"), lightRadius_);
 
+    autoQualityCheck_ = new QCheckBox(tr("小尺寸输出自动降低效果"), this);
+    autoQualityCheck_->setChecked(false);
+    autoQualityCheck_->setToolTip(tr("纹素在画面上只有几个像素时，按比例减少阴影/AO 采样和反弹次数，模糊不足一像素时关闭景深"));
+    fxForm->addRow(autoQualityCheck_);
+
     panel->addWidget(fxGroup);
 
     // Output resolution
@@ -350,8 +393,14 @@ void MainWindow::setupUi()
     panel->addWidget(resGroup);
 
     // Render & export
-    renderBtn_ = new QPushButton(tr("渲染并导出"), this);
+    renderBtn_ = new QPushButton(tr("加入导出队列"), this);
     panel->addWidget(renderBtn_);
+    captureJobBtn_ = new QPushButton(tr("抓取渲染任务..."), this);
+    captureJobBtn_->setToolTip(tr("将皮肤、姿势、相机、光源和渲染参数保存为 .mcjob，可用 mcskin_replay 复现"));
+    panel->addWidget(captureJobBtn_);
+    tuneBtn_ = new QPushButton(tr("校准渲染参数"), this);
+    tuneBtn_->setToolTip(tr("用短时校准渲染为当前分辨率和效果挑选最快的图块大小与线程数，结果按本机保存"));
+    panel->addWidget(tuneBtn_);
 
     progressBar_ = new QProgressBar(this);
     progressBar_->setRange(0, 100);
@@ -359,13 +408,40 @@ void MainWindow::setupUi()
     progressBar_->setVisible(false);
     panel->addWidget(progressBar_);
 
+    // Export queue
+    auto* queueGroup = new QGroupBox(tr("导出队列"), this);
+    auto* queueLayout = new QVBoxLayout(queueGroup);
+    exportList_ = new QListWidget(this);
+    exportList_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    exportList_->setMinimumHeight(90);
+    cancelExportBtn_ = new QPushButton(tr("取消所选"), this);
+    queueLayout->addWidget(exportList_);
+    queueLayout->addWidget(cancelExportBtn_);
+    panel->addWidget(queueGroup);
+
+    // Region re-render
+    auto* regionGroup = new QGroupBox(tr("区域重渲染"), this);
+    auto* regionForm = new QFormLayout(regionGroup);
+    auto* regionHint = new QLabel(
+        tr("在预览中按住 Shift 拖拽框选，以更高采样数重渲染上一次导出的局部"), this);
+    regionHint->setWordWrap(true);
+    regionForm->addRow(regionHint);
+    regionSpp_ = new QSpinBox(this);
+    regionSpp_->setRange(1, 4096);
+    regionSpp_->setValue(256);
+    regionForm->addRow(tr("区域采样数:"), regionSpp_);
+    regionSaveBtn_ = new QPushButton(tr("保存合成图"), this);
+    regionSaveBtn_->setEnabled(false);
+    regionForm->addRow(regionSaveBtn_);
+    panel->addWidget(regionGroup);
+
     panel->addStretch();
     scrollArea->setWidget(panelWidget);
     mainLayout->addWidget(scrollArea);
 
     // Disable wheel-to-change on all spinboxes and combos
     for (auto* w : std::initializer_list<QWidget*>{
-            bounceCount_, sppCount_, aoSamples_, outputWidth_, outputHeight_,
+            bounceCount_, sppCount_, aoSamples_, outputWidth_, outputHeight_, regionSpp_,
             gradientScale_, aperture_, shadowSamples_, lightRadius_, poseCombo_}) {
         w->setFocusPolicy(Qt::StrongFocus);
         w->installEventFilter(wheelFilter);
@@ -374,6 +450,9 @@ void MainWindow::setupUi()
     // Connections
     connect(importBtn_, &QPushButton::clicked, this, &MainWindow::onImportSkin);
     connect(renderBtn_, &QPushButton::clicked, this, &MainWindow::onRenderExport);
+    connect(captureJobBtn_, &QPushButton::clicked, this, &MainWindow::onCaptureJob);
+    connect(tuneBtn_, &QPushButton::clicked, this, &MainWindow::onTuneRenderer);
+    connect(cancelExportBtn_, &QPushButton::clicked, this, &MainWindow::onCancelExport);
     connect(lightX_, &QSlider::valueChanged, this, &MainWindow::onLightPosChanged);
     connect(lightY_, &QSlider::valueChanged, this, &MainWindow::onLightPosChanged);
     connect(lightZ_, &QSlider::valueChanged, this, &MainWindow::onLightPosChanged);
@@ -388,6 +467,61 @@ void MainWindow::setupUi()
     connect(outputHeight_, QOverload<int>::of(&QSpinBox::valueChanged),
             this, updateExportRes);
 
+    // Export queue: updates arrive on the render thread and are applied on
+    // the UI thread
+    exportQueue_ = std::make_unique<ExportQueue>([this](const ExportJobInfo& info) {
+        QMetaObject::invokeMethod(this, [this, info]() { onExportUpdate(info); },
+                                  Qt::QueuedConnection);
+    });
+
+    // Live render statistics in the status bar, polled while a job runs
+    statsLabel_ = new QLabel(this);
+    statsLabel_->setVisible(false);
+    statusBar()->addPermanentWidget(statsLabel_);
+    statsTimer_ = new QTimer(this);
+    statsTimer_->setInterval(250);
+    connect(statsTimer_, &QTimer::timeout, this, &MainWindow::updateRenderStats);
+
+    // Ray-traced preview: frames arrive on the render thread and are handed
+    // to the UI thread as QImages; any change restarts refinement
+    progressive_ = std::make_unique<ProgressiveRenderer>(
+        [this](const Image& frame, int samples, uint64_t generation) {
+            QImage image = toQImage(frame);
+            QMetaObject::invokeMethod(this,
+                [this, image, samples, generation]() {
+                    onRtPreviewFrame(image, samples, generation);
+                },
+                Qt::QueuedConnection);
+        });
+
+    // Region re-render of the last export (Shift+drag in the preview)
+    regionRenderer_ = std::make_unique<ProgressiveRenderer>(
+        [this](const Image& frame, int samples, uint64_t generation) {
+            QImage image = toQImage(frame);
+            QMetaObject::invokeMethod(this,
+                [this, image, samples, generation]() {
+                    onRegionFrame(image, samples, generation);
+                },
+                Qt::QueuedConnection);
+        });
+    connect(preview_, &RasterPreview::regionSelected, this, &MainWindow::onRegionSelected);
+    connect(regionSaveBtn_, &QPushButton::clicked, this, &MainWindow::onSaveRegionComposite);
+
+    connect(rtPreviewCheck_, &QCheckBox::toggled, this, &MainWindow::restartRtPreview);
+    connect(preview_, &RasterPreview::cameraChanged, this, &MainWindow::restartRtPreview);
+    for (auto* spin : {bounceCount_, sppCount_, aoSamples_, shadowSamples_,
+                       outputWidth_, outputHeight_}) {
+        connect(spin, QOverload<int>::of(&QSpinBox::valueChanged),
+                this, &MainWindow::restartRtPreview);
+    }
+    for (auto* check : {aoCheck_, dofCheck_, softShadowCheck_, autoQualityCheck_}) {
+        connect(check, &QCheckBox::toggled, this, &MainWindow::restartRtPreview);
+    }
+    connect(aperture_, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::restartRtPreview);
+    connect(lightRadius_, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onLightPosChanged);
+
     // Default scene
     scene_ = MeshBuilder::buildDefaultScene();
     preview_->setScene(scene_);
@@ -416,11 +550,11 @@ void MainWindow::onFetchByUsername()
     skinFetcher_->fetch(username);
 }
 
-void MainWindow::onSkinFetched(const QString& filePath)
+void MainWindow::onSkinFetched(const QByteArray& pngData)
 {
     fetchBtn_->setEnabled(true);
     fetchBtn_->setText(tr("获取"));
-    loadSkinFile(filePath);
+    loadSkinData(pngData);
 }
 
 void MainWindow::onSkinFetchError(const QString& message)
@@ -432,13 +566,29 @@ void MainWindow::onSkinFetchError(const QString& message)
 
 void MainWindow::loadSkinFile(const QString& filePath)
 {
-    auto result = SkinParser::parse(filePath.toStdString());
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QMessageBox::warning(this, tr("导入失败"),
+            tr("无法读取文件：%1").arg(filePath));
+        return;
+    }
+    loadSkinData(file.readAll());
+}
+
+void MainWindow::loadSkinData(const QByteArray& pngData)
+{
+    auto result = SkinParser::parseFromMemory(
+        reinterpret_cast<const uint8_t*>(pngData.constData()),
+        static_cast<size_t>(pngData.size()));
     if (!result.isOk()) {
         QMessageBox::warning(this, tr("导入失败"), QString::fromStdString(*result.error));
         return;
     }
 
     currentSkin_ = *result.value;
+    currentSkinPixels_ = Rgba8Image::decode(
+        reinterpret_cast<const uint8_t*>(pngData.constData()),
+        static_cast<size_t>(pngData.size()));
     skinLoaded_ = true;
     rebuildScene();
 }
@@ -465,6 +615,7 @@ void MainWindow::rebuildScene()
     scene_.light.radius = static_cast<float>(lightRadius_->value());
 
     preview_->setScene(scene_);
+    restartRtPreview();
 }
 
 void MainWindow::onPoseChanged(int /*index*/)
@@ -486,20 +637,138 @@ void MainWindow::onRenderExport()
     if (!outputPath.endsWith(".png", Qt::CaseInsensitive))
         outputPath += ".png";
 
-    renderBtn_->setEnabled(false);
-    progressBar_->setValue(0);
-    progressBar_->setVisible(true);
+    // Queue a snapshot of the current scene, camera and settings; the user
+    // can keep editing (and queue more exports) while it renders
+    RayTracer::Config config = buildRenderConfig();
+    Scene snapshot = scene_;
+    snapshot.camera = preview_->currentCamera();
+
+    int id = exportQueue_->enqueue(snapshot, config, outputPath.toStdString());
+    auto* item = new QListWidgetItem(exportList_);
+    item->setData(Qt::UserRole, id);
+    ExportJobInfo info;
+    info.id = id;
+    info.outputPath = outputPath.toStdString();
+    info.width = config.width;
+    info.height = config.height;
+    info.samplesPerPixel = config.samplesPerPixel;
+    item->setText(exportJobText(info));
+    item->setToolTip(outputPath);
+}
 
-    // Disable all controls during rendering
-    setControlsEnabled(false);
+void MainWindow::onCaptureJob()
+{
+    QString outputPath = QFileDialog::getSaveFileName(
+        this, tr("保存渲染任务"), QString(),
+        tr("渲染任务 (*.mcjob);;所有文件 (*)"));
+    if (outputPath.isEmpty()) return;
+    if (!outputPath.endsWith(".mcjob", Qt::CaseInsensitive))
+        outputPath += ".mcjob";
+
+    // Exactly what onRenderExport() would queue
+    int poseIdx = poseCombo_->currentIndex();
+    Pose pose = (poseIdx >= 0 && poseIdx < static_cast<int>(poses_.size()))
+                ? poses_[poseIdx] : Pose{};
+    Scene snapshot = scene_;
+    snapshot.camera = preview_->currentCamera();
+    RenderJob job = RenderJob::capture(currentSkinPixels_ ? &*currentSkinPixels_ : nullptr,
+                                       pose, snapshot, buildRenderConfig());
 
+    if (RenderJobFile::write(job, outputPath.toStdString())) {
+        statusBar()->showMessage(tr("渲染任务已保存至：%1").arg(outputPath), 10000);
+    } else {
+        QMessageBox::warning(this, tr("保存失败"),
+            tr("无法保存渲染任务至：\n%1\n请检查文件路径是否可写。").arg(outputPath));
+    }
+}
+
+void MainWindow::loadTuningProfile()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (dir.isEmpty()) return;
+    tuningProfilePath_ = dir + "/tuning.txt";
+    auto loaded = TuningProfile::load(tuningProfilePath_.toStdString());
+    if (loaded.isOk()) Autotuner::setProfile(*loaded.value);   // ignored if from another machine
+}
+
+void MainWindow::onTuneRenderer()
+{
+    // The button cancels a calibration in flight
+    if (tuning_) {
+        tuneCancel_.store(true);
+        tuneBtn_->setEnabled(false);
+        return;
+    }
+    tuneBtn_->setText(tr("取消校准"));
+    statusBar()->showMessage(tr("正在校准渲染参数..."));
+
+    // Calibration times its renders: the preview and queued exports wait
+    // until it is done
+    progressive_->stop();
+    regionRenderer_->stop();
+    exportQueue_->setPaused(true);
+
+    Scene scene = scene_;
+    scene.camera = preview_->currentCamera();
+    RayTracer::Config config = buildRenderConfig();
+    tuning_ = true;
+    tuneCancel_.store(false);
+    tuneThread_ = std::thread([this, scene, config]() {
+        TuningOptions options;
+        options.cancel = &tuneCancel_;
+        TuningResult result = Autotuner::tune(scene, config, options);
+        QMetaObject::invokeMethod(this, [this, result]() {
+            onTuneFinished(result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onTuneFinished(const TuningResult& result)
+{
+    // The thread has posted this call as its last act
+    if (tuneThread_.joinable())
+        tuneThread_.join();
+    tuning_ = false;
+    tuneBtn_->setText(tr("校准渲染参数"));
+    tuneBtn_->setEnabled(true);
+    restartRtPreview();     // releases the exports, unless the preview takes them again
+
+    if (result.cancelled) {
+        statusBar()->showMessage(tr("校准已取消"), 5000);
+        return;
+    }
+
+    // Merge into the active profile; entries of another machine are dropped
+    TuningProfile profile = Autotuner::profile();
+    if (profile.machine != TuningProfile::machineFingerprint()) {
+        profile = TuningProfile();
+        profile.machine = TuningProfile::machineFingerprint();
+    }
+    profile.entries[result.workload] = result.best;
+    Autotuner::setProfile(profile);
+
+    bool saved = !tuningProfilePath_.isEmpty()
+        && QDir().mkpath(QFileInfo(tuningProfilePath_).absolutePath())
+        && profile.save(tuningProfilePath_.toStdString());
+    statusBar()->showMessage(
+        tr("%1：图块 %2 px，%3 线程（%4 Mpx/s）%5")
+            .arg(QString::fromStdString(result.workload))
+            .arg(result.best.tileSize).arg(result.best.threadCount)
+            .arg(result.best.megapixelsPerSecond, 0, 'f', 2)
+            .arg(saved ? QString() : tr("，未能保存")), 10000);
+}
+
+RayTracer::Config MainWindow::buildRenderConfig() const
+{
     RayTracer::Config config;
     config.width = outputWidth_->value();
     config.height = outputHeight_->value();
     config.maxBounces = bounceCountValue_;
     config.samplesPerPixel = sppCount_->value();
-    config.tileSize = 32;
+    // Opt in to the tuning profile and to cost-first scheduling
+    config.tileSize = 0;
     config.threadCount = 0;
+    config.tileSchedule = TileSchedule::CostFirst;
 
     // Visual effects
     config.gradientBg = gradientBgCheck_->isChecked();
@@ -514,30 +783,52 @@ void MainWindow::onRenderExport()
     config.aperture = static_cast<float>(aperture_->value());
     config.softShadows = softShadowCheck_->isChecked();
     config.shadowSamples = shadowSamples_->value();
+    config.autoQuality = autoQualityCheck_->isChecked();
+    return config;
+}
 
-    scene_.camera = preview_->currentCamera();
+void MainWindow::restartRtPreview()
+{
+    if (!progressive_) return;  // still inside setupUi()
+    if (tuning_) return;        // restarted once the calibration is done
+
+    // Any edit ends a region re-render in progress, and with it the hold on
+    // queued exports; the preview below takes the hold again if it runs
+    regionRenderer_->stop();
+    exportQueue_->setPaused(false);
+    if (!rtPreviewCheck_->isChecked()) {
+        progressive_->stop();
+        preview_->clearOverlayImage();
+        return;
+    }
 
-    Scene sceneCopy = scene_;
-    std::string outPathStd = outputPath.toStdString();
+    // Trace at the on-screen size of the export frame, not the export size
+    QSize frame = preview_->frameSize();
+    if (frame.isEmpty()) return;
 
-    if (renderThread_.joinable())
-        renderThread_.join();
+    RayTracer::Config config = buildRenderConfig();
+    config.width = frame.width();
+    config.height = frame.height();
 
-    renderThread_ = std::thread([this, sceneCopy = std::move(sceneCopy),
-                                  config, outPathStd]() {
-        Image image = TileRenderer::render(sceneCopy, config,
-            [this](int done, int total) {
-                QMetaObject::invokeMethod(this,
-                    [this, done, total]() { onRenderProgress(done, total); },
-                    Qt::QueuedConnection);
-            });
+    Scene scene = scene_;
+    scene.camera = preview_->currentCamera();
 
-        bool ok = ImageWriter::writePNG(image, outPathStd);
-        QString path = QString::fromStdString(outPathStd);
-        QMetaObject::invokeMethod(this,
-            [this, path, ok]() { onRenderFinished(path, ok); },
-            Qt::QueuedConnection);
-    });
+    // The interactive preview has priority: queued exports hold between
+    // tiles until it has converged
+    ProgressiveOptions options;
+    options.maxSamples = config.samplesPerPixel;
+    rtPreviewTarget_ = options.maxSamples;
+    exportQueue_->setPaused(true);
+    progressive_->restart(scene, config, options);
+}
+
+void MainWindow::onRtPreviewFrame(const QImage& frame, int samples, quint64 generation)
+{
+    // Frames of a superseded camera/scene may still be in the queue
+    if (generation != progressive_->generation() || !rtPreviewCheck_->isChecked()) return;
+    QString label = samples > 0 ? tr("光追 %1 spp").arg(samples) : tr("光追 (低分辨率)");
+    preview_->setOverlayImage(frame, label);
+    if (samples >= rtPreviewTarget_) exportQueue_->setPaused(false);
 }
 
 void MainWindow::onLightPosChanged()
@@ -550,6 +841,7 @@ void MainWindow::onLightPosChanged()
                                lightColor_.blueF(), 1.0f);
     scene_.light.radius = static_cast<float>(lightRadius_->value());
     preview_->setLightPosition(pos);
+    restartRtPreview();
 }
 
 void MainWindow::onBounceCountChanged(int value)
@@ -557,52 +849,196 @@ void MainWindow::onBounceCountChanged(int value)
     bounceCountValue_ = value;
 }
 
-void MainWindow::onRenderProgress(int done, int total)
+void MainWindow::onRegionSelected(const QRectF& region)
 {
-    progressBar_->setVisible(true);
-    progressBar_->setMaximum(total);
-    progressBar_->setValue(done);
+    if (tuning_) {
+        statusBar()->showMessage(tr("正在校准渲染参数，请稍后再框选区域"), 5000);
+        return;
+    }
+    auto base = exportQueue_->lastResult();
+    if (!base) {
+        statusBar()->showMessage(tr("请先完成一次导出，再框选区域重渲染"), 5000);
+        return;
+    }
+
+    // Normalized frame coordinates → pixels of the last export
+    const RayTracer::Config& full = base->config;
+    int x0 = std::clamp(static_cast<int>(std::floor(region.left() * full.width)), 0, full.width);
+    int y0 = std::clamp(static_cast<int>(std::floor(region.top() * full.height)), 0, full.height);
+    int x1 = std::clamp(static_cast<int>(std::ceil(region.right() * full.width)), 0, full.width);
+    int y1 = std::clamp(static_cast<int>(std::ceil(region.bottom() * full.height)), 0, full.height);
+    if (x1 <= x0 || y1 <= y0) return;
+
+    RayTracer::Config config = full;
+    config.regionX = x0;
+    config.regionY = y0;
+    config.regionWidth = x1 - x0;
+    config.regionHeight = y1 - y0;
+    config.samplesPerPixel = regionSpp_->value();
+
+    // Show the last export with the region refining on top of it. The live
+    // preview would draw over it, so it stays stopped until the next edit;
+    // queued exports yield until the region has converged.
+    progressive_->stop();
+    exportQueue_->setPaused(true);
+    regionRect_ = QRect(x0, y0, x1 - x0, y1 - y0);
+    regionComposite_ = toQImage(base->image);
+    regionTarget_ = config.samplesPerPixel;
+    regionSaveBtn_->setEnabled(false);
+    preview_->setOverlayImage(regionComposite_, tr("区域 0/%1 spp").arg(regionTarget_));
+
+    ProgressiveOptions options;
+    options.lowResDivisor = 1;
+    options.maxSamples = config.samplesPerPixel;
+    regionRenderer_->restart(base->scene, config, options);
 }
 
-void MainWindow::onRenderFinished(const QString& outputPath, bool success)
+void MainWindow::onRegionFrame(const QImage& frame, int samples, quint64 generation)
 {
-    setControlsEnabled(true);
-    progressBar_->setVisible(false);
+    if (generation != regionRenderer_->generation()) return;
+
+    QPainter painter(&regionComposite_);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(regionRect_.topLeft(), frame);   // frames cover the region only
+    painter.end();
+
+    preview_->setOverlayImage(regionComposite_,
+        tr("区域 %1/%2 spp").arg(samples).arg(regionTarget_));
+    if (samples >= regionTarget_) {
+        exportQueue_->setPaused(false);
+        regionSaveBtn_->setEnabled(true);
+    }
+}
+
+void MainWindow::onSaveRegionComposite()
+{
+    if (regionComposite_.isNull()) return;
+    QString outputPath = QFileDialog::getSaveFileName(
+        this, tr("保存合成图像"), QString(),
+        tr("PNG 文件 (*.png);;所有文件 (*)"));
+    if (outputPath.isEmpty()) return;
+    if (!outputPath.endsWith(".png", Qt::CaseInsensitive))
+        outputPath += ".png";
 
-    if (success) {
-        QMessageBox::information(this, tr("渲染完成"),
-            tr("渲染完成！图像已保存至：\n%1").arg(outputPath));
+    if (regionComposite_.save(outputPath, "PNG")) {
+        statusBar()->showMessage(tr("合成图已保存至：%1").arg(outputPath), 10000);
     } else {
         QMessageBox::warning(this, tr("保存失败"),
             tr("无法保存图像至：\n%1\n请检查文件路径是否可写。").arg(outputPath));
     }
 }
 
-void MainWindow::setControlsEnabled(bool enabled)
+QString MainWindow::exportJobText(const ExportJobInfo& info) const
+{
+    QString text = tr("#%1  %2×%3  %4 spp  ").arg(info.id).arg(info.width)
+                       .arg(info.height).arg(info.samplesPerPixel);
+    auto formatTime = [](double seconds) {
+        int s = static_cast<int>(seconds + 0.5);
+        return QString("%1:%2").arg(s / 60).arg(s % 60, 2, 10, QChar('0'));
+    };
+
+    switch (info.status) {
+    case ExportStatus::Queued:
+        return text + (exportQueue_->isPaused() ? tr("等待（预览优先）") : tr("排队中"));
+    case ExportStatus::Running: {
+        int percent = info.tilesTotal > 0 ? info.tilesDone * 100 / info.tilesTotal : 0;
+        text += tr("%1%").arg(percent);
+        if (info.etaSeconds >= 0.0) text += tr("  剩余 %1").arg(formatTime(info.etaSeconds));
+        return text;
+    }
+    case ExportStatus::Done:
+        return text + tr("完成（%1，峰值 %2 MB）").arg(formatTime(info.elapsedSeconds))
+                          .arg(info.peakMemoryBytes / (1024.0 * 1024.0), 0, 'f', 0);
+    case ExportStatus::Failed:
+        return text + (info.error.empty() ? tr("保存失败")
+                                          : tr("失败：%1").arg(QString::fromStdString(info.error)));
+    case ExportStatus::Cancelled:
+        return text + tr("已取消");
+    }
+    return text;
+}
+
+void MainWindow::onExportUpdate(const ExportJobInfo& info)
+{
+    for (int row = 0; row < exportList_->count(); ++row) {
+        QListWidgetItem* item = exportList_->item(row);
+        if (item->data(Qt::UserRole).toInt() == info.id) {
+            item->setText(exportJobText(info));
+            break;
+        }
+    }
+
+    // The progress bar and the statistics follow the running job
+    if (info.status == ExportStatus::Running) {
+        progressBar_->setVisible(true);
+        progressBar_->setMaximum(std::max(1, info.tilesTotal));
+        progressBar_->setValue(info.tilesDone);
+        if (!statsTimer_->isActive()) {
+            statsTimer_->start();
+            updateRenderStats();
+        }
+        return;
+    }
+    progressBar_->setVisible(false);
+    statsTimer_->stop();
+    statsLabel_->setVisible(false);
+
+    QString path = QString::fromStdString(info.outputPath);
+    if (info.status == ExportStatus::Done) {
+        statusBar()->showMessage(tr("渲染完成！图像已保存至：%1").arg(path), 10000);
+    } else if (info.status == ExportStatus::Failed) {
+        QMessageBox::warning(this, tr("保存失败"),
+            tr("无法保存图像至：\n%1\n请检查文件路径是否可写。").arg(path));
+    }
+}
+
+void MainWindow::updateRenderStats()
+{
+    std::optional<RenderStatsSnapshot> stats = exportQueue_->runningStats();
+    if (!stats) {
+        statsLabel_->setVisible(false);
+        return;
+    }
+
+    auto clock = [](double seconds) {
+        int s = static_cast<int>(std::lround(seconds));
+        return QString("%1:%2").arg(s / 60).arg(s % 60, 2, 10, QChar('0'));
+    };
+    QString eta = stats->etaSeconds >= 0.0 ? clock(stats->etaSeconds) : QString("--:--");
+
+    statsLabel_->setText(
+        tr("用时 %1  剩余 %2 | Mrays/s 主光线 %3 阴影 %4 AO %5 反射 %6 | 线程 %7/%8 | 内存 %9 MB")
+            .arg(clock(stats->elapsedSeconds), eta)
+            .arg(stats->mraysPerSecond(RayKind::Primary), 0, 'f', 2)
+            .arg(stats->mraysPerSecond(RayKind::Shadow), 0, 'f', 2)
+            .arg(stats->mraysPerSecond(RayKind::AO), 0, 'f', 2)
+            .arg(stats->mraysPerSecond(RayKind::Reflection), 0, 'f', 2)
+            .arg(stats->activeThreads)
+            .arg(stats->threadCount)
+            .arg(static_cast<qulonglong>(stats->memoryBytes / (1024 * 1024))));
+    statsLabel_->setVisible(true);
+}
+
+void MainWindow::onCancelExport()
 {
-    importBtn_->setEnabled(enabled);
-    usernameEdit_->setEnabled(enabled);
-    fetchBtn_->setEnabled(enabled);
-    poseCombo_->setEnabled(enabled);
-    lightX_->setEnabled(enabled);
-    lightY_->setEnabled(enabled);
-    lightZ_->setEnabled(enabled);
-    lightColorBtn_->setEnabled(enabled);
-    bounceCount_->setEnabled(enabled);
-    sppCount_->setEnabled(enabled);
-    outputWidth_->setEnabled(enabled);
-    outputHeight_->setEnabled(enabled);
-    gradientBgCheck_->setEnabled(enabled);
-    gradientScale_->setEnabled(enabled);
-    bgCenterColorBtn_->setEnabled(enabled);
-    bgEdgeColorBtn_->setEnabled(enabled);
-    aoCheck_->setEnabled(enabled);
-    aoSamples_->setEnabled(enabled);
-    dofCheck_->setEnabled(enabled);
-    aperture_->setEnabled(enabled);
-    softShadowCheck_->setEnabled(enabled);
-    shadowSamples_->setEnabled(enabled);
-    lightRadius_->setEnabled(enabled);
-    renderBtn_->setEnabled(enabled);
-    preview_->setInteractionEnabled(enabled);
+    for (QListWidgetItem* item : exportList_->selectedItems()) {
+        exportQueue_->cancel(item->data(Qt::UserRole).toInt());
+    }
+}
+
+void MainWindow::closeEvent(QCloseEvent* event)
+{
+    int pending = 0;
+    for (const ExportJobInfo& info : exportQueue_->jobs()) {
+        if (info.status == ExportStatus::Queued || info.status == ExportStatus::Running) ++pending;
+    }
+    if (pending > 0) {
+        auto answer = QMessageBox::question(this, tr("退出"),
+            tr("还有 %1 个导出任务未完成，退出将取消它们。确定退出吗？").arg(pending));
+        if (answer != QMessageBox::Yes) {
+            event->ignore();
+            return;
+        }
+    }
+    event->accept();
 }
@@ -11,12 +11,21 @@
 #include <QComboBox>
 #include <QCheckBox>
 #include <QColor>
+#include <QImage>
+#include <QListWidget>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 #include <thread>
 
 #include "gui/raster_preview.h"
 #include "scene/scene.h"
 #include "scene/pose.h"
 #include "skin/skin_parser.h"
+#include "raytracer/autotuner.h"
+#include "raytracer/raytracer.h"
+#include "raytracer/progressive_renderer.h"
+#include "output/export_queue.h"
 
 class SkinFetcher;
 
@@ -27,23 +36,37 @@ public:
     explicit MainWindow(QWidget* parent = nullptr);
     ~MainWindow() override;
 
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
 private slots:
     void onImportSkin();
     void onFetchByUsername();
-    void onSkinFetched(const QString& filePath);
+    void onSkinFetched(const QByteArray& pngData);
     void onSkinFetchError(const QString& message);
     void onRenderExport();
+    void onCaptureJob();
+    void onTuneRenderer();
     void onLightPosChanged();
     void onBounceCountChanged(int value);
     void onPoseChanged(int index);
-    void onRenderProgress(int done, int total);
-    void onRenderFinished(const QString& outputPath, bool success);
+    void onExportUpdate(const ExportJobInfo& info);
+    void onCancelExport();
+    void updateRenderStats();
+    void onRegionSelected(const QRectF& region);
+    void onRegionFrame(const QImage& frame, int samples, quint64 generation);
+    void onSaveRegionComposite();
+    void restartRtPreview();
+    void onRtPreviewFrame(const QImage& frame, int samples, quint64 generation);
 
 private:
     void setupUi();
     void loadSkinFile(const QString& filePath);
+    void loadSkinData(const QByteArray& pngData);
     void rebuildScene();
-    void setControlsEnabled(bool enabled);
+    void loadTuningProfile();
+    QString exportJobText(const ExportJobInfo& info) const;
+    RayTracer::Config buildRenderConfig() const;
 
     RasterPreview* preview_;
     QSlider* lightX_;
@@ -51,6 +74,7 @@ private:
     QSlider* lightZ_;
     QSpinBox* bounceCount_;
     QSpinBox* sppCount_;
+    QCheckBox* rtPreviewCheck_;
     QSpinBox* outputWidth_;
     QSpinBox* outputHeight_;
     QPushButton* importBtn_;
@@ -62,6 +86,7 @@ private:
     QCheckBox* dofCheck_;
     QDoubleSpinBox* aperture_;
     QCheckBox* softShadowCheck_;
+    QCheckBox* autoQualityCheck_;
     QSpinBox* shadowSamples_;
     QDoubleSpinBox* lightRadius_;
     QCheckBox* gradientBgCheck_;
@@ -71,14 +96,39 @@ private:
     QColor bgCenterColor_{232, 228, 220};  // Morandi warm white
     QColor bgEdgeColor_{142, 160, 180};    // Morandi muted blue
     QPushButton* renderBtn_;
+    QPushButton* captureJobBtn_;
+    QPushButton* tuneBtn_;
     QProgressBar* progressBar_;
+    QListWidget* exportList_;
+    QPushButton* cancelExportBtn_;
+    QLabel* statsLabel_;        // live statistics of the running export
+    QTimer* statsTimer_;
+    QSpinBox* regionSpp_;
+    QPushButton* regionSaveBtn_;
     QPushButton* lightColorBtn_;
     QColor lightColor_{255, 255, 255};
     SkinFetcher* skinFetcher_;
     Scene scene_;
     std::optional<SkinData> currentSkin_;
+    std::optional<Rgba8Image> currentSkinPixels_;   // as loaded, for job capture
     std::vector<Pose> poses_;
     bool skinLoaded_ = false;
     int bounceCountValue_ = 4;
-    std::thread renderThread_;
+    std::unique_ptr<ExportQueue> exportQueue_;
+    std::unique_ptr<ProgressiveRenderer> progressive_;
+    int rtPreviewTarget_ = 0;
+
+    // Region re-render over the last finished export
+    std::unique_ptr<ProgressiveRenderer> regionRenderer_;
+    QRect regionRect_;          // in export pixels
+    QImage regionComposite_;    // last export with the refined region drawn in
+    int regionTarget_ = 0;
+
+    // Calibration renders for the tuning profile (tileSize/threadCount) on
+    // tuneThread_; the result comes back as a queued call
+    void onTuneFinished(const TuningResult& result);
+    std::thread tuneThread_;
+    std::atomic<bool> tuneCancel_{false};
+    bool tuning_ = false;
+    QString tuningProfilePath_;
 };
@@ -0,0 +1,256 @@
+#include "gui/preview_atlas.h"
+#include "io/hash.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int nextPow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+static uint8_t toByte(float c) {
+    return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Face index of a triangle (into Mesh::ownedTextures), or -1 if untextured
+static int faceIndexOf(const Mesh& mesh, const Triangle& tri) {
+    for (int i = 0; i < 6; ++i) {
+        if (tri.texture == &mesh.ownedTextures[i]) return i;
+    }
+    return -1;
+}
+
+// Transform slot for mesh i (0 = baked in world space)
+static int slotFor(size_t meshIndex) {
+    return meshIndex + 1 < static_cast<size_t>(PREVIEW_MAX_PARTS)
+        ? static_cast<int>(meshIndex + 1) : 0;
+}
+
+// Geometry stored in the vertex buffer: unposed when the mesh gets its own
+// transform slot, world space otherwise. localTriangles[k] corresponds to
+// triangles[k] (its texture pointers are not fixed up on copy, so faces are
+// always identified through `triangles`).
+static const std::vector<Triangle>& bufferTriangles(const Mesh& mesh, int slot) {
+    if (slot > 0 && mesh.hasRotation && mesh.localTriangles.size() == mesh.triangles.size()) {
+        return mesh.localTriangles;
+    }
+    return mesh.triangles;
+}
+
+// ── Packing ─────────────────────────────────────────────────────────────────
+
+AtlasPacking PreviewAtlas::pack(const std::vector<std::pair<int, int>>& sizes, int padding) {
+    AtlasPacking result;
+    result.rects.resize(sizes.size());
+    if (sizes.empty()) {
+        result.width = result.height = 1;
+        return result;
+    }
+
+    // Tallest first keeps shelves tight
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (sizes[a].second != sizes[b].second) return sizes[a].second > sizes[b].second;
+        return sizes[a].first > sizes[b].first;
+    });
+
+    int maxW = 1;
+    long long area = 0;
+    for (const auto& s : sizes) {
+        int pw = s.first + 2 * padding;
+        int ph = s.second + 2 * padding;
+        maxW = std::max(maxW, pw);
+        area += static_cast<long long>(pw) * ph;
+    }
+    result.width = nextPow2(std::max(maxW, static_cast<int>(std::ceil(std::sqrt(double(area))))));
+
+    int x = 0, y = 0, shelfH = 0;
+    for (size_t idx : order) {
+        int pw = sizes[idx].first + 2 * padding;
+        int ph = sizes[idx].second + 2 * padding;
+        if (x + pw > result.width) {
+            x = 0;
+            y += shelfH;
+            shelfH = 0;
+        }
+        result.rects[idx] = AtlasRect{x + padding, y + padding, sizes[idx].first, sizes[idx].second};
+        x += pw;
+        shelfH = std::max(shelfH, ph);
+    }
+    result.height = nextPow2(y + shelfH);
+    return result;
+}
+
+// ── Scene → atlas + vertex buffer ───────────────────────────────────────────
+
+uint64_t PreviewAtlas::geometryKey(const Scene& scene) {
+    uint64_t h = FNV1A64_OFFSET;
+    size_t meshCount = scene.meshes.size();
+    h = fnv1a64(&meshCount, sizeof(meshCount), h);
+
+    for (size_t m = 0; m < scene.meshes.size(); ++m) {
+        const Mesh& mesh = scene.meshes[m];
+        for (const auto& tex : mesh.ownedTextures) {
+            int dims[2] = {tex.width, tex.height};
+            h = fnv1a64(dims, sizeof(dims), h);
+            h = fnv1a64(tex.pixels.data(), tex.pixels.size() * sizeof(Color), h);
+        }
+
+        const auto& tris = bufferTriangles(mesh, slotFor(m));
+        for (size_t k = 0; k < tris.size(); ++k) {
+            const Triangle& t = tris[k];
+            float v[] = {t.v0.x, t.v0.y, t.v0.z, t.v1.x, t.v1.y, t.v1.z,
+                         t.v2.x, t.v2.y, t.v2.z, t.normal.x, t.normal.y, t.normal.z,
+                         t.u0, t.v0_uv, t.u1, t.v1_uv, t.u2, t.v2_uv};
+            int face = faceIndexOf(mesh, mesh.triangles[k]);
+            h = fnv1a64(v, sizeof(v), h);
+            h = fnv1a64(&face, sizeof(face), h);
+        }
+    }
+    return h;
+}
+
+PreviewGeometry PreviewAtlas::build(const Scene& scene) {
+    constexpr int PADDING = 1;
+
+    // Rect 0 is a white texel for untextured triangles, then 6 faces per mesh
+    std::vector<std::pair<int, int>> sizes;
+    sizes.reserve(1 + scene.meshes.size() * 6);
+    sizes.emplace_back(1, 1);
+    for (const auto& mesh : scene.meshes) {
+        for (const auto& tex : mesh.ownedTextures) {
+            sizes.emplace_back(std::max(tex.width, 1), std::max(tex.height, 1));
+        }
+    }
+    AtlasPacking packing = pack(sizes, PADDING);
+
+    PreviewGeometry geo;
+    geo.atlasWidth = packing.width;
+    geo.atlasHeight = packing.height;
+    geo.atlasPixels.assign(static_cast<size_t>(geo.atlasWidth) * geo.atlasHeight * 4, 0);
+    geo.key = geometryKey(scene);
+
+    // Copy a texture into its rect and replicate edge texels into the
+    // gutter, so nearest sampling at a face edge never reads a neighbour
+    auto blit = [&](const AtlasRect& r, const TextureRegion* tex) {
+        for (int gy = -PADDING; gy < r.h + PADDING; ++gy) {
+            for (int gx = -PADDING; gx < r.w + PADDING; ++gx) {
+                uint8_t* dst = &geo.atlasPixels[((r.y + gy) * geo.atlasWidth + (r.x + gx)) * 4];
+                if (!tex) {
+                    dst[0] = dst[1] = dst[2] = dst[3] = 255;
+                    continue;
+                }
+                if (tex->width <= 0 || tex->height <= 0) continue;
+                int sx = std::clamp(gx, 0, tex->width - 1);
+                int sy = std::clamp(gy, 0, tex->height - 1);
+                const Color& c = tex->pixels[sy * tex->width + sx];
+                dst[0] = toByte(c.r);
+                dst[1] = toByte(c.g);
+                dst[2] = toByte(c.b);
+                dst[3] = toByte(c.a);
+            }
+        }
+    };
+
+    blit(packing.rects[0], nullptr);
+    for (size_t m = 0; m < scene.meshes.size(); ++m) {
+        for (int f = 0; f < 6; ++f) {
+            blit(packing.rects[1 + m * 6 + f], &scene.meshes[m].ownedTextures[f]);
+        }
+    }
+
+    size_t triCount = 0;
+    for (const auto& mesh : scene.meshes) triCount += mesh.triangles.size();
+    geo.vertices.reserve(triCount * 3 * PREVIEW_VERTEX_FLOATS);
+    geo.partSlots.reserve(scene.meshes.size());
+
+    const float invW = 1.0f / static_cast<float>(geo.atlasWidth);
+    const float invH = 1.0f / static_cast<float>(geo.atlasHeight);
+
+    for (size_t m = 0; m < scene.meshes.size(); ++m) {
+        const Mesh& mesh = scene.meshes[m];
+        const int slot = slotFor(m);
+        geo.partSlots.push_back(slot);
+
+        const auto& tris = bufferTriangles(mesh, slot);
+        for (size_t k = 0; k < tris.size(); ++k) {
+            const Triangle& tri = tris[k];
+            int face = faceIndexOf(mesh, mesh.triangles[k]);
+            const AtlasRect& r = packing.rects[face >= 0 ? 1 + m * 6 + face : 0];
+
+            auto addVertex = [&](const Vec3& pos, float u, float v) {
+                const float vtx[PREVIEW_VERTEX_FLOATS] = {
+                    pos.x, pos.y, pos.z,
+                    tri.normal.x, tri.normal.y, tri.normal.z,
+                    (r.x + u * r.w) * invW, (r.y + v * r.h) * invH,
+                    static_cast<float>(slot),
+                };
+                geo.vertices.insert(geo.vertices.end(), vtx, vtx + PREVIEW_VERTEX_FLOATS);
+            };
+            addVertex(tri.v0, tri.u0, tri.v0_uv);
+            addVertex(tri.v1, tri.u1, tri.v1_uv);
+            addVertex(tri.v2, tri.u2, tri.v2_uv);
+        }
+    }
+    geo.vertexCount = static_cast<int>(geo.vertices.size() / PREVIEW_VERTEX_FLOATS);
+    return geo;
+}
+
+// ── Pose transforms ─────────────────────────────────────────────────────────
+
+// Same rotation as MeshBuilder: X (pitch) first, then Z (roll), about the pivot
+static PreviewMatrix poseMatrix(const Vec3& pivot, float rotXDeg, float rotZDeg) {
+    float r[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+
+    auto mul = [&r](const float a[3][3]) {
+        float out[3][3];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                out[i][j] = a[i][0] * r[0][j] + a[i][1] * r[1][j] + a[i][2] * r[2][j];
+        std::copy(&out[0][0], &out[0][0] + 9, &r[0][0]);
+    };
+
+    if (std::fabs(rotXDeg) > 0.01f) {
+        float rad = rotXDeg * static_cast<float>(M_PI) / 180.0f;
+        float c = std::cos(rad), s = std::sin(rad);
+        const float rx[3][3] = {{1, 0, 0}, {0, c, -s}, {0, s, c}};
+        mul(rx);
+    }
+    if (std::fabs(rotZDeg) > 0.01f) {
+        float rad = rotZDeg * static_cast<float>(M_PI) / 180.0f;
+        float c = std::cos(rad), s = std::sin(rad);
+        const float rz[3][3] = {{c, -s, 0}, {s, c, 0}, {0, 0, 1}};
+        mul(rz);
+    }
+
+    const float p[3] = {pivot.x, pivot.y, pivot.z};
+    PreviewMatrix m{};
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) m[col * 4 + row] = r[row][col];
+        // translation = pivot - R * pivot
+        m[12 + row] = p[row] - (r[row][0] * p[0] + r[row][1] * p[1] + r[row][2] * p[2]);
+    }
+    m[15] = 1.0f;
+    return m;
+}
+
+std::vector<PreviewMatrix> PreviewAtlas::partTransforms(const Scene& scene) {
+    const PreviewMatrix identity = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    std::vector<PreviewMatrix> transforms(PREVIEW_MAX_PARTS, identity);
+
+    for (size_t m = 0; m < scene.meshes.size(); ++m) {
+        const Mesh& mesh = scene.meshes[m];
+        int slot = slotFor(m);
+        if (slot > 0 && &bufferTriangles(mesh, slot) == &mesh.localTriangles) {
+            transforms[slot] = poseMatrix(mesh.pivot, mesh.rotX, mesh.rotZ);
+        }
+    }
+    return transforms;
+}
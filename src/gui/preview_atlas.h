@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "scene/scene.h"
+
+// 预览纹理图集 (CPU side of the raster preview)
+//
+// Packs every face texture of every mesh into one RGBA8 atlas and builds one
+// interleaved vertex buffer for the whole scene, so RasterPreview uploads a
+// single texture and a single VBO and draws the character in one call.
+//
+// Vertices are stored in each mesh's unposed (local) space together with a
+// transform slot; per-part pose rotations are supplied separately by
+// partTransforms(). A pose change therefore leaves geometryKey() unchanged
+// and only the transform uniforms need to be re-sent.
+
+// Vertex layout: position (3), normal (3), atlas uv (2), transform slot (1)
+static constexpr int PREVIEW_VERTEX_FLOATS = 9;
+
+// Size of the transform uniform array. Slot 0 is always the identity;
+// meshes beyond the last slot are baked in world space and use slot 0.
+static constexpr int PREVIEW_MAX_PARTS = 32;
+
+// Placement of one rectangle inside the atlas (excluding its padding)
+struct AtlasRect {
+    int x = 0, y = 0, w = 0, h = 0;
+};
+
+struct AtlasPacking {
+    int width = 0;
+    int height = 0;
+    std::vector<AtlasRect> rects;   // same order as the input sizes
+};
+
+struct PreviewGeometry {
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    std::vector<uint8_t> atlasPixels;   // RGBA8, row y at v = y / atlasHeight
+    std::vector<float> vertices;        // PREVIEW_VERTEX_FLOATS per vertex
+    int vertexCount = 0;
+    std::vector<int> partSlots;         // transform slot per scene mesh
+    uint64_t key = 0;                   // geometryKey() of the source scene
+};
+
+// Column-major 4×4 matrix, as glUniformMatrix4fv expects
+using PreviewMatrix = std::array<float, 16>;
+
+class PreviewAtlas {
+public:
+    // Shelf-pack rectangles (width, height) with `padding` texels of gutter
+    // around each one. The atlas is a power of two on both axes.
+    static AtlasPacking pack(const std::vector<std::pair<int, int>>& sizes, int padding = 1);
+
+    // Hash of everything that ends up in the atlas and vertex buffer
+    // (textures and unposed geometry), independent of pose rotations
+    static uint64_t geometryKey(const Scene& scene);
+
+    // Build the atlas and vertex buffer for a scene
+    static PreviewGeometry build(const Scene& scene);
+
+    // PREVIEW_MAX_PARTS transforms matching build(scene).partSlots
+    static std::vector<PreviewMatrix> partTransforms(const Scene& scene);
+};
@@ -12,8 +12,9 @@ static const char* meshVertexShader = R"(
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in float aPart;
 
-uniform mat4 uModel;
+uniform mat4 uPartModel[32];
 uniform mat4 uView;
 uniform mat4 uProjection;
 
@@ -22,14 +23,18 @@ out vec3 vNormal;
 out vec2 vTexCoord;
 
 void main() {
-    vec4 worldPos = uModel * vec4(aPos, 1.0);
+    // Part transforms are rigid rotations, so they also apply to normals
+    mat4 model = uPartModel[int(aPart + 0.5)];
+    vec4 worldPos = model * vec4(aPos, 1.0);
     vWorldPos = worldPos.xyz;
-    vNormal = mat3(transpose(inverse(uModel))) * aNormal;
+    vNormal = mat3(model) * aNormal;
     vTexCoord = aTexCoord;
     gl_Position = uProjection * uView * worldPos;
 }
 )";
 
+static_assert(PREVIEW_MAX_PARTS == 32, "update uPartModel[] in meshVertexShader");
+
 static const char* meshFragmentShader = R"(
 #version 330 core
 in vec3 vWorldPos;
@@ -175,7 +180,9 @@ RasterPreview::RasterPreview(QWidget* parent)
 
 RasterPreview::~RasterPreview() {
     makeCurrent();
-    glMeshes_.clear();
+    atlasTexture_.reset();
+    meshVao_.destroy();
+    meshVbo_.destroy();
     bgVao_.destroy();
     bgVbo_.destroy();
     lightVao_.destroy();
@@ -205,6 +212,7 @@ void RasterPreview::setCameraRotation(float yaw, float pitch) {
     cameraYaw_ = yaw;
     cameraPitch_ = pitch;
     update();
+    emit cameraChanged();
 }
 
 void RasterPreview::setInteractionEnabled(bool enabled) {
@@ -229,6 +237,38 @@ void RasterPreview::setBackgroundGradient(bool enabled, float scale,
     update();
 }
 
+void RasterPreview::setOverlayImage(const QImage& image, const QString& label) {
+    overlayImage_ = image;
+    overlayLabel_ = label;
+    update();
+}
+
+void RasterPreview::clearOverlayImage() {
+    if (overlayImage_.isNull()) return;
+    overlayImage_ = QImage();
+    overlayLabel_.clear();
+    update();
+}
+
+QSize RasterPreview::frameSize() const {
+    return exportFrameRect().size();
+}
+
+// Letterboxed export frame in widget coordinates (top-left origin)
+QRect RasterPreview::exportFrameRect() const {
+    int w = width(), h = height();
+    if (exportW_ > 0 && exportH_ > 0) {
+        float exportAspect = static_cast<float>(exportW_) / static_cast<float>(exportH_);
+        float viewAspect = static_cast<float>(width()) / static_cast<float>(height());
+        if (viewAspect > exportAspect) {
+            w = static_cast<int>(h * exportAspect);
+        } else {
+            h = static_cast<int>(w / exportAspect);
+        }
+    }
+    return QRect((width() - w) / 2, (height() - h) / 2, w, h);
+}
+
 Camera RasterPreview::currentCamera() const {
     Camera cam;
     cam.up = Vec3(0.0f, 1.0f, 0.0f);
@@ -307,20 +347,10 @@ void RasterPreview::paintGL() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Compute letterboxed viewport matching export aspect ratio
-    int vpX = 0, vpY = 0, vpW = width(), vpH = height();
-    if (exportW_ > 0 && exportH_ > 0) {
-        float exportAspect = static_cast<float>(exportW_) / static_cast<float>(exportH_);
-        float viewAspect = static_cast<float>(width()) / static_cast<float>(height());
-        if (viewAspect > exportAspect) {
-            vpH = height();
-            vpW = static_cast<int>(vpH * exportAspect);
-        } else {
-            vpW = width();
-            vpH = static_cast<int>(vpW / exportAspect);
-        }
-        vpX = (width() - vpW) / 2;
-        vpY = (height() - vpH) / 2;
-    }
+    // (GL coords, origin bottom-left)
+    QRect frame = exportFrameRect();
+    int vpX = frame.x(), vpW = frame.width(), vpH = frame.height();
+    int vpY = height() - frame.y() - vpH;
 
     // Clear full widget first (black bars)
     glViewport(0, 0, width(), height());
@@ -364,28 +394,24 @@ void RasterPreview::paintGL() {
     }
 
     QMatrix4x4 proj = projectionMatrix();
-    QMatrix4x4 model; // identity
 
-    // ── Draw meshes ──
-    if (!glMeshes_.empty()) {
+    // ── Draw meshes (single draw call) ──
+    if (meshVertexCount_ > 0 && atlasTexture_) {
         meshShader_->bind();
-        meshShader_->setUniformValue("uModel", model);
+        glUniformMatrix4fv(meshShader_->uniformLocation("uPartModel"),
+                           static_cast<GLsizei>(partTransforms_.size()), GL_FALSE,
+                           partTransforms_.front().data());
         meshShader_->setUniformValue("uView", view);
         meshShader_->setUniformValue("uProjection", proj);
         meshShader_->setUniformValue("uLightPos",
             QVector3D(lightPos_.x, lightPos_.y, lightPos_.z));
         meshShader_->setUniformValue("uViewPos", viewPos);
+        atlasTexture_->bind(0);
+        meshShader_->setUniformValue("uTexture", 0);
 
-        for (auto& gm : glMeshes_) {
-            if (gm->vertexCount == 0) continue;
-            gm->vao.bind();
-            if (gm->texture) {
-                gm->texture->bind(0);
-                meshShader_->setUniformValue("uTexture", 0);
-            }
-            glDrawArrays(GL_TRIANGLES, 0, gm->vertexCount);
-            gm->vao.release();
-        }
+        meshVao_.bind();
+        glDrawArrays(GL_TRIANGLES, 0, meshVertexCount_);
+        meshVao_.release();
         meshShader_->release();
     }
 
@@ -412,24 +438,29 @@ void RasterPreview::paintGL() {
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
+    // ── Ray-traced overlay ──
+    if (!overlayImage_.isNull()) {
+        painter.drawImage(frame, overlayImage_);
+        if (!overlayLabel_.isEmpty()) {
+            painter.setPen(QColor(255, 255, 255, 180));
+            painter.setFont(QFont("Sans", 9));
+            painter.drawText(frame.adjusted(0, 6, -6, 0), Qt::AlignTop | Qt::AlignRight,
+                             overlayLabel_);
+        }
+    }
+
     // ── Draw export resolution frame border ──
     if (exportW_ > 0 && exportH_ > 0) {
-        // vpX/vpY/vpW/vpH are in GL coords (origin bottom-left),
-        // QPainter uses top-left origin, so flip Y
-        int frameX = vpX;
-        int frameY = height() - vpY - vpH;
-        QRect frameRect(frameX, frameY, vpW, vpH);
-
         // Draw frame border
         QPen framePen(QColor(255, 255, 255, 120), 1.0, Qt::DashLine);
         painter.setPen(framePen);
-        painter.drawRect(frameRect);
+        painter.drawRect(frame);
 
         // Resolution label
         painter.setPen(QColor(255, 255, 255, 180));
         painter.setFont(QFont("Sans", 9));
         QString resText = QString("%1×%2").arg(exportW_).arg(exportH_);
-        painter.drawText(frameX + 6, frameY + 16, resText);
+        painter.drawText(frame.x() + 6, frame.y() + 16, resText);
     }
 
     // ── Mode indicator ──
@@ -458,6 +489,16 @@ void RasterPreview::mousePressEvent(QMouseEvent* event) {
         }
         return;
     }
+    if (event->button() == Qt::LeftButton && (event->modifiers() & Qt::ShiftModifier)
+        && cameraMode_ == CameraMode::Orbit) {
+        if (!exportFrameRect().contains(event->pos())) return;
+        if (!rubberBand_) rubberBand_ = new QRubberBand(QRubberBand::Rectangle, this);
+        regionOrigin_ = event->pos();
+        selectingRegion_ = true;
+        rubberBand_->setGeometry(QRect(regionOrigin_, QSize()));
+        rubberBand_->show();
+        return;
+    }
     lastMousePos_ = event->pos();
 }
 
@@ -471,10 +512,17 @@ void RasterPreview::mouseMoveEvent(QMouseEvent* event) {
         if (dx != 0 || dy != 0) {
             cameraController_.handleMouseMove(static_cast<float>(dx), static_cast<float>(dy));
             QCursor::setPos(mapToGlobal(center));
+            emit cameraChanged();
         }
         return;
     }
 
+    if (selectingRegion_) {
+        QRect band = QRect(regionOrigin_, event->pos()).normalized();
+        rubberBand_->setGeometry(band.intersected(exportFrameRect()));
+        return;
+    }
+
     int dx = event->pos().x() - lastMousePos_.x();
     int dy = event->pos().y() - lastMousePos_.y();
     lastMousePos_ = event->pos();
@@ -484,15 +532,32 @@ void RasterPreview::mouseMoveEvent(QMouseEvent* event) {
         cameraPitch_ += dy * 0.3f;
         cameraPitch_ = std::clamp(cameraPitch_, -89.0f, 89.0f);
         update();
+        emit cameraChanged();
     }
 }
 
+void RasterPreview::mouseReleaseEvent(QMouseEvent* event) {
+    if (!selectingRegion_ || event->button() != Qt::LeftButton) return;
+    selectingRegion_ = false;
+    rubberBand_->hide();
+
+    QRect frame = exportFrameRect();
+    QRect band = rubberBand_->geometry();
+    if (band.width() < 4 || band.height() < 4 || frame.isEmpty()) return;
+    emit regionSelected(QRectF(
+        static_cast<double>(band.x() - frame.x()) / frame.width(),
+        static_cast<double>(band.y() - frame.y()) / frame.height(),
+        static_cast<double>(band.width()) / frame.width(),
+        static_cast<double>(band.height()) / frame.height()));
+}
+
 void RasterPreview::wheelEvent(QWheelEvent* event) {
     if (!interactionEnabled_) return;
     float delta = event->angleDelta().y() / 120.0f;
     cameraDistance_ -= delta * 3.0f;
     cameraDistance_ = std::clamp(cameraDistance_, 10.0f, 200.0f);
     update();
+    emit cameraChanged();
 }
 
 // ─── Keyboard / focus handling ──────────────────────────────────────────────
@@ -545,8 +610,13 @@ void RasterPreview::focusOutEvent(QFocusEvent* event) {
 // ─── Frame tick / free view matrix stubs (implemented in tasks 3.4, 3.5) ────
 
 void RasterPreview::onFrameTick() {
+    Vec3 before = cameraController_.position();
     cameraController_.update();
     update();
+    Vec3 after = cameraController_.position();
+    if (before.x != after.x || before.y != after.y || before.z != after.z) {
+        emit cameraChanged();
+    }
 }
 
 QMatrix4x4 RasterPreview::freeViewMatrix() const {
@@ -599,6 +669,7 @@ void RasterPreview::enterFreeMode() {
     }
 
     update();
+    emit cameraChanged();
 }
 
 void RasterPreview::exitFreeMode() {
@@ -634,6 +705,7 @@ void RasterPreview::exitFreeMode() {
     }
 
     update();
+    emit cameraChanged();
 }
 
 // ─── Camera matrices ────────────────────────────────────────────────────────
@@ -668,125 +740,39 @@ QMatrix4x4 RasterPreview::projectionMatrix() const {
 // ─── Upload mesh data to GPU ────────────────────────────────────────────────
 
 void RasterPreview::uploadMeshes() {
-    glMeshes_.clear();
-    if (!scene_) return;
-
-    // For each Mesh, we build a texture atlas from its 6 owned face textures
-    // (front=0, back=1, left=2, right=3, top=4, bottom=5) laid out in a
-    // 3-column x 2-row grid. Each cell has uniform size (maxW x maxH).
-    // Triangle UVs are remapped from [0,1] per-face into atlas sub-regions.
-
-    for (const auto& mesh : scene_->meshes) {
-        auto gm = std::make_unique<GLMeshData>();
-
-        // Find max face texture dimensions for uniform atlas cells
-        int maxW = 1, maxH = 1;
-        for (int i = 0; i < 6; ++i) {
-            maxW = std::max(maxW, mesh.ownedTextures[i].width);
-            maxH = std::max(maxH, mesh.ownedTextures[i].height);
-        }
-
-        int atlasW = maxW * 3;  // 3 columns
-        int atlasH = maxH * 2;  // 2 rows
-
-        // Build atlas pixel data (RGBA8)
-        std::vector<unsigned char> atlasPixels(atlasW * atlasH * 4, 0);
-
-        for (int faceIdx = 0; faceIdx < 6; ++faceIdx) {
-            const auto& tex = mesh.ownedTextures[faceIdx];
-            int col = faceIdx % 3;
-            int row = faceIdx / 3;
-            int offX = col * maxW;
-            int offY = row * maxH;
-
-            for (int y = 0; y < tex.height && y < maxH; ++y) {
-                for (int x = 0; x < tex.width && x < maxW; ++x) {
-                    const Color& c = tex.pixels[y * tex.width + x];
-                    int dstIdx = ((offY + y) * atlasW + (offX + x)) * 4;
-                    atlasPixels[dstIdx + 0] = static_cast<unsigned char>(std::clamp(c.r, 0.0f, 1.0f) * 255.0f + 0.5f);
-                    atlasPixels[dstIdx + 1] = static_cast<unsigned char>(std::clamp(c.g, 0.0f, 1.0f) * 255.0f + 0.5f);
-                    atlasPixels[dstIdx + 2] = static_cast<unsigned char>(std::clamp(c.b, 0.0f, 1.0f) * 255.0f + 0.5f);
-                    atlasPixels[dstIdx + 3] = static_cast<unsigned char>(std::clamp(c.a, 0.0f, 1.0f) * 255.0f + 0.5f);
-                }
-            }
-        }
-
-        // Create OpenGL texture
-        gm->texture = std::make_unique<QOpenGLTexture>(QOpenGLTexture::Target2D);
-        gm->texture->create();
-        gm->texture->setSize(atlasW, atlasH);
-        gm->texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
-        gm->texture->allocateStorage();
-        gm->texture->setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, atlasPixels.data());
-        gm->texture->setMinificationFilter(QOpenGLTexture::Nearest);
-        gm->texture->setMagnificationFilter(QOpenGLTexture::Nearest);
-        gm->texture->setWrapMode(QOpenGLTexture::ClampToEdge);
-
-        // Build vertex data with remapped UVs into atlas space
-        std::vector<float> vertexData;
-        vertexData.reserve(mesh.triangles.size() * 3 * 8);
-
-        for (const auto& tri : mesh.triangles) {
-            // Determine which face index this triangle belongs to
-            int faceIdx = -1;
-            if (tri.texture) {
-                for (int i = 0; i < 6; ++i) {
-                    if (tri.texture == &mesh.ownedTextures[i]) {
-                        faceIdx = i;
-                        break;
-                    }
-                }
-            }
-
-            // Compute atlas UV offset and scale for this face
-            float uOff = 0.0f, vOff = 0.0f;
-            float uScale = 1.0f / 3.0f;
-            float vScale = 1.0f / 2.0f;
-            if (faceIdx >= 0) {
-                int col = faceIdx % 3;
-                int row = faceIdx / 3;
-                uOff = float(col) / 3.0f;
-                vOff = float(row) / 2.0f;
-
-                // Account for actual texture size within the cell
-                const auto& faceTex = mesh.ownedTextures[faceIdx];
-                if (faceTex.width > 0 && faceTex.height > 0) {
-                    uScale = float(faceTex.width) / float(atlasW);
-                    vScale = float(faceTex.height) / float(atlasH);
-                }
-            }
-
-            auto remapU = [&](float u) { return uOff + u * uScale; };
-            auto remapV = [&](float v) { return vOff + v * vScale; };
-
-            auto addVertex = [&](const Vec3& pos, const Vec3& n, float u, float v) {
-                vertexData.push_back(pos.x);
-                vertexData.push_back(pos.y);
-                vertexData.push_back(pos.z);
-                vertexData.push_back(n.x);
-                vertexData.push_back(n.y);
-                vertexData.push_back(n.z);
-                vertexData.push_back(remapU(u));
-                vertexData.push_back(remapV(v));
-            };
-
-            addVertex(tri.v0, tri.normal, tri.u0, tri.v0_uv);
-            addVertex(tri.v1, tri.normal, tri.u1, tri.v1_uv);
-            addVertex(tri.v2, tri.normal, tri.u2, tri.v2_uv);
-        }
-
-        gm->vertexCount = static_cast<int>(mesh.triangles.size() * 3);
-
-        // Create VAO/VBO
-        gm->vao.create();
-        gm->vao.bind();
+    if (!scene_) {
+        meshVertexCount_ = 0;
+        return;
+    }
 
-        gm->vbo.create();
-        gm->vbo.bind();
-        gm->vbo.allocate(vertexData.data(),
-                         static_cast<int>(vertexData.size() * sizeof(float)));
+    // A pose change only rotates parts: keep the atlas and vertex buffer
+    // and just refresh the per-part transforms
+    partTransforms_ = PreviewAtlas::partTransforms(*scene_);
+    if (atlasTexture_ && PreviewAtlas::geometryKey(*scene_) == meshGeometryKey_) {
+        return;
+    }
 
-        int stride = 8 * sizeof(float);
+    // Skin (or geometry) changed: one atlas texture + one VBO for all meshes
+    PreviewGeometry geo = PreviewAtlas::build(*scene_);
+
+    atlasTexture_ = std::make_unique<QOpenGLTexture>(QOpenGLTexture::Target2D);
+    atlasTexture_->create();
+    atlasTexture_->setSize(geo.atlasWidth, geo.atlasHeight);
+    atlasTexture_->setFormat(QOpenGLTexture::RGBA8_UNorm);
+    atlasTexture_->allocateStorage();
+    atlasTexture_->setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, geo.atlasPixels.data());
+    atlasTexture_->setMinificationFilter(QOpenGLTexture::Nearest);
+    atlasTexture_->setMagnificationFilter(QOpenGLTexture::Nearest);
+    atlasTexture_->setWrapMode(QOpenGLTexture::ClampToEdge);
+
+    if (!meshVao_.isCreated()) {
+        meshVao_.create();
+        meshVao_.bind();
+        meshVbo_.create();
+        meshVbo_.setUsagePattern(QOpenGLBuffer::StaticDraw);
+        meshVbo_.bind();
+
+        int stride = PREVIEW_VERTEX_FLOATS * sizeof(float);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr);
         glEnableVertexAttribArray(1);
@@ -795,12 +781,19 @@ void RasterPreview::uploadMeshes() {
         glEnableVertexAttribArray(2);
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
                               reinterpret_cast<void*>(6 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<void*>(8 * sizeof(float)));
+        meshVao_.release();
+    }
 
-        gm->vbo.release();
-        gm->vao.release();
+    meshVbo_.bind();
+    meshVbo_.allocate(geo.vertices.data(),
+                      static_cast<int>(geo.vertices.size() * sizeof(float)));
+    meshVbo_.release();
 
-        glMeshes_.push_back(std::move(gm));
-    }
+    meshVertexCount_ = geo.vertexCount;
+    meshGeometryKey_ = geo.key;
 }
 
 // ─── Light indicator ────────────────────────────────────────────────────────
@@ -11,29 +11,16 @@
 #include <QFocusEvent>
 #include <QMatrix4x4>
 #include <QTimer>
+#include <QImage>
+#include <QRubberBand>
 #include <vector>
 #include <memory>
 #include <set>
 
 #include "gui/camera_controller.h"
+#include "gui/preview_atlas.h"
 #include "scene/scene.h"
 
-// GPU-side mesh data for a single Mesh.
-// Non-copyable/non-movable because QOpenGLVertexArrayObject is a QObject.
-// Stored via unique_ptr in the vector.
-struct GLMeshData {
-    QOpenGLVertexArrayObject vao;
-    QOpenGLBuffer vbo{QOpenGLBuffer::VertexBuffer};
-    int vertexCount = 0;
-    std::unique_ptr<QOpenGLTexture> texture;
-
-    GLMeshData() = default;
-    GLMeshData(const GLMeshData&) = delete;
-    GLMeshData& operator=(const GLMeshData&) = delete;
-    GLMeshData(GLMeshData&&) = delete;
-    GLMeshData& operator=(GLMeshData&&) = delete;
-};
-
 class RasterPreview : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
     Q_OBJECT
 
@@ -50,12 +37,29 @@ public:
                                const QColor& center, const QColor& edge);
     Camera currentCamera() const;
 
+    // Ray-traced preview drawn over the export frame (replaces the raster
+    // image while set). `label` is shown in the frame's top-right corner.
+    void setOverlayImage(const QImage& image, const QString& label = QString());
+    void clearOverlayImage();
+
+    // Size in pixels of the letterboxed export frame inside the widget
+    QSize frameSize() const;
+
+signals:
+    // Orbit or free camera moved (drag, wheel, WASD, mode switch)
+    void cameraChanged();
+
+    // Shift+drag selection inside the export frame, normalized to [0, 1]
+    // with the origin at the frame's top-left corner
+    void regionSelected(const QRectF& region);
+
 protected:
     void initializeGL() override;
     void paintGL() override;
     void resizeGL(int w, int h) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
     void keyReleaseEvent(QKeyEvent* event) override;
@@ -71,6 +75,7 @@ private:
     void enterFreeMode();
     void exitFreeMode();
     QMatrix4x4 freeViewMatrix() const;
+    QRect exportFrameRect() const;
 
     // Scene data
     const Scene* scene_ = nullptr;
@@ -89,8 +94,14 @@ private:
     std::unique_ptr<QOpenGLShaderProgram> lightShader_;
     std::unique_ptr<QOpenGLShaderProgram> bgShader_;
 
-    // GPU mesh data
-    std::vector<std::unique_ptr<GLMeshData>> glMeshes_;
+    // GPU mesh data: one shared atlas texture and one vertex buffer for all
+    // meshes, drawn in a single call. Pose changes only update partTransforms_.
+    QOpenGLVertexArrayObject meshVao_;
+    QOpenGLBuffer meshVbo_{QOpenGLBuffer::VertexBuffer};
+    std::unique_ptr<QOpenGLTexture> atlasTexture_;
+    int meshVertexCount_ = 0;
+    uint64_t meshGeometryKey_ = 0;
+    std::vector<PreviewMatrix> partTransforms_;
 
     // Background quad
     QOpenGLVertexArrayObject bgVao_;
@@ -112,6 +123,15 @@ private:
     int exportW_ = 1920;
     int exportH_ = 1080;
 
+    // Ray-traced overlay
+    QImage overlayImage_;
+    QString overlayLabel_;
+
+    // Region selection (Shift + left drag)
+    QRubberBand* rubberBand_ = nullptr;
+    QPoint regionOrigin_;
+    bool selectingRegion_ = false;
+
     // Free camera mode
     CameraMode cameraMode_ = CameraMode::Orbit;
     CameraController cameraController_;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Read-only memory mapping of an entire file.
+// Move-only; the mapping is released when the object is destroyed.
+// The mapped bytes are shared with the page cache, so opening a large
+// file costs one syscall and no copy.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map a file read-only. Returns std::nullopt if the file cannot be
+    // opened, is empty, or the mapping fails.
+    static std::optional<MappedFile> open(const std::string& path);
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+    // Hint the OS that the mapping will be read front to back
+    // (enables aggressive read-ahead). No-op where unsupported.
+    void adviseSequential() const;
+
+private:
+    void release();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
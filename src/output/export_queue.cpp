@@ -0,0 +1,295 @@
+#include "output/export_queue.h"
+#include "output/image_writer.h"
+#include "diagnostics/profiler.h"
+#include "raytracer/render_pool.h"
+#include <algorithm>
+
+ExportQueue::ExportQueue(UpdateCallback onUpdate)
+    : onUpdate_(std::move(onUpdate))
+{
+    thread_ = std::thread([this]() { run(); });
+}
+
+ExportQueue::~ExportQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+        for (int id : queue_) jobs_.at(id).info.status = ExportStatus::Cancelled;
+        queue_.clear();
+        if (active_) active_->cancel.store(true);
+    }
+    wakeCv_.notify_all();
+    thread_.join();
+}
+
+// ── Public API ──────────────────────────────────────────────────────────────
+
+int ExportQueue::enqueue(const Scene& scene, const RayTracer::Config& config,
+                         const std::string& outputPath) {
+    ExportJobInfo info;
+    bool rejected = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Job job;
+        job.info.id = nextId_++;
+        job.info.outputPath = outputPath;
+        job.info.width = config.width;
+        job.info.height = config.height;
+        job.info.samplesPerPixel = config.samplesPerPixel;
+        job.config = config;
+        job.estimate = MemoryEstimate::job(scene, config);
+        job.info.memoryEstimate = job.estimate.total();
+        job.memory = std::make_unique<MemoryAccount>(&memory_);
+
+        // A job that cannot fit even in an empty queue never runs
+        rejected = memoryBudget_ > 0 && job.info.memoryEstimate > memoryBudget_;
+        if (rejected) {
+            job.info.status = ExportStatus::Failed;
+            job.info.error = "memory estimate exceeds the budget";
+        } else {
+            job.scene = scene;
+            const MemoryUsage held = MemoryFootprint::scene(job.scene);
+            job.sceneCharge = MemoryCharge(job.memory.get(), MemoryCategory::Scene,
+                                           held[MemoryCategory::Scene]);
+            job.textureCharge = MemoryCharge(job.memory.get(), MemoryCategory::Textures,
+                                             held[MemoryCategory::Textures]);
+            job.info.memoryBytes = job.memory->currentTotal();
+            job.info.peakMemoryBytes = job.memory->peakTotal();
+            queue_.push_back(job.info.id);
+        }
+        info = job.info;
+        jobs_.emplace(info.id, std::move(job));
+    }
+    if (rejected) {
+        notify(info);
+    } else {
+        wakeCv_.notify_all();
+    }
+    return info.id;
+}
+
+bool ExportQueue::cancel(int id) {
+    ExportJobInfo info;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end()) return false;
+        Job& job = it->second;
+
+        if (job.info.status == ExportStatus::Running) {
+            // The render thread reports the cancellation once the tiles in
+            // flight have finished
+            if (active_) active_->cancel.store(true);
+            return true;
+        }
+        if (job.info.status != ExportStatus::Queued) return false;
+
+        queue_.erase(std::find(queue_.begin(), queue_.end(), id));
+        job.info.status = ExportStatus::Cancelled;
+        job.scene = Scene();
+        job.sceneCharge.reset();
+        job.textureCharge.reset();
+        job.info.memoryBytes = 0;
+        info = job.info;
+    }
+    idleCv_.notify_all();
+    notify(info);
+    return true;
+}
+
+void ExportQueue::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (paused == paused_) return;
+        paused_ = paused;
+        if (paused) {
+            pausedAt_ = Clock::now();
+        } else {
+            pausedSeconds_ += std::chrono::duration<double>(Clock::now() - pausedAt_).count();
+        }
+        if (active_) active_->paused.store(paused);
+    }
+    wakeCv_.notify_all();
+}
+
+bool ExportQueue::isPaused() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paused_;
+}
+
+std::vector<ExportJobInfo> ExportQueue::jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ExportJobInfo> result;
+    result.reserve(jobs_.size());
+    for (const auto& entry : jobs_) result.push_back(entry.second.info);
+    return result;
+}
+
+std::optional<ExportJobInfo> ExportQueue::job(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    return it->second.info;
+}
+
+std::optional<RenderStatsSnapshot> ExportQueue::runningStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!monitor_) return std::nullopt;
+    return monitor_->snapshot();
+}
+
+void ExportQueue::setMemoryBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memoryBudget_ = bytes;
+}
+
+uint64_t ExportQueue::memoryBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryBudget_;
+}
+
+std::shared_ptr<const ExportResult> ExportQueue::lastResult() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastResult_;
+}
+
+bool ExportQueue::waitIdle(int timeoutMs) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idleCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this]() { return queue_.empty() && runningId_ == 0; });
+}
+
+// ── Render thread ───────────────────────────────────────────────────────────
+
+double ExportQueue::activeSecondsLocked() const {
+    Clock::time_point now = Clock::now();
+    double total = std::chrono::duration<double>(now - startedAt_).count() - pausedSeconds_;
+    if (paused_) total -= std::chrono::duration<double>(now - pausedAt_).count();
+    return std::max(0.0, total);
+}
+
+void ExportQueue::notify(const ExportJobInfo& info) const {
+    if (onUpdate_) onUpdate_(info);
+}
+
+void ExportQueue::run() {
+    // Render threads, their storage and the encoder buffers outlive the
+    // jobs and are charged to the queue; the framebuffer does not, it
+    // moves into the cached result
+    RenderPool pool;
+    pool.setMemoryAccount(&memory_);
+    EncodeBuffer encoder;
+    MemoryCharge encoderCharge(&memory_, MemoryCategory::Encoder, 0);
+    while (true) {
+        RenderControl control;
+        RenderMonitor monitor;
+        control.monitor = &monitor;
+        Job* job = nullptr;
+        ExportJobInfo info;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCv_.wait(lock, [this]() { return quit_ || (!queue_.empty() && !paused_); });
+            if (quit_) return;
+
+            runningId_ = queue_.front();
+            queue_.pop_front();
+            job = &jobs_.at(runningId_);
+
+            // Admission: the snapshot is already charged, the framebuffer
+            // is not, the encoder buffers only as large as an earlier job
+            // left them. Make room by dropping the cached result before
+            // giving up.
+            uint64_t pending = job->estimate[MemoryCategory::Framebuffer]
+                             + job->estimate[MemoryCategory::Encoder]
+                             - std::min(job->estimate[MemoryCategory::Encoder], encoderCharge.bytes());
+            if (memoryBudget_ > 0 && memory_.currentTotal() + pending > memoryBudget_) {
+                lastResult_.reset();
+                lastResultCharge_.reset();
+            }
+            if (memoryBudget_ > 0 && memory_.currentTotal() + pending > memoryBudget_) {
+                job->info.status = ExportStatus::Failed;
+                job->info.error = "not enough memory budget left";
+                job->scene = Scene();
+                job->sceneCharge.reset();
+                job->textureCharge.reset();
+                job->info.memoryBytes = 0;
+                info = job->info;
+                runningId_ = 0;
+                lock.unlock();
+                notify(info);
+                idleCv_.notify_all();
+                continue;
+            }
+            job->info.status = ExportStatus::Running;
+            active_ = &control;
+            monitor_ = &monitor;
+            startedAt_ = Clock::now();
+            pausedSeconds_ = 0.0;
+            info = job->info;
+        }
+        notify(info);
+        if (Profiler::enabled()) Profiler::setThreadName("export queue");
+        ProfileZone jobZone("export job", "stage", info.id);
+
+        // Allocated here at the config's size, so renderInto() keeps it
+        Image image(std::max(0, job->config.width), std::max(0, job->config.height));
+        MemoryCharge framebufferCharge(job->memory.get(), MemoryCategory::Framebuffer,
+                                       MemoryFootprint::image(image));
+
+        auto progress = [this, job, &monitor](int done, int total) {
+            ExportJobInfo update;
+            {
+                ProfileZone waitZone("wait queue lock", "lock");
+                std::lock_guard<std::mutex> lock(mutex_);
+                waitZone.end();
+                ExportJobInfo& i = job->info;
+                i.tilesDone = done;
+                i.tilesTotal = total;
+                i.elapsedSeconds = activeSecondsLocked();
+                i.etaSeconds = monitor.snapshot().etaSeconds;   // from per-tile timing
+                i.memoryBytes = job->memory->currentTotal();
+                i.peakMemoryBytes = job->memory->peakTotal();
+                update = i;
+            }
+            notify(update);
+        };
+
+        TileRenderer::renderInto(job->scene, job->config, image, pool, progress, &control);
+        bool cancelled = control.cancel.load();
+        bool ok = !cancelled && ImageWriter::writePNG(image, job->info.outputPath, encoder);
+        encoderCharge.update(encoder.capacityBytes());
+        jobZone.end();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ExportJobInfo& i = job->info;
+            i.status = cancelled ? ExportStatus::Cancelled
+                     : ok ? ExportStatus::Done : ExportStatus::Failed;
+            i.elapsedSeconds = activeSecondsLocked();
+            i.etaSeconds = cancelled ? -1.0 : 0.0;
+            if (i.status == ExportStatus::Failed) i.error = "cannot write " + i.outputPath;
+
+            // The job's buffers are released; a successful result moves on
+            // into the cache, charged to the queue
+            framebufferCharge.reset();
+            job->sceneCharge.reset();
+            job->textureCharge.reset();
+            i.memoryBytes = 0;
+            i.peakMemoryBytes = job->memory->peakTotal();
+            if (i.status == ExportStatus::Done) {
+                lastResult_ = std::make_shared<const ExportResult>(
+                    ExportResult{i, std::move(job->scene), job->config, std::move(image)});
+                const uint64_t cached = MemoryFootprint::scene(lastResult_->scene).total()
+                                      + MemoryFootprint::image(lastResult_->image);
+                lastResultCharge_ = MemoryCharge(&memory_, MemoryCategory::Caches, cached);
+            }
+            job->scene = Scene();   // drop the snapshot, keep the record
+            runningId_ = 0;
+            active_ = nullptr;
+            monitor_ = nullptr;
+            info = i;
+        }
+        notify(info);
+        idleCv_.notify_all();
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include "scene/scene.h"
+#include "raytracer/raytracer.h"
+#include "raytracer/tile_renderer.h"
+#include "raytracer/memory_account.h"
+
+// 导出队列
+//
+// Renders queued export jobs one after another on a background thread and
+// writes each result as PNG. Every job owns a snapshot of the scene and the
+// config, so the caller can keep editing or queue more jobs while earlier
+// ones render. enqueue(), cancel() and setPaused() never wait for the
+// renderer; the destructor cancels whatever is left.
+//
+// Every job has a MemoryAccount (scene snapshot, framebuffer) whose
+// charges roll up into the queue's account, which also carries the render
+// pool's storage, the PNG encoder buffers and the cached last result. With
+// a memory budget set, a job whose pre-flight estimate does not fit is
+// failed instead of started.
+
+enum class ExportStatus { Queued, Running, Done, Failed, Cancelled };
+
+struct ExportJobInfo {
+    int id = 0;
+    std::string outputPath;
+    int width = 0;
+    int height = 0;
+    int samplesPerPixel = 0;
+    ExportStatus status = ExportStatus::Queued;
+    int tilesDone = 0;
+    int tilesTotal = 0;
+    double elapsedSeconds = 0.0;   // render time, excluding time spent paused
+    double etaSeconds = -1.0;      // -1 = unknown
+    uint64_t memoryEstimate = 0;   // MemoryEstimate::job() at enqueue
+    uint64_t memoryBytes = 0;      // accounted bytes held right now
+    uint64_t peakMemoryBytes = 0;  // highest accounted total so far
+    std::string error;             // why the job failed, if known
+};
+
+// A finished export together with the snapshot it was rendered from, so a
+// region of it can be re-rendered and composited (TileRenderer::compositeRegion)
+struct ExportResult {
+    ExportJobInfo info;
+    Scene scene;
+    RayTracer::Config config;
+    Image image;
+};
+
+class ExportQueue {
+public:
+    // Called whenever a job changes state or finishes a tile. Runs on a render
+    // thread, except for cancel() of a queued job, which reports on the
+    // caller's thread.
+    using UpdateCallback = std::function<void(const ExportJobInfo&)>;
+
+    explicit ExportQueue(UpdateCallback onUpdate = nullptr);
+    ~ExportQueue();
+
+    ExportQueue(const ExportQueue&) = delete;
+    ExportQueue& operator=(const ExportQueue&) = delete;
+
+    // Queue a job; returns its id (> 0)
+    int enqueue(const Scene& scene, const RayTracer::Config& config,
+                const std::string& outputPath);
+
+    // Cancel a queued or running job. Returns false if the id is unknown or
+    // the job has already finished.
+    bool cancel(int id);
+
+    // Hold the running job between tiles (and don't start new ones) so that
+    // an interactive render gets the CPU. Paused time is not counted in ETA.
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    // Snapshot of all jobs, oldest first
+    std::vector<ExportJobInfo> jobs() const;
+    std::optional<ExportJobInfo> job(int id) const;
+
+    // Live statistics of the running job (nullopt when idle)
+    std::optional<RenderStatsSnapshot> runningStats() const;
+
+    // Limit on the queue's accounted memory in bytes (0 = unlimited).
+    // Checked against MemoryEstimate::job() on enqueue and again before a
+    // job starts; the cached last result is dropped first if that helps.
+    void setMemoryBudget(uint64_t bytes);
+    uint64_t memoryBudget() const;
+
+    // Accounted memory of all jobs, the renderer and encoder storage and
+    // the cached last result
+    const MemoryAccount& memory() const { return memory_; }
+
+    // The most recent job that finished successfully, or null
+    std::shared_ptr<const ExportResult> lastResult() const;
+
+    // Block until no job is queued or running, or until timeoutMs elapses
+    bool waitIdle(int timeoutMs) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        ExportJobInfo info;
+        Scene scene;
+        RayTracer::Config config;
+        MemoryUsage estimate;
+        std::unique_ptr<MemoryAccount> memory;  // stable address for the charges
+        MemoryCharge sceneCharge;
+        MemoryCharge textureCharge;
+    };
+
+    void run();
+    double activeSecondsLocked() const;
+    void notify(const ExportJobInfo& info) const;
+
+    UpdateCallback onUpdate_;
+    MemoryAccount memory_;              // declared before everything that charges it
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    mutable std::condition_variable idleCv_;
+    std::map<int, Job> jobs_;           // by id; node-based, so references stay valid
+    std::deque<int> queue_;             // ids waiting to run
+    int nextId_ = 1;
+    int runningId_ = 0;
+    RenderControl* active_ = nullptr;   // control of the running job
+    RenderMonitor* monitor_ = nullptr;  // its statistics
+    bool paused_ = false;
+    bool quit_ = false;
+    std::shared_ptr<const ExportResult> lastResult_;
+    MemoryCharge lastResultCharge_;
+    uint64_t memoryBudget_ = 0;
+
+    // Timing of the running job
+    Clock::time_point startedAt_;
+    Clock::time_point pausedAt_;
+    double pausedSeconds_ = 0.0;
+
+    std::thread thread_;
+};
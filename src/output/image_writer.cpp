@@ -1,9 +1,23 @@
 #include "output/image_writer.h"
+#include "diagnostics/profiler.h"
+#include "raytracer/memory_account.h"
 #include <stb/stb_image_write.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <vector>
 
-bool ImageWriter::writePNG(const Image& image, const std::string& path) {
+// stb hands the encoded file to a callback in one piece
+static void appendBytes(void* context, void* data, int size) {
+    auto* out = static_cast<std::vector<uint8_t>*>(context);
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+}
+
+// ── ImageWriter ─────────────────────────────────────────────────────────────
+
+bool ImageWriter::writePNG(const Image& image, const std::string& path,
+                           MemoryAccount* account) {
     if (image.width <= 0 || image.height <= 0 || path.empty()) {
         return false;
     }
@@ -13,16 +27,58 @@ bool ImageWriter::writePNG(const Image& image, const std::string& path) {
         return false;
     }
 
-    std::vector<uint8_t> data(numPixels * 4);
-    for (int i = 0; i < numPixels; ++i) {
+    ProfileZone zone("encode png", "stage");
+    std::vector<uint8_t> data = toRGBA8(image);
+    // stb's filter and deflate buffers are its own and not seen here
+    MemoryCharge staging(account, MemoryCategory::Encoder, MemoryFootprint::of(data));
+    int stride = image.width * 4;
+    int result = stbi_write_png(path.c_str(), image.width, image.height, 4, data.data(), stride);
+    return result != 0;
+}
+
+bool ImageWriter::writePNG(const Image& image, const std::string& path, EncodeBuffer& buffer) {
+    if (path.empty() || !encodePNG(image, buffer)) {
+        return false;
+    }
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(buffer.png.data(), 1, buffer.png.size(), f) == buffer.png.size();
+    ok = std::fclose(f) == 0 && ok;
+    return ok;
+}
+
+bool ImageWriter::encodePNG(const Image& image, EncodeBuffer& buffer) {
+    buffer.png.clear();
+    if (image.width <= 0 || image.height <= 0) {
+        return false;
+    }
+    const int numPixels = image.width * image.height;
+    if (static_cast<int>(image.pixels.size()) < numPixels) {
+        return false;
+    }
+
+    ProfileZone zone("encode png", "stage");
+    toRGBA8(image, buffer.rgba);
+    int stride = image.width * 4;
+    int result = stbi_write_png_to_func(appendBytes, &buffer.png, image.width, image.height, 4,
+                                        buffer.rgba.data(), stride);
+    return result != 0;
+}
+
+std::vector<uint8_t> ImageWriter::toRGBA8(const Image& image) {
+    std::vector<uint8_t> data;
+    toRGBA8(image, data);
+    return data;
+}
+
+void ImageWriter::toRGBA8(const Image& image, std::vector<uint8_t>& data) {
+    const int numPixels = std::max(0, image.width * image.height);
+    data.assign(static_cast<size_t>(numPixels) * 4, 0);
+    for (int i = 0; i < numPixels && i < static_cast<int>(image.pixels.size()); ++i) {
         Color c = image.pixels[i].clamp();
         data[i * 4 + 0] = static_cast<uint8_t>(c.r * 255.0f + 0.5f);
         data[i * 4 + 1] = static_cast<uint8_t>(c.g * 255.0f + 0.5f);
         data[i * 4 + 2] = static_cast<uint8_t>(c.b * 255.0f + 0.5f);
         data[i * 4 + 3] = static_cast<uint8_t>(c.a * 255.0f + 0.5f);
     }
-
-    int stride = image.width * 4;
-    int result = stbi_write_png(path.c_str(), image.width, image.height, 4, data.data(), stride);
-    return result != 0;
 }
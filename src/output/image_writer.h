@@ -1,12 +1,43 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "skin/image.h"
 
+class MemoryAccount;
+
+// Reusable PNG encoding buffers. Keep one per worker: once it has encoded
+// an image of a given size, the staging and output vectors are reused.
+// stb_image_write's own scratch (filtered scanlines, deflate hash chains)
+// is still malloc'd and freed inside each encode. The buffer's owner
+// charges capacityBytes() to its memory account; writePNG() without a
+// buffer charges its staging to the account it is given.
+struct EncodeBuffer {
+    std::vector<uint8_t> rgba;          // RGBA8 staging
+    std::vector<uint8_t> png;           // the encoded file after encodePNG()
+
+    // Bytes held across encodes
+    size_t capacityBytes() const { return rgba.capacity() + png.capacity(); }
+};
+
 class ImageWriter {
 public:
     // Write an Image to a PNG file at the given path.
     // Converts float RGBA [0,1] to uint8 RGBA [0,255].
     // Returns true on success, false on failure (e.g. invalid path).
-    static bool writePNG(const Image& image, const std::string& path);
+    // The RGBA8 staging is charged to `account` as Encoder, if given.
+    static bool writePNG(const Image& image, const std::string& path,
+                         MemoryAccount* account = nullptr);
+
+    // Same, encoding through reusable buffers (the file itself is written
+    // with stdio)
+    static bool writePNG(const Image& image, const std::string& path, EncodeBuffer& buffer);
+
+    // Encode to buffer.png. Returns false for an empty or short image.
+    static bool encodePNG(const Image& image, EncodeBuffer& buffer);
+
+    // Convert float RGBA [0,1] to tightly packed uint8 RGBA, row-major.
+    static std::vector<uint8_t> toRGBA8(const Image& image);
+    static void toRGBA8(const Image& image, std::vector<uint8_t>& data);
 };
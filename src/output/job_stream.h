@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "math/color.h"
+#include "math/vec3.h"
+
+// Little-endian field streams shared by the binary file formats of this
+// directory (render_job.cpp, render_checkpoint.cpp). Internal header.
+
+// ── Field streams ───────────────────────────────────────────────────────────
+// One transfer() per record serves both directions, so the field order is
+// written down once.
+
+class JobWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    void operator()(uint32_t v) {
+        for (int i = 0; i < 4; ++i) bytes.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void operator()(uint64_t v) {
+        (*this)(static_cast<uint32_t>(v));
+        (*this)(static_cast<uint32_t>(v >> 32));
+    }
+    void operator()(int v) { (*this)(static_cast<uint32_t>(v)); }
+    void operator()(bool v) { (*this)(v ? 1u : 0u); }
+    // Enums carry their last enumerator, which the reader checks against
+    template<typename E, typename = std::enable_if_t<std::is_enum_v<E>>>
+    void operator()(E v, E /*last*/) { (*this)(static_cast<uint32_t>(v)); }
+    void operator()(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        (*this)(bits);
+    }
+    void operator()(const Vec3& v) { (*this)(v.x); (*this)(v.y); (*this)(v.z); }
+    void operator()(const Color& c) { (*this)(c.r); (*this)(c.g); (*this)(c.b); (*this)(c.a); }
+    void raw(const uint8_t* data, size_t size) { bytes.insert(bytes.end(), data, data + size); }
+};
+
+class JobReader {
+public:
+    JobReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == size_; }
+
+    void operator()(uint32_t& v) {
+        v = 0;
+        if (!take(4)) return;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(data_[pos_ - 4 + i]) << (8 * i);
+    }
+    void operator()(uint64_t& v) {
+        uint32_t lo, hi;
+        (*this)(lo);
+        (*this)(hi);
+        v = static_cast<uint64_t>(hi) << 32 | lo;
+    }
+    void operator()(int& v) {
+        uint32_t u;
+        (*this)(u);
+        v = static_cast<int>(u);
+    }
+    void operator()(bool& v) {
+        uint32_t u;
+        (*this)(u);
+        if (u > 1) ok_ = false;
+        v = u != 0;
+    }
+    // Values past `last` fail the stream rather than reach a switch
+    template<typename E, typename = std::enable_if_t<std::is_enum_v<E>>>
+    void operator()(E& v, E last) {
+        uint32_t u;
+        (*this)(u);
+        if (u > static_cast<uint32_t>(last)) {
+            ok_ = false;
+            u = 0;
+        }
+        v = static_cast<E>(u);
+    }
+    void operator()(float& v) {
+        uint32_t bits;
+        (*this)(bits);
+        std::memcpy(&v, &bits, sizeof(v));
+    }
+    void operator()(Vec3& v) { (*this)(v.x); (*this)(v.y); (*this)(v.z); }
+    void operator()(Color& c) { (*this)(c.r); (*this)(c.g); (*this)(c.b); (*this)(c.a); }
+    const uint8_t* raw(size_t size) { return take(size) ? data_ + pos_ - size : nullptr; }
+
+private:
+    bool take(size_t n) {
+        if (!ok_ || size_ - pos_ < n) {
+            ok_ = false;
+            return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+template<typename IO, typename P>
+void transfer(IO& io, P& part) {
+    io(part.rotX);
+    io(part.rotZ);
+}
+
+template<typename IO, typename C>
+void transferCamera(IO& io, C& camera) {
+    io(camera.position);
+    io(camera.target);
+    io(camera.up);
+    io(camera.fov);
+}
+
+template<typename IO, typename L>
+void transferLight(IO& io, L& light) {
+    io(light.position);
+    io(light.color);
+    io(light.intensity);
+    io(light.radius);
+}
+
+// Every RayTracer::Config field, in declaration order. Adding a field
+// means appending it here and bumping RENDER_JOB_VERSION.
+template<typename IO, typename C>
+void transferConfig(IO& io, C& c) {
+    io(c.width); io(c.height);
+    io(c.maxBounces); io(c.samplesPerPixel);
+    io(c.tileSize); io(c.threadCount);
+    io(c.tileSchedule, decltype(c.tileSchedule)::CostFirst);
+    io(c.traversal, decltype(c.traversal)::Hilbert);
+    io(c.sampleOffset);
+    io(c.regionX); io(c.regionY); io(c.regionWidth); io(c.regionHeight);
+    io(c.softShadows); io(c.shadowSamples);
+    io(c.aoEnabled); io(c.aoSamples); io(c.aoRadius); io(c.aoIntensity);
+    io(c.dofEnabled); io(c.aperture); io(c.focusDistance);
+    io(c.gradientBg); io(c.gradientScale);
+    io(c.bgCenter); io(c.bgEdge);
+    io(c.autoQuality);
+    io(c.quality.fullDetailTexelPixels); io(c.quality.minShadowSamples);
+    io(c.quality.minAoSamples); io(c.quality.reducedMaxBounces);
+    io(c.quality.singleBounceTexelPixels); io(c.quality.minDofBlurPixels);
+}
+
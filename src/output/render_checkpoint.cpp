@@ -0,0 +1,320 @@
+#include "output/render_checkpoint.h"
+#include "output/job_stream.h"
+#include "io/hash.h"
+#include "raytracer/memory_account.h"
+#include "raytracer/quality_policy.h"
+#include "raytracer/render_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static constexpr char CHECKPOINT_MAGIC[4] = {'M', 'C', 'C', 'K'};
+static constexpr size_t HEADER_BYTES = 4 + 4 + 4 + 8 + 3 * 4;
+static constexpr size_t PIXEL_BYTES = sizeof(Color) + sizeof(uint32_t);
+static_assert(sizeof(Color) == 4 * sizeof(float), "Color is written as four raw floats");
+static constexpr uint32_t MAX_SIDE = 65536;
+
+// ── Fingerprint ─────────────────────────────────────────────────────────────
+
+template<typename IO>
+static void transferTriangles(IO& io, const Mesh& mesh, const std::vector<Triangle>& triangles) {
+    io(static_cast<uint32_t>(triangles.size()));
+    for (const Triangle& t : triangles) {
+        io(t.v0); io(t.v1); io(t.v2); io(t.normal);
+        io(t.u0); io(t.v0_uv); io(t.u1); io(t.v1_uv); io(t.u2); io(t.v2_uv);
+        int texture = -1;
+        for (int i = 0; i < 6; ++i) {
+            if (t.texture == &mesh.ownedTextures[i]) texture = i;
+        }
+        io(texture);
+    }
+}
+
+uint64_t RenderCheckpointFile::fingerprint(const Scene& scene, const RayTracer::Config& config) {
+    // The config as traced: the effects the quality policy picks, not the
+    // autoQuality flag or its thresholds. Fields that only change the speed are left out: a
+    // render may resume on another machine, with other threads or tiles
+    RayTracer::Config c = QualityPolicy::resolve(scene, config);
+    c.autoQuality = false;
+    c.quality = QualityThresholds();
+    c.tileSize = 0;
+    c.threadCount = 0;
+    c.tileSchedule = TileSchedule::InOrder;
+    c.traversal = Traversal::RowMajor;
+    c.sampleOffset = 0;
+
+    JobWriter w;
+    transferConfig(w, c);
+    transferCamera(w, scene.camera);
+    transferLight(w, scene.light);
+    w(scene.backgroundColor);
+    w(static_cast<uint32_t>(scene.meshes.size()));
+    uint64_t hash = fnv1a64(w.bytes.data(), w.bytes.size());
+
+    // One mesh at a time, so the scene is never serialised whole
+    for (const Mesh& mesh : scene.meshes) {
+        JobWriter m;
+        m(mesh.isOuterLayer);
+        m(mesh.hasRotation);
+        m(mesh.pivot);
+        m(mesh.rotX);
+        m(mesh.rotZ);
+        transferTriangles(m, mesh, mesh.triangles);
+        transferTriangles(m, mesh, mesh.localTriangles);
+        for (const TextureRegion& t : mesh.ownedTextures) {
+            m(t.width);
+            m(t.height);
+            for (const Color& texel : t.pixels) m(texel);
+        }
+        hash = fnv1a64(m.bytes.data(), m.bytes.size(), hash);
+    }
+    return hash;
+}
+
+// ── File ────────────────────────────────────────────────────────────────────
+
+bool RenderCheckpointFile::write(const RenderCheckpoint& checkpoint, const std::string& path) {
+    const SampleAccumulator& a = checkpoint.accumulator;
+    const size_t pixels = static_cast<size_t>(std::max(0, checkpoint.width)) * std::max(0, checkpoint.height);
+    if (path.empty() || a.sum.size() != pixels || a.samples.size() != pixels) return false;
+
+    // A temp name of its own per writer, as SkinCache: two renders of one
+    // checkpoint must not write into the same temp file
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016" PRIx64 ".tmp", static_cast<uint64_t>(rng()));
+    const std::string tmp = path + suffix;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        JobWriter w;
+        w.raw(reinterpret_cast<const uint8_t*>(CHECKPOINT_MAGIC), sizeof(CHECKPOINT_MAGIC));
+        w(RENDER_CHECKPOINT_VERSION);
+        w.raw(reinterpret_cast<const uint8_t*>(&RENDER_CHECKPOINT_BYTE_ORDER), sizeof(uint32_t));
+        w(checkpoint.fingerprint);
+        w(checkpoint.width);
+        w(checkpoint.height);
+        w(a.totalSamples);
+        out.write(reinterpret_cast<const char*>(w.bytes.data()),
+                  static_cast<std::streamsize>(w.bytes.size()));
+
+        // Straight from the accumulator: an 8K checkpoint is over 600 MB
+        out.write(reinterpret_cast<const char*>(a.sum.data()),
+                  static_cast<std::streamsize>(pixels * sizeof(Color)));
+        out.write(reinterpret_cast<const char*>(a.samples.data()),
+                  static_cast<std::streamsize>(pixels * sizeof(uint32_t)));
+        out.flush();
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+Result<RenderCheckpoint, std::string> RenderCheckpointFile::read(const std::string& path) {
+    using R = Result<RenderCheckpoint, std::string>;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return R::err("Cannot open checkpoint: " + path);
+
+    std::vector<uint8_t> bytes(HEADER_BYTES);
+    in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!in) return R::err("Not a render checkpoint: " + path);
+    JobReader r(bytes.data(), bytes.size());
+    const uint8_t* magic = r.raw(sizeof(CHECKPOINT_MAGIC));
+    if (!magic || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+        return R::err("Not a render checkpoint: " + path);
+    }
+    uint32_t version = 0;
+    r(version);
+    if (version != RENDER_CHECKPOINT_VERSION) {
+        return R::err("Unsupported checkpoint version " + std::to_string(version));
+    }
+    uint32_t byteOrder = 0;
+    std::memcpy(&byteOrder, r.raw(sizeof(byteOrder)), sizeof(byteOrder));
+    if (byteOrder != RENDER_CHECKPOINT_BYTE_ORDER) {
+        return R::err("Checkpoint was written with a different byte order");
+    }
+
+    RenderCheckpoint checkpoint;
+    uint32_t width = 0, height = 0, target = 0;
+    r(checkpoint.fingerprint);
+    r(width);
+    r(height);
+    r(target);
+    if (width == 0 || height == 0 || width > MAX_SIDE || height > MAX_SIDE || target == 0) {
+        return R::err("Invalid image size in checkpoint");
+    }
+    checkpoint.width = static_cast<int>(width);
+    checkpoint.height = static_cast<int>(height);
+
+    const size_t pixels = static_cast<size_t>(width) * height;
+    std::error_code ec;
+    if (fs::file_size(path, ec) != HEADER_BYTES + pixels * PIXEL_BYTES || ec) {
+        return R::err("Truncated checkpoint: " + path);
+    }
+
+    SampleAccumulator& a = checkpoint.accumulator;
+    a.totalSamples = static_cast<int>(target);
+    a.sum.resize(pixels);
+    a.samples.resize(pixels);
+    in.read(reinterpret_cast<char*>(a.sum.data()), static_cast<std::streamsize>(pixels * sizeof(Color)));
+    in.read(reinterpret_cast<char*>(a.samples.data()),
+            static_cast<std::streamsize>(pixels * sizeof(uint32_t)));
+    if (!in) return R::err("Truncated checkpoint: " + path);
+    for (uint32_t n : a.samples) {
+        if (n > target) return R::err("Invalid sample count in checkpoint");
+    }
+    return R::ok(std::move(checkpoint));
+}
+
+// ── Render ──────────────────────────────────────────────────────────────────
+
+// Fewest samples of any pixel in the render region
+static int fewestSamples(const SampleAccumulator& a, const Tile& region, int width) {
+    uint32_t fewest = static_cast<uint32_t>(a.totalSamples);
+    for (int y = region.y; y < region.y + region.height; ++y) {
+        for (int x = region.x; x < region.x + region.width; ++x) {
+            fewest = std::min(fewest, a.samples[static_cast<size_t>(y) * width + x]);
+        }
+    }
+    return static_cast<int>(fewest);
+}
+
+// The mean of every pixel, computed exactly as renderTile() does
+static Image resolve(const SampleAccumulator& a, int width, int height) {
+    Image image(width, height);
+    for (size_t i = 0; i < image.pixels.size(); ++i) {
+        if (a.samples[i] == 0) continue;
+        const Color& sum = a.sum[i];
+        float inv = 1.0f / static_cast<float>(a.samples[i]);
+        image.pixels[i] = Color(sum.r * inv, sum.g * inv, sum.b * inv, sum.a * inv);
+    }
+    return image;
+}
+
+Result<CheckpointResult, std::string> RenderCheckpointFile::render(const Scene& scene,
+                                                                   const RayTracer::Config& config,
+                                                                   const CheckpointOptions& options,
+                                                                   std::function<void(int, int)> progressCallback,
+                                                                   RenderControl* control) {
+    using R = Result<CheckpointResult, std::string>;
+    using Clock = std::chrono::steady_clock;
+    const int target = std::max(1, config.samplesPerPixel);
+
+    CheckpointResult result;
+    RenderCheckpoint checkpoint;
+    checkpoint.fingerprint = fingerprint(scene, config);
+    checkpoint.width = std::max(0, config.width);
+    checkpoint.height = std::max(0, config.height);
+
+    std::error_code ec;
+    const bool resuming = !options.path.empty() && fs::exists(options.path, ec);
+    if (resuming) {
+        auto loaded = read(options.path);
+        if (!loaded.isOk()) return R::err(*loaded.error);
+        const RenderCheckpoint& c = *loaded.value;
+        if (c.fingerprint != checkpoint.fingerprint || c.width != checkpoint.width
+            || c.height != checkpoint.height || c.accumulator.totalSamples != target) {
+            return R::err("Checkpoint " + options.path + " belongs to a different render");
+        }
+        checkpoint = std::move(*loaded.value);
+    }
+    SampleAccumulator& accumulator = checkpoint.accumulator;
+    accumulator.totalSamples = target;
+    accumulator.prepare(checkpoint.width, checkpoint.height);
+
+    const Tile region = TileRenderer::renderRegion(config);
+    int done = fewestSamples(accumulator, region, checkpoint.width);
+    if (resuming) result.resumedFrom = done;
+
+    Clock::time_point lastSave = Clock::now();
+    auto save = [&]() {
+        if (options.path.empty()) return true;
+        if (!write(checkpoint, options.path)) return false;
+        ++result.checkpointsWritten;
+        lastSave = Clock::now();
+        return true;
+    };
+    auto sinceSave = [&]() { return std::chrono::duration<double>(Clock::now() - lastSave).count(); };
+
+    // The caller's control, so pausing and monitors work as for render()
+    RenderControl local;
+    RenderControl& active = control ? *control : local;
+    SampleAccumulator* previous = active.accumulator;
+    active.accumulator = &accumulator;
+
+    MemoryAccount* account = options.memory;
+    MemoryCharge accumulatorCharge(account, MemoryCategory::Renderer,
+                                   MemoryFootprint::of(accumulator.sum)
+                                   + MemoryFootprint::of(accumulator.samples));
+    RenderPool pool;
+    pool.setMemoryAccount(account);
+    Image passImage(checkpoint.width, checkpoint.height);
+    MemoryCharge passCharge(account, MemoryCategory::Framebuffer, MemoryFootprint::image(passImage));
+    const int perPass = std::max(1, options.samplesPerPass);
+    bool saved = true;
+    std::string stalled;
+    while (done < target && !active.cancel.load()) {
+        RayTracer::Config pass = config;
+        pass.sampleOffset = done;
+        pass.samplesPerPixel = std::min(target, done + perPass) - done;
+        TileRenderer::renderInto(scene, pass, passImage, pool, nullptr, &active);
+        const int before = done;
+        done = fewestSamples(accumulator, region, checkpoint.width);
+        if (active.cancel.load()) break;
+
+        // A pass that leaves some pixel behind would be repeated forever:
+        // a tile that throws every time, or the control's deadline passed
+        if (done <= before) {
+            const auto& errors = TileRenderer::lastErrors();
+            stalled = errors.empty()
+                ? std::string("Render stopped making progress at ") + std::to_string(done)
+                      + " samples per pixel (deadline passed?)"
+                : "Tile " + std::to_string(errors.front().tileIndex) + " failed: "
+                      + errors.front().message;
+            break;
+        }
+
+        if (progressCallback) progressCallback(done, target);
+        if (done < target && sinceSave() >= options.intervalSeconds) {
+            saved = save();
+            if (!saved) break;
+        }
+    }
+    active.accumulator = previous;
+
+    result.complete = done >= target;
+    if (saved && !result.complete) saved = save();
+    if (!saved) return R::err("Cannot write checkpoint: " + options.path);
+    if (!stalled.empty()) return R::err(stalled);
+    if (result.complete && !options.path.empty()) {
+        if (options.removeWhenDone) {
+            fs::remove(options.path, ec);
+        } else if (!save()) {
+            return R::err("Cannot write checkpoint: " + options.path);
+        }
+    }
+
+    result.samplesPerPixel = done;
+    result.image = resolve(accumulator, checkpoint.width, checkpoint.height);
+    return R::ok(std::move(result));
+}
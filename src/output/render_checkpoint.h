@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "raytracer/raytracer.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/scene.h"
+#include "skin/image.h"
+#include "skin/skin_parser.h"
+
+class MemoryAccount;
+
+// 断点续渲 (.mcckpt)
+//
+// A long render (an 8K poster at 256 spp) runs in passes of a few samples
+// per pixel. Every pass continues per-pixel running sums in sample order
+// (SampleAccumulator), the very float additions one uninterrupted render
+// makes, so the final image is bit-identical to TileRenderer::render()
+// however often the render was stopped and resumed. A checkpoint holds
+// the sums and the sample count of every pixel; the count is also the
+// pixel's position in its random stream (PixelSampler(px, py, index)), so
+// nothing else needs saving. It is written between passes once the
+// interval has passed and when the render is cancelled; a pass cut short
+// leaves some tiles one pass ahead, which the per-pixel counts record.
+// Writes go to path + ".tmp" and are renamed over the previous file, so a
+// process killed mid-write keeps the last good checkpoint.
+//
+// Layout (header little-endian; the two arrays are written and read in
+// bulk in host order, which byteOrder records):
+//   "MCCK" u32 version, u32 byteOrder (RENDER_CHECKPOINT_BYTE_ORDER)
+//   u64 fingerprint   of the scene and the config as traced (autoQuality
+//                     resolved, see QualityPolicy::resolve())
+//   u32 width, u32 height, u32 target samples per pixel
+//   Color[width × height]      sums, row-major
+//   u32[width × height]        sample counts, row-major
+
+static constexpr uint32_t RENDER_CHECKPOINT_VERSION = 2;
+static constexpr uint32_t RENDER_CHECKPOINT_BYTE_ORDER = 0x01020304u;
+
+struct RenderCheckpoint {
+    uint64_t fingerprint = 0;
+    int width = 0;
+    int height = 0;
+    SampleAccumulator accumulator;  // totalSamples = target samples per pixel
+};
+
+struct CheckpointOptions {
+    std::string path;                   // empty = never write
+    double intervalSeconds = 600.0;     // between checkpoints
+    int samplesPerPass = 1;
+    bool removeWhenDone = true;         // delete the file once complete
+    MemoryAccount* memory = nullptr;    // charged with the sums, pass framebuffer and pool
+};
+
+struct CheckpointResult {
+    Image image;                    // means of the samples so far
+    int samplesPerPixel = 0;        // fewest samples in any pixel
+    int resumedFrom = -1;           // samples per pixel in the loaded checkpoint, -1 = fresh
+    int checkpointsWritten = 0;
+    bool complete = false;          // false: cancelled, state saved
+};
+
+class RenderCheckpointFile {
+public:
+    static bool write(const RenderCheckpoint& checkpoint, const std::string& path);
+    static Result<RenderCheckpoint, std::string> read(const std::string& path);
+
+    // Scene geometry, textures, camera, light, background and every config
+    // field that changes the image (not tile size, threads, schedule,
+    // traversal or sampleOffset)
+    static uint64_t fingerprint(const Scene& scene, const RayTracer::Config& config);
+
+    // Render config.samplesPerPixel samples (indices from 0; sampleOffset
+    // is ignored) with checkpoints at options.path, resuming from it if it
+    // exists. A checkpoint of another scene or config is an error, not
+    // overwritten. progressCallback gets (samples per pixel done, target)
+    // after each pass; `control` works as for render() and cancelling
+    // saves a checkpoint and returns the partial image. A pass that moves
+    // no pixel forward (a tile failing every time, the control's deadline
+    // passed) saves a checkpoint and returns an error.
+    static Result<CheckpointResult, std::string> render(const Scene& scene,
+                                                        const RayTracer::Config& config,
+                                                        const CheckpointOptions& options,
+                                                        std::function<void(int, int)> progressCallback = nullptr,
+                                                        RenderControl* control = nullptr);
+};
@@ -0,0 +1,184 @@
+#include "output/render_job.h"
+#include "output/job_stream.h"
+#include "diagnostics/profiler.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+static constexpr char JOB_MAGIC[4] = {'M', 'C', 'J', 'B'};
+static constexpr uint32_t MAX_SKIN_SIDE = 1024;
+static constexpr uint32_t MAX_NAME_LENGTH = 4096;
+
+// ── RenderJob ───────────────────────────────────────────────────────────────
+
+RenderJob RenderJob::capture(const Rgba8Image* skin, const Pose& pose,
+                             const Scene& scene, const RayTracer::Config& config) {
+    RenderJob job;
+    if (skin) job.skin = *skin;
+    job.pose = pose;
+    job.camera = scene.camera;
+    job.light = scene.light;
+    job.backgroundColor = scene.backgroundColor;
+    job.config = config;
+    return job;
+}
+
+static void applyView(const RenderJob& job, Scene& scene) {
+    scene.camera = job.camera;
+    scene.light = job.light;
+    scene.backgroundColor = job.backgroundColor;
+}
+
+static Result<std::optional<SkinData>, std::string> parseSkin(const RenderJob& job) {
+    using R = Result<std::optional<SkinData>, std::string>;
+    if (job.skin.pixels.empty()) return R::ok(std::nullopt);
+    auto parsed = SkinParser::parse(job.skin.view());
+    if (!parsed.isOk()) return R::err(*parsed.error);
+    return R::ok(std::move(*parsed.value));
+}
+
+Result<Scene, std::string> RenderJob::buildScene() const {
+    auto skinData = parseSkin(*this);
+    if (!skinData.isOk()) return Result<Scene, std::string>::err(*skinData.error);
+    Scene scene = skinData.value->has_value()
+                  ? MeshBuilder::buildScene(**skinData.value, pose)
+                  : MeshBuilder::buildDefaultScene(pose);
+    applyView(*this, scene);
+    return Result<Scene, std::string>::ok(std::move(scene));
+}
+
+// ── File ────────────────────────────────────────────────────────────────────
+
+bool RenderJobFile::write(const RenderJob& job, const std::string& path) {
+    const Rgba8Image& skin = job.skin;
+    if (skin.pixels.size() != static_cast<size_t>(skin.width) * skin.height * 4) return false;
+
+    JobWriter w;
+    w.raw(reinterpret_cast<const uint8_t*>(JOB_MAGIC), sizeof(JOB_MAGIC));
+    w(RENDER_JOB_VERSION);
+    w(0u);  // flags, reserved
+
+    w(static_cast<uint32_t>(skin.width));
+    w(static_cast<uint32_t>(skin.height));
+    w.raw(skin.pixels.data(), skin.pixels.size());
+
+    w(static_cast<uint32_t>(job.pose.name.size()));
+    w.raw(reinterpret_cast<const uint8_t*>(job.pose.name.data()), job.pose.name.size());
+    for (const PartPose* part : {&job.pose.head, &job.pose.body, &job.pose.rightArm,
+                                 &job.pose.leftArm, &job.pose.rightLeg, &job.pose.leftLeg}) {
+        transfer(w, *part);
+    }
+
+    transferCamera(w, job.camera);
+    transferLight(w, job.light);
+    w(job.backgroundColor);
+    transferConfig(w, job.config);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(w.bytes.data()),
+              static_cast<std::streamsize>(w.bytes.size()));
+    return static_cast<bool>(out);
+}
+
+Result<RenderJob, std::string> RenderJobFile::read(const std::string& path) {
+    using R = Result<RenderJob, std::string>;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return R::err("Cannot open render job: " + path);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    JobReader r(bytes.data(), bytes.size());
+    const uint8_t* magic = r.raw(sizeof(JOB_MAGIC));
+    if (!magic || std::memcmp(magic, JOB_MAGIC, sizeof(JOB_MAGIC)) != 0) {
+        return R::err("Not a render job file: " + path);
+    }
+    uint32_t version = 0, flags = 0;
+    r(version);
+    r(flags);
+    if (version != RENDER_JOB_VERSION) {
+        return R::err("Unsupported render job version " + std::to_string(version));
+    }
+
+    RenderJob job;
+    uint32_t width = 0, height = 0;
+    r(width);
+    r(height);
+    if (width > MAX_SKIN_SIDE || height > MAX_SKIN_SIDE) return R::err("Invalid skin size in render job");
+    size_t skinBytes = static_cast<size_t>(width) * height * 4;
+    if (const uint8_t* texels = r.raw(skinBytes)) {
+        job.skin.width = static_cast<int>(width);
+        job.skin.height = static_cast<int>(height);
+        job.skin.pixels.assign(texels, texels + skinBytes);
+    }
+
+    uint32_t nameLength = 0;
+    r(nameLength);
+    if (nameLength > MAX_NAME_LENGTH) return R::err("Invalid pose name in render job");
+    if (const uint8_t* name = r.raw(nameLength)) {
+        job.pose.name.assign(reinterpret_cast<const char*>(name), nameLength);
+    }
+    for (PartPose* part : {&job.pose.head, &job.pose.body, &job.pose.rightArm,
+                           &job.pose.leftArm, &job.pose.rightLeg, &job.pose.leftLeg}) {
+        transfer(r, *part);
+    }
+
+    transferCamera(r, job.camera);
+    transferLight(r, job.light);
+    r(job.backgroundColor);
+    transferConfig(r, job.config);
+
+    if (!r.ok()) return R::err("Truncated render job: " + path);
+    if (!r.atEnd()) return R::err("Trailing data in render job: " + path);
+    if (job.config.width <= 0 || job.config.height <= 0) return R::err("Invalid image size in render job");
+    return R::ok(std::move(job));
+}
+
+// ── Replay ──────────────────────────────────────────────────────────────────
+
+Result<ReplayResult, std::string> RenderJobFile::replay(const RenderJob& job, int threadCount) {
+    using R = Result<ReplayResult, std::string>;
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    };
+
+    ReplayResult result;
+    Profiler::enable();
+    Profiler::setThreadName("replay");
+
+    Clock::time_point start = Clock::now();
+    std::optional<SkinData> skinData;
+    {
+        ProfileZone zone("parse skin", "stage");
+        auto parsed = parseSkin(job);
+        if (!parsed.isOk()) {
+            Profiler::disable();
+            return R::err(*parsed.error);
+        }
+        skinData = std::move(*parsed.value);
+    }
+    Clock::time_point parsed = Clock::now();
+
+    Scene scene = skinData ? MeshBuilder::buildScene(*skinData, job.pose)
+                           : MeshBuilder::buildDefaultScene(job.pose);
+    applyView(job, scene);
+    Clock::time_point built = Clock::now();
+
+    RayTracer::Config config = job.config;
+    if (threadCount > 0) config.threadCount = threadCount;
+    result.image = TileRenderer::render(scene, config);
+    Clock::time_point rendered = Clock::now();
+
+    Profiler::disable();
+    result.stats = TileRenderer::lastStats();
+    result.parseSeconds = seconds(start, parsed);
+    result.buildSeconds = seconds(parsed, built);
+    result.renderSeconds = seconds(built, rendered);
+    result.traceJson = Profiler::chromeTraceJson();
+    return R::ok(std::move(result));
+}
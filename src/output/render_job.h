@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include "raytracer/raytracer.h"
+#include "raytracer/render_stats.h"
+#include "scene/pose.h"
+#include "scene/scene.h"
+#include "skin/image.h"
+#include "skin/skin_parser.h"
+
+// 渲染任务抓取与回放 (.mcjob)
+//
+// A captured render job holds everything needed to reproduce one render
+// from scratch: the skin texels as loaded (not the meshes built from
+// them), the pose, camera, light, background colour and every
+// RayTracer::Config field. Replaying it rebuilds the scene exactly like
+// the application does and renders it with the Profiler on, so a slow
+// job reported by a user becomes a one-file repro case.
+//
+// Layout (little-endian, every float stored as its IEEE-754 bits):
+//   "MCJB" u32 version u32 flags
+//   skin      u32 width, u32 height, width * height * 4 RGBA8 bytes
+//             (0 x 0 = default white model)
+//   pose      u32 name length, UTF-8 name, 6 x (rotX, rotZ)
+//   camera    position, target, up, fov
+//   light     position, color, intensity, radius
+//   background color
+//   config    all fields in declaration order (see render_job.cpp)
+
+static constexpr uint32_t RENDER_JOB_VERSION = 2;
+
+struct RenderJob {
+    Rgba8Image skin;            // empty = MeshBuilder::buildDefaultScene
+    Pose pose;
+    Camera camera;
+    Light light;
+    Color backgroundColor;
+    RayTracer::Config config;
+
+    // Snapshot of a scene built from (skin, pose); camera, light and
+    // background are taken from the scene
+    static RenderJob capture(const Rgba8Image* skin, const Pose& pose,
+                             const Scene& scene, const RayTracer::Config& config);
+
+    // Rebuild the scene: parse the skin, build the posed meshes and
+    // apply camera, light and background
+    Result<Scene, std::string> buildScene() const;
+};
+
+struct ReplayResult {
+    Image image;
+    RenderStats stats;              // TileRenderer::lastStats() of the render
+    double parseSeconds = 0.0;      // skin parsing
+    double buildSeconds = 0.0;      // mesh building
+    double renderSeconds = 0.0;     // TileRenderer::render, wall clock
+    std::string traceJson;          // Chrome trace of the whole replay
+};
+
+class RenderJobFile {
+public:
+    static bool write(const RenderJob& job, const std::string& path);
+    static Result<RenderJob, std::string> read(const std::string& path);
+
+    // Re-run a job with profiling enabled. threadCount > 0 overrides the
+    // captured value; the image does not depend on it (per-pixel seeds).
+    // A previously enabled Profiler is cleared and left disabled.
+    static Result<ReplayResult, std::string> replay(const RenderJob& job, int threadCount = 0);
+};
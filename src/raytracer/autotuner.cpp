@@ -0,0 +1,255 @@
+#include "raytracer/autotuner.h"
+#include "raytracer/tile_renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// ── Profile ─────────────────────────────────────────────────────────────────
+
+static std::string cpuModel() {
+#if defined(_WIN32)
+    if (const char* id = std::getenv("PROCESSOR_IDENTIFIER")) return id;
+#elif defined(__linux__)
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(" \t", colon + 1);
+                if (start != std::string::npos) return line.substr(start);
+            }
+        }
+    }
+#endif
+    return "unknown cpu";
+}
+
+std::string TuningProfile::machineFingerprint() {
+    return std::to_string(Autotuner::hardwareThreads()) + " threads, " + cpuModel();
+}
+
+std::optional<TuningEntry> TuningProfile::find(const std::string& workload) const {
+    auto it = entries.find(workload);
+    if (it == entries.end()) return std::nullopt;
+    return it->second;
+}
+
+bool TuningProfile::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "# mcskin tuning profile\n";
+    out << "machine " << machine << "\n";
+    for (const auto& [workload, e] : entries) {
+        out << workload << " " << e.tileSize << " " << e.threadCount << " "
+            << e.megapixelsPerSecond << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+Result<TuningProfile, std::string> TuningProfile::load(const std::string& path) {
+    using R = Result<TuningProfile, std::string>;
+    std::ifstream in(path);
+    if (!in) return R::err("Cannot open tuning profile: " + path);
+
+    TuningProfile profile;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (line.empty() || line[0] == '#') continue;
+        if (line.compare(0, 8, "machine ") == 0) {
+            profile.machine = line.substr(8);
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string workload;
+        TuningEntry e;
+        if (!(fields >> workload >> e.tileSize >> e.threadCount >> e.megapixelsPerSecond)
+            || e.tileSize <= 0 || e.threadCount <= 0) {
+            return R::err(path + ":" + std::to_string(lineNo) + ": malformed entry");
+        }
+        profile.entries[workload] = e;
+    }
+    return R::ok(std::move(profile));
+}
+
+// ── Active profile ──────────────────────────────────────────────────────────
+
+namespace {
+
+struct ActiveProfile {
+    std::mutex mutex;
+    TuningProfile profile;
+};
+
+ActiveProfile& active() {
+    static ActiveProfile a;
+    return a;
+}
+
+}  // namespace
+
+bool Autotuner::setProfile(const TuningProfile& profile) {
+    ActiveProfile& a = active();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    if (profile.machine != TuningProfile::machineFingerprint()) return false;
+    a.profile = profile;
+    return true;
+}
+
+TuningProfile Autotuner::profile() {
+    ActiveProfile& a = active();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    return a.profile;
+}
+
+void Autotuner::clearProfile() {
+    ActiveProfile& a = active();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    a.profile = TuningProfile();
+}
+
+// ── Resolution ──────────────────────────────────────────────────────────────
+
+int Autotuner::hardwareThreads() {
+    int n = static_cast<int>(std::thread::hardware_concurrency());
+    return n > 0 ? n : 1;
+}
+
+std::string Autotuner::workloadClass(const RayTracer::Config& config) {
+    int64_t pixels = static_cast<int64_t>(std::max(0, config.width)) * std::max(0, config.height);
+    const char* size = pixels <= 256 * 256     ? "avatar"
+                     : pixels <= 1024 * 1024   ? "small"
+                     : pixels <= 2560 * 1440   ? "hd"
+                     : "poster";
+
+    // Rough rays per pixel: what decides how long a tile takes
+    int perHit = 1 + (config.softShadows ? std::max(1, config.shadowSamples) : 1)
+               + (config.aoEnabled ? std::max(0, config.aoSamples) : 0);
+    int64_t rays = static_cast<int64_t>(std::max(1, config.samplesPerPixel)) * perHit
+                 * (1 + std::max(0, config.maxBounces));
+    const char* cost = rays < 64 ? "light" : "heavy";
+    return std::string(size) + "/" + cost;
+}
+
+int Autotuner::defaultTileSize(int width, int height, int threadCount) {
+    const int minTiles = 4 * std::max(1, threadCount);
+    for (int size : {64, 32, 16}) {
+        int tiles = ((width + size - 1) / size) * ((height + size - 1) / size);
+        if (tiles >= minTiles) return size;
+    }
+    return 8;
+}
+
+RayTracer::Config Autotuner::resolve(const RayTracer::Config& config) {
+    RayTracer::Config resolved = config;
+    if (config.tileSize > 0 && config.threadCount > 0) return resolved;
+
+    // An unset tile size is what opts a config in to the profile
+    std::optional<TuningEntry> entry;
+    if (config.tileSize <= 0) {
+        ActiveProfile& a = active();
+        std::lock_guard<std::mutex> lock(a.mutex);
+        entry = a.profile.find(workloadClass(config));
+    }
+
+    if (resolved.threadCount <= 0) {
+        resolved.threadCount = entry ? entry->threadCount : hardwareThreads();
+    }
+    if (resolved.tileSize <= 0) {
+        resolved.tileSize = entry ? entry->tileSize
+                          : defaultTileSize(config.width, config.height, resolved.threadCount);
+    }
+    return resolved;
+}
+
+// ── Calibration ─────────────────────────────────────────────────────────────
+
+TuningResult Autotuner::tune(const Scene& scene, const RayTracer::Config& config,
+                             const TuningOptions& options) {
+    using Clock = std::chrono::steady_clock;
+
+    TuningResult result;
+    result.workload = workloadClass(config);
+
+    // One sample per pixel keeps the per-pixel cost profile (effects,
+    // bounces) at a fraction of the time
+    RayTracer::Config probe = config;
+    probe.samplesPerPixel = 1;
+    probe.sampleOffset = 0;
+    probe.regionX = probe.regionY = probe.regionWidth = probe.regionHeight = 0;
+    const int64_t framePixels = static_cast<int64_t>(config.width) * config.height;
+    const bool cropped = framePixels > options.maxProbePixels;
+    if (cropped) {
+        double aspect = static_cast<double>(config.width) / config.height;
+        int w = std::clamp(static_cast<int>(std::sqrt(options.maxProbePixels * aspect)), 1, config.width);
+        int h = std::clamp(options.maxProbePixels / w, 1, config.height);
+        probe.regionX = (config.width - w) / 2;
+        probe.regionY = (config.height - h) / 2;
+        probe.regionWidth = w;
+        probe.regionHeight = h;
+    }
+    const Tile region = TileRenderer::renderRegion(probe);
+    const double probePixels = static_cast<double>(region.width) * region.height;
+
+    std::vector<int> threadCounts = options.threadCounts;
+    if (threadCounts.empty()) {
+        int hw = hardwareThreads();
+        threadCounts = {hw};
+        if (hw / 2 >= 1 && hw / 2 != hw) threadCounts.push_back(hw / 2);
+    }
+
+    // A probe in flight is cut short through its own control, then the
+    // loop ends
+    auto timed = [&]() {
+        RenderControl control;
+        auto forward = [&](int, int) {
+            if (options.cancel && options.cancel->load()) control.cancel.store(true);
+        };
+        TileRenderer::render(scene, probe, forward, &control);
+        if (options.cancel && options.cancel->load()) result.cancelled = true;
+        return !result.cancelled;
+    };
+
+    // Warm caches and the allocator once before measuring
+    probe.tileSize = options.tileSizes.empty() ? 32 : options.tileSizes.front();
+    probe.threadCount = threadCounts.front();
+    if (!timed()) return result;
+
+    for (int threads : threadCounts) {
+        for (int tileSize : options.tileSizes) {
+            if (threads <= 0 || tileSize <= 0) continue;
+            probe.tileSize = tileSize;
+            probe.threadCount = threads;
+
+            // On a cropped probe, too few tiles would be an artefact of the
+            // crop rather than of the tile size
+            size_t tiles = TileRenderer::clipTiles(
+                TileRenderer::generateTiles(probe.width, probe.height, tileSize), region).size();
+            if (cropped && static_cast<int>(tiles) < threads && tileSize != options.tileSizes.front()) {
+                continue;
+            }
+
+            double best = 0.0;
+            for (int k = 0; k < std::max(1, options.repeats); ++k) {
+                Clock::time_point start = Clock::now();
+                if (!timed()) return result;
+                double s = std::chrono::duration<double>(Clock::now() - start).count();
+                if (k == 0 || s < best) best = s;
+            }
+            result.probes.push_back({tileSize, threads, best});
+
+            double mpps = best > 0.0 ? probePixels / best / 1e6 : 0.0;
+            if (mpps > result.best.megapixelsPerSecond || result.best.tileSize == 0) {
+                result.best = TuningEntry{tileSize, threads, mpps};
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "raytracer/raytracer.h"
+#include "scene/scene.h"
+#include "skin/skin_parser.h"
+
+// 自动调优：图块大小与线程数
+//
+// The best tile size and thread count depend on the frame (a 128² avatar
+// has only 16 tiles of 32 px, an 8K poster has thousands), on how much
+// work each pixel does and on the CPU. Autotuner::tune() probes candidate
+// pairs with short calibration renders; the winners are kept per workload
+// class in a TuningProfile that is saved per machine.
+//
+// TileRenderer::render() resolves a config whose tileSize or threadCount is
+// <= 0 ("unset") through Autotuner::resolve(). A config opts in to tuning
+// by leaving the tile size unset (the library default is 32 px): it gets
+// the active profile's entry for the workload class if there is one,
+// otherwise a heuristic. The active profile is only ever set by the
+// application or tool (setProfile()). The image does not depend on either
+// value (per-pixel sample seeds), only the speed does.
+
+struct TuningEntry {
+    int tileSize = 0;
+    int threadCount = 0;
+    double megapixelsPerSecond = 0.0;   // calibration throughput
+};
+
+class TuningProfile {
+public:
+    std::string machine;                        // fingerprint of the measuring machine
+    std::map<std::string, TuningEntry> entries; // by workload class
+
+    // Hardware threads and CPU model of this machine
+    static std::string machineFingerprint();
+
+    std::optional<TuningEntry> find(const std::string& workload) const;
+
+    // Text file: "machine <fingerprint>" then one
+    // "<workload> <tileSize> <threadCount> <Mpixels/s>" line per entry
+    bool save(const std::string& path) const;
+    static Result<TuningProfile, std::string> load(const std::string& path);
+};
+
+struct TuningOptions {
+    std::vector<int> tileSizes = {8, 16, 32, 64, 128};
+    std::vector<int> threadCounts;      // empty = all hardware threads and half of them
+    int maxProbePixels = 512 * 512;     // larger frames are probed on a centred region
+    int repeats = 2;                    // fastest repetition counts
+
+    // Set from another thread to stop after the tiles in flight
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+struct TuningProbe {
+    int tileSize = 0;
+    int threadCount = 0;
+    double seconds = 0.0;
+};
+
+struct TuningResult {
+    std::string workload;
+    TuningEntry best;
+    std::vector<TuningProbe> probes;    // every pair measured
+    bool cancelled = false;             // stopped early; best is of the probes so far
+};
+
+class Autotuner {
+public:
+    // Workload class of a config: frame size class and per-pixel cost class,
+    // e.g. "avatar/light" or "poster/heavy"
+    static std::string workloadClass(const RayTracer::Config& config);
+
+    // Calibration renders of `scene` with one sample per pixel over the
+    // candidate pairs; returns the fastest. The machine should be otherwise
+    // idle: the renders are timed.
+    static TuningResult tune(const Scene& scene, const RayTracer::Config& config,
+                             const TuningOptions& options = TuningOptions{});
+
+    // Active profile for unset configs. A profile measured on another
+    // machine is not applied (returns false).
+    static bool setProfile(const TuningProfile& profile);
+    static TuningProfile profile();
+    static void clearProfile();
+
+    // Config with tileSize/threadCount filled in; set values are kept. The
+    // profile applies only to configs with an unset tile size; otherwise
+    // an unset thread count means all hardware threads.
+    static RayTracer::Config resolve(const RayTracer::Config& config);
+
+    // Fallback without a profile: the largest of 64/32/16/8 px that still
+    // gives every thread at least four tiles
+    static int defaultTileSize(int width, int height, int threadCount);
+    static int hardwareThreads();
+};
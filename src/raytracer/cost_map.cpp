@@ -0,0 +1,93 @@
+#include "raytracer/cost_map.h"
+#include "output/image_writer.h"
+#include <algorithm>
+#include <cstdio>
+
+void CostMap::reset(int w, int h, size_t tileCount) {
+    width = std::max(0, w);
+    height = std::max(0, h);
+    size_t n = static_cast<size_t>(width) * height;
+    pixelSeconds.assign(n, 0.0f);
+    pixelRays.assign(n, 0u);
+    tiles.assign(tileCount, TileCost());
+}
+
+std::vector<float> CostMap::values(CostMetric metric) const {
+    switch (metric) {
+    case CostMetric::PixelTime:
+        return pixelSeconds;
+    case CostMetric::PixelRays:
+        return std::vector<float>(pixelRays.begin(), pixelRays.end());
+    case CostMetric::TileTime:
+        break;
+    }
+
+    std::vector<float> out(static_cast<size_t>(width) * height, 0.0f);
+    for (const TileCost& t : tiles) {
+        if (t.width <= 0 || t.height <= 0) continue;
+        float perPixel = static_cast<float>(t.seconds / (static_cast<double>(t.width) * t.height));
+        for (int y = t.y; y < t.y + t.height && y < height; ++y)
+            for (int x = t.x; x < t.x + t.width && x < width; ++x)
+                out[static_cast<size_t>(y) * width + x] = perPixel;
+    }
+    return out;
+}
+
+// Piecewise-linear ramp through dark blue, purple, red, orange, yellow
+static Color ramp(float t) {
+    static const Color stops[] = {
+        Color(0.02f, 0.02f, 0.15f), Color(0.35f, 0.05f, 0.50f), Color(0.80f, 0.15f, 0.25f),
+        Color(0.98f, 0.55f, 0.05f), Color(1.00f, 1.00f, 0.60f),
+    };
+    const int last = static_cast<int>(sizeof(stops) / sizeof(stops[0])) - 1;
+    t = std::clamp(t, 0.0f, 1.0f) * last;
+    int i = std::min(static_cast<int>(t), last - 1);
+    float f = t - i;
+    return stops[i] * (1.0f - f) + stops[i + 1] * f;
+}
+
+Image CostMap::heatmap(CostMetric metric) const {
+    Image img(width, height);
+    std::vector<float> v = values(metric);
+    if (v.empty()) return img;
+
+    std::vector<float> sorted = v;
+    size_t k = (sorted.size() - 1) * 99 / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    float scale = sorted[k] > 0.0f ? 1.0f / sorted[k] : 0.0f;
+
+    for (size_t i = 0; i < v.size(); ++i) {
+        Color c = ramp(v[i] * scale);
+        c.a = 1.0f;
+        img.pixels[i] = c;
+    }
+    return img;
+}
+
+bool CostMap::writeHeatmapPNG(const std::string& path, CostMetric metric) const {
+    return ImageWriter::writePNG(heatmap(metric), path);
+}
+
+bool CostMap::writePixelCSV(const std::string& path) const {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "x,y,seconds,rays\n");
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            std::fprintf(f, "%d,%d,%.9g,%u\n", x, y, pixelSeconds[i], pixelRays[i]);
+        }
+    }
+    return std::fclose(f) == 0;
+}
+
+bool CostMap::writeTileCSV(const std::string& path) const {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "x,y,width,height,seconds,rays,thread\n");
+    for (const TileCost& t : tiles) {
+        std::fprintf(f, "%d,%d,%d,%d,%.9g,%llu,%d\n", t.x, t.y, t.width, t.height,
+                     t.seconds, static_cast<unsigned long long>(t.rays), t.thread);
+    }
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "skin/image.h"
+
+// 渲染开销热力图
+//
+// Optional diagnostic output of TileRenderer::render(): wall time and rays
+// traced per pixel (all samples together) and wall time per tile. Attach
+// one through RenderControl::costMap; render() sizes it to the frame.
+// Pixels outside the render region stay zero. Rays are zero when the
+// counters are compiled out (MCSKIN_RENDER_STATS=0).
+
+enum class CostMetric { PixelTime, PixelRays, TileTime };
+
+struct TileCost {
+    int x = 0, y = 0, width = 0, height = 0;
+    double seconds = 0.0;
+    uint64_t rays = 0;
+    int thread = -1;            // worker index; -1 = not rendered (cancelled)
+};
+
+struct CostMap {
+    int width = 0;
+    int height = 0;
+    std::vector<float> pixelSeconds;    // row-major
+    std::vector<uint32_t> pixelRays;    // row-major
+    std::vector<TileCost> tiles;        // in render order of the tile grid
+
+    // Size for a frame and clear
+    void reset(int w, int h, size_t tileCount);
+
+    // Per-pixel value of a metric; TileTime spreads each tile's time evenly
+    // over its pixels so tiles of different sizes compare fairly
+    std::vector<float> values(CostMetric metric) const;
+
+    // False-colour image (dark blue → red → yellow), normalised to the 99th
+    // percentile so a few outliers don't wash out the rest
+    Image heatmap(CostMetric metric) const;
+
+    bool writeHeatmapPNG(const std::string& path, CostMetric metric) const;
+
+    // x,y,seconds,rays — one row per pixel
+    bool writePixelCSV(const std::string& path) const;
+
+    // x,y,width,height,seconds,rays,thread — one row per tile
+    bool writeTileCSV(const std::string& path) const;
+};
@@ -0,0 +1,211 @@
+#include "raytracer/cost_model.h"
+#include "raytracer/autotuner.h"
+#include "raytracer/intersection.h"
+#include "raytracer/tile_renderer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// 1 + h + ... + h^n
+static double geometricSum(double h, int n) {
+    double sum = 0.0, term = 1.0;
+    for (int i = 0; i <= n; ++i) {
+        sum += term;
+        term *= h;
+    }
+    return sum;
+}
+
+// Grid tiles overlapping `region`: what clipTiles(generateTiles()) keeps,
+// without building the lists (estimateCosts() predicts once per render)
+static int regionTileCount(const Tile& region, int tileSize) {
+    if (tileSize <= 0 || region.width <= 0 || region.height <= 0) return 0;
+    int cols = (region.x + region.width - 1) / tileSize - region.x / tileSize + 1;
+    int rows = (region.y + region.height - 1) / tileSize - region.y / tileSize + 1;
+    return cols * rows;
+}
+
+static int shadowRaysPerShade(const RayTracer::Config& config) {
+    return (config.softShadows && config.shadowSamples > 1) ? config.shadowSamples : 1;
+}
+
+double CostModel::estimateCoverage(const Scene& scene, const RayTracer::Config& config, int grid) {
+    if (config.width <= 0 || config.height <= 0 || grid <= 0) return 0.0;
+    const Tile region = TileRenderer::renderRegion(config);
+    const float aspect = static_cast<float>(config.width) / static_cast<float>(config.height);
+
+    int hits = 0;
+    for (int gy = 0; gy < grid; ++gy) {
+        for (int gx = 0; gx < grid; ++gx) {
+            // Same pixel → (u, v) mapping as TileRenderer::renderTile
+            float px = region.x + (gx + 0.5f) * region.width / grid;
+            float py = region.y + (gy + 0.5f) * region.height / grid;
+            float u = px / config.width;
+            float v = py / config.height;
+            if (intersectScene(scene.camera.generateRay(u, v, aspect), scene).hit) ++hits;
+        }
+    }
+    return static_cast<double>(hits) / (static_cast<double>(grid) * grid);
+}
+
+CostPrediction CostModel::predict(const RayTracer::Config& config, double coverage) const {
+    CostPrediction p;
+    const RayTracer::Config resolved = Autotuner::resolve(config);
+    const Tile region = TileRenderer::renderRegion(resolved);
+    const double samples = static_cast<double>(region.width) * region.height
+                         * std::max(1, resolved.samplesPerPixel);
+    const int bounces = std::max(0, resolved.maxBounces);
+    const double hits = samples * std::clamp(coverage, 0.0, 1.0);
+
+    auto toCount = [](double v) { return static_cast<uint64_t>(std::llround(std::max(0.0, v))); };
+    p.samples = samples;
+    p.rays.n[static_cast<int>(RayKind::Primary)] = toCount(samples);
+    p.rays.n[static_cast<int>(RayKind::Reflection)] =
+        toCount(bounces > 0 ? hits * geometricSum(reflectionHitRate, bounces - 1) : 0.0);
+    p.rays.n[static_cast<int>(RayKind::Shadow)] =
+        toCount(hits * geometricSum(reflectionHitRate, bounces) * shadowRaysPerShade(resolved)
+                * shadowRaysPerHit);
+    p.rays.n[static_cast<int>(RayKind::AO)] =
+        toCount(resolved.aoEnabled ? hits * std::max(0, resolved.aoSamples) * aoRaysPerHit : 0.0);
+
+    p.workSeconds = secondsPerRay * static_cast<double>(p.rays.total()) + secondsPerSample * samples;
+
+    int tiles = regionTileCount(region, resolved.tileSize);
+    int threads = std::max(1, std::min(resolved.threadCount, tiles));
+    p.wallSeconds = p.workSeconds / (threads * std::max(0.05, parallelEfficiency));
+    return p;
+}
+
+// ── Calibration ─────────────────────────────────────────────────────────────
+
+namespace {
+
+struct CalibrationRun {
+    RayTracer::Config config;
+    RenderStats stats;
+    double samples = 0.0;
+};
+
+// Least squares through the origin for y ≈ a * x1 + b * x2, a, b >= 0
+void fitNonNegative(const std::vector<double>& x1, const std::vector<double>& x2,
+                    const std::vector<double>& y, double& a, double& b) {
+    double s11 = 0, s12 = 0, s22 = 0, s1y = 0, s2y = 0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        s11 += x1[i] * x1[i];
+        s12 += x1[i] * x2[i];
+        s22 += x2[i] * x2[i];
+        s1y += x1[i] * y[i];
+        s2y += x2[i] * y[i];
+    }
+    double det = s11 * s22 - s12 * s12;
+    if (std::fabs(det) > 1e-12 * s11 * s22) {
+        a = (s1y * s22 - s2y * s12) / det;
+        b = (s2y * s11 - s1y * s12) / det;
+        if (a >= 0.0 && b >= 0.0) return;
+    }
+    // One coefficient would go negative: fit the other alone
+    double onlyA = s11 > 0.0 ? s1y / s11 : 0.0;
+    double onlyB = s22 > 0.0 ? s2y / s22 : 0.0;
+    double errA = 0.0, errB = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        errA += std::pow(y[i] - onlyA * x1[i], 2);
+        errB += std::pow(y[i] - onlyB * x2[i], 2);
+    }
+    if (errA <= errB) { a = std::max(0.0, onlyA); b = 0.0; }
+    else              { a = 0.0; b = std::max(0.0, onlyB); }
+}
+
+// Least squares through the origin for y ≈ k * x
+double fitScale(const std::vector<double>& x, const std::vector<double>& y, double fallback) {
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+    }
+    return sxx > 0.0 ? sxy / sxx : fallback;
+}
+
+}  // namespace
+
+Result<CostModel, std::string> CostModel::calibrate(const Scene& scene,
+                                                    const RayTracer::Config& config,
+                                                    int maxPixels) {
+    using R = Result<CostModel, std::string>;
+    if (config.width <= 0 || config.height <= 0) return R::err("Empty frame");
+
+    // Same framing, fewer pixels
+    RayTracer::Config base = config;
+    double scale = std::min(1.0, std::sqrt(static_cast<double>(maxPixels) / (static_cast<double>(config.width) * config.height)));
+    base.width = std::max(8, static_cast<int>(config.width * scale));
+    base.height = std::max(8, static_cast<int>(config.height * scale));
+    base.regionX = base.regionY = base.regionWidth = base.regionHeight = 0;
+    base.sampleOffset = 0;
+    base.tileSize = 0;
+    base = Autotuner::resolve(base);
+
+    // Each run isolates one term of the ray model; the last mixes them
+    auto variant = [&](bool soft, int shadowSamples, bool ao, int aoSamples, int bounces, int spp) {
+        RayTracer::Config c = base;
+        c.softShadows = soft;
+        c.shadowSamples = shadowSamples;
+        c.aoEnabled = ao;
+        c.aoSamples = aoSamples;
+        c.maxBounces = bounces;
+        c.samplesPerPixel = spp;
+        return c;
+    };
+    std::vector<CalibrationRun> runs;
+    for (const RayTracer::Config& c : {
+             variant(false, 1, false, 0, 0, 1),
+             variant(true, 8, false, 0, 0, 1),
+             variant(false, 1, true, 8, 0, 1),
+             variant(false, 1, false, 0, 2, 1),
+             variant(true, 4, true, 4, 1, 2)}) {
+        CalibrationRun run;
+        run.config = c;
+        run.samples = static_cast<double>(c.width) * c.height * c.samplesPerPixel;
+        // Fastest of two: noise only ever adds time
+        for (int k = 0; k < 2; ++k) {
+            TileRenderer::render(scene, c);
+            const RenderStats& s = TileRenderer::lastStats();
+            if (k == 0 || s.traceSeconds < run.stats.traceSeconds) run.stats = s;
+        }
+        runs.push_back(run);
+    }
+
+    if (runs.front().stats.counters.rays.total() == 0) {
+        return R::err("Calibration needs the work counters (built with MCSKIN_RENDER_STATS=0)");
+    }
+
+    CostModel model;
+
+    // Coverage and reflection hit rate from the trace depth histogram of
+    // the run with two bounces: depth d+1 is traced once per hit at depth d
+    const auto& depth = runs[3].stats.counters.traceDepth;
+    double coverage = depth[0] > 0 ? static_cast<double>(depth[1]) / depth[0] : 0.0;
+    model.reflectionHitRate = depth[1] > 0 ? static_cast<double>(depth[2]) / depth[1] : 0.0;
+
+    std::vector<double> shadowX, shadowY, aoX, aoY, rays, samples, work;
+    double efficiency = 0.0;
+    for (const CalibrationRun& run : runs) {
+        const RayTracer::Config& c = run.config;
+        const WorkCounters& w = run.stats.counters;
+        double hits = run.samples * coverage;
+        shadowX.push_back(hits * geometricSum(model.reflectionHitRate, c.maxBounces) * shadowRaysPerShade(c));
+        shadowY.push_back(static_cast<double>(w.rays[RayKind::Shadow]));
+        aoX.push_back(c.aoEnabled ? hits * c.aoSamples : 0.0);
+        aoY.push_back(static_cast<double>(w.rays[RayKind::AO]));
+        rays.push_back(static_cast<double>(w.rays.total()));
+        samples.push_back(run.samples);
+        work.push_back(run.stats.traceSeconds);
+        if (run.stats.totalSeconds > 0.0 && run.stats.threads > 0) {
+            efficiency += run.stats.traceSeconds / (run.stats.totalSeconds * run.stats.threads);
+        }
+    }
+    model.shadowRaysPerHit = fitScale(shadowX, shadowY, 1.0);
+    model.aoRaysPerHit = fitScale(aoX, aoY, 1.0);
+    fitNonNegative(rays, samples, work, model.secondsPerRay, model.secondsPerSample);
+    model.parallelEfficiency = std::clamp(efficiency / runs.size(), 0.05, 1.0);
+    model.calibrated = true;
+    return R::ok(model);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include "raytracer/raytracer.h"
+#include "raytracer/render_stats.h"
+#include "scene/scene.h"
+#include "skin/skin_parser.h"
+
+// 渲染耗时预测模型
+//
+// Predicts the rays and the wall time of a TileRenderer::render() call from
+// its Config and the fraction of the frame the character covers.
+//
+// Ray model, per pixel sample (coverage c, reflection hit rate h, B bounces,
+// S shadow rays per shaded hit, A AO rays per primary hit):
+//   primary     1
+//   reflection  c * (1 + h + ... + h^(B-1))
+//   shadow      c * (1 + h + ... + h^B) * S * shadowRaysPerHit
+//   AO          c * A * aoRaysPerHit
+// Time model: work = secondsPerRay * rays + secondsPerSample * samples,
+// summed over workers; wall = work / (threads * parallelEfficiency).
+//
+// calibrate() fits h, the per-hit factors and the time coefficients from
+// the work counters of a few small renders of the actual scene, so it
+// needs MCSKIN_RENDER_STATS. An uncalibrated model has rough defaults.
+
+struct CostPrediction {
+    RayCounts rays;
+    double samples = 0.0;           // pixel samples
+    double workSeconds = 0.0;       // summed over workers
+    double wallSeconds = 0.0;
+};
+
+class CostModel {
+public:
+    double reflectionHitRate = 0.1;
+    double shadowRaysPerHit = 1.0;
+    double aoRaysPerHit = 1.0;
+    double secondsPerRay = 5e-7;
+    double secondsPerSample = 5e-7;
+    double parallelEfficiency = 0.9;
+    bool calibrated = false;
+
+    // Fraction of primary rays through a grid x grid lattice over the render
+    // region that hit the scene
+    static double estimateCoverage(const Scene& scene, const RayTracer::Config& config,
+                                   int grid = 32);
+
+    CostPrediction predict(const RayTracer::Config& config, double coverage) const;
+
+    // Fit on renders of `scene` at a reduced size of `config`'s frame
+    // (same camera framing, at most maxPixels pixels)
+    static Result<CostModel, std::string> calibrate(const Scene& scene,
+                                                    const RayTracer::Config& config,
+                                                    int maxPixels = 128 * 128);
+};
@@ -1,4 +1,5 @@
 #include "raytracer/intersection.h"
+#include "raytracer/render_stats.h"
 #include "skin/texture_region.h"
 #include <cmath>
 #include <limits>
@@ -203,6 +204,7 @@ static HitResult intersectAABB(const Ray& ray, const Mesh& mesh,
     result.hit = false;
 
     if (tris.empty()) return result;
+    countBoxTest();
 
     Vec3 boxMin, boxMax;
     computeAABB(tris, boxMin, boxMax);
@@ -300,6 +302,7 @@ static HitResult intersectAABB(const Ray& ray, const Mesh& mesh,
     // Sample texture
     Color texColor;
     if (face.texture) {
+        countTextureSample();
         texColor = face.texture->sample(u, v);
     } else {
         texColor = Color(1, 0, 1, 1); // Magenta for missing texture (debug)
@@ -310,11 +313,13 @@ static HitResult intersectAABB(const Ray& ray, const Mesh& mesh,
     // the far side of the box is still visible (no backface culling).
     if (texColor.a == 0.0f) {
         if (!mesh.isOuterLayer) {
+            countTransparentMiss();
             return result; // inner layer: miss
         }
 
         // Outer layer: try the exit (back) face
         if (tmax > tHit) {
+            countBackFaceFallback();
             // Recalculate exit face axis/side
             float tmaxRecalc2 = std::numeric_limits<float>::max();
             int exitAxis2 = 0;
@@ -341,6 +346,7 @@ static HitResult intersectAABB(const Ray& ray, const Mesh& mesh,
 
             Color backTexColor;
             if (backFace.texture) {
+                countTextureSample();
                 backTexColor = backFace.texture->sample(bu, bv);
             } else {
                 backTexColor = Color(1, 0, 1, 1);
@@ -357,6 +363,7 @@ static HitResult intersectAABB(const Ray& ray, const Mesh& mesh,
                 return result;
             }
         }
+        countTransparentMiss();
         return result; // both faces transparent
     }
 
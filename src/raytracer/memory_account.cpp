@@ -0,0 +1,163 @@
+#include "raytracer/memory_account.h"
+#include <algorithm>
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::Framebuffer: return "framebuffer";
+    case MemoryCategory::Textures:    return "textures";
+    case MemoryCategory::Scene:       return "scene";
+    case MemoryCategory::Encoder:     return "encoder";
+    case MemoryCategory::Renderer:    return "renderer";
+    case MemoryCategory::Caches:      return "caches";
+    }
+    return "unknown";
+}
+
+uint64_t MemoryUsage::total() const {
+    uint64_t sum = 0;
+    for (uint64_t b : bytes) sum += b;
+    return sum;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& o) {
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; ++i) bytes[i] += o.bytes[i];
+    return *this;
+}
+
+// ── Account ─────────────────────────────────────────────────────────────────
+
+void MemoryAccount::allocate(MemoryCategory category, uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_[category] += bytes;
+        currentTotal_ += bytes;
+        if (currentTotal_ > peakTotal_) {
+            peakTotal_ = currentTotal_;
+            peak_ = current_;
+        }
+    }
+    if (parent_) parent_->allocate(category, bytes);
+}
+
+void MemoryAccount::release(MemoryCategory category, uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t& c = current_[category];
+        bytes = std::min(bytes, c);
+        c -= bytes;
+        currentTotal_ -= bytes;
+    }
+    if (parent_) parent_->release(category, bytes);
+}
+
+MemoryUsage MemoryAccount::current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+uint64_t MemoryAccount::currentTotal() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return currentTotal_;
+}
+
+MemoryUsage MemoryAccount::peak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+uint64_t MemoryAccount::peakTotal() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peakTotal_;
+}
+
+// ── Charge ──────────────────────────────────────────────────────────────────
+
+MemoryCharge::MemoryCharge(MemoryAccount* account, MemoryCategory category, uint64_t bytes)
+    : account_(account), category_(category), bytes_(bytes)
+{
+    if (account_) account_->allocate(category_, bytes_);
+}
+
+MemoryCharge::MemoryCharge(MemoryCharge&& other) noexcept
+    : account_(other.account_), category_(other.category_), bytes_(other.bytes_)
+{
+    other.account_ = nullptr;
+    other.bytes_ = 0;
+}
+
+MemoryCharge& MemoryCharge::operator=(MemoryCharge&& other) noexcept {
+    if (this != &other) {
+        reset();
+        account_ = other.account_;
+        category_ = other.category_;
+        bytes_ = other.bytes_;
+        other.account_ = nullptr;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+void MemoryCharge::update(uint64_t bytes) {
+    if (!account_ || bytes == bytes_) return;
+    if (bytes > bytes_) {
+        account_->allocate(category_, bytes - bytes_);
+    } else {
+        account_->release(category_, bytes_ - bytes);
+    }
+    bytes_ = bytes;
+}
+
+void MemoryCharge::reset() {
+    if (account_) account_->release(category_, bytes_);
+    account_ = nullptr;
+    bytes_ = 0;
+}
+
+// ── Footprint ───────────────────────────────────────────────────────────────
+
+MemoryUsage MemoryFootprint::scene(const Scene& scene) {
+    MemoryUsage usage;
+    usage[MemoryCategory::Scene] = sizeof(Scene) + of(scene.meshes);
+    for (const Mesh& mesh : scene.meshes) {
+        usage[MemoryCategory::Scene] += of(mesh.triangles) + of(mesh.localTriangles);
+        for (const TextureRegion& tex : mesh.ownedTextures) {
+            usage[MemoryCategory::Textures] += of(tex.pixels);
+        }
+    }
+    return usage;
+}
+
+// ── Estimate ────────────────────────────────────────────────────────────────
+
+MemoryUsage MemoryEstimate::scene(const Scene& scene) {
+    MemoryUsage usage;
+    usage[MemoryCategory::Scene] = sizeof(Scene) + scene.meshes.size() * sizeof(Mesh);
+    for (const Mesh& mesh : scene.meshes) {
+        usage[MemoryCategory::Scene] += (mesh.triangles.size() + mesh.localTriangles.size())
+                                        * sizeof(Triangle);
+        for (const TextureRegion& tex : mesh.ownedTextures) {
+            usage[MemoryCategory::Textures] += tex.pixels.size() * sizeof(Color);
+        }
+    }
+    return usage;
+}
+
+uint64_t MemoryEstimate::framebuffer(const RayTracer::Config& config) {
+    return static_cast<uint64_t>(std::max(0, config.width)) * std::max(0, config.height) * sizeof(Color);
+}
+
+uint64_t MemoryEstimate::encoder(int width, int height) {
+    uint64_t w = static_cast<uint64_t>(std::max(0, width));
+    uint64_t h = static_cast<uint64_t>(std::max(0, height));
+    uint64_t rgba = w * h * 4;
+    uint64_t filtered = (w * 4 + 1) * h;    // one filter-type byte per scanline
+    uint64_t hashTable = 16384 * sizeof(void*);
+    return rgba + 2 * filtered + hashTable;
+}
+
+MemoryUsage MemoryEstimate::job(const Scene& s, const RayTracer::Config& config) {
+    MemoryUsage usage = scene(s);
+    usage[MemoryCategory::Framebuffer] = framebuffer(config);
+    usage[MemoryCategory::Encoder] = encoder(config.width, config.height);
+    return usage;
+}
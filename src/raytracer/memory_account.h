@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "raytracer/raytracer.h"
+#include "scene/scene.h"
+#include "skin/image.h"
+
+// 内存记账
+//
+// Byte accounting of the large buffers a render job owns, by category.
+// Charges are explicit (MemoryCharge) and made by the owner of a buffer
+// right where it allocates it, with the bytes the buffer actually holds
+// (MemoryFootprint: vector capacities), not a global allocator hook, so
+// the numbers are per job and cost nothing per ray. Allocations made
+// inside third-party code (stb_image_write's scratch) are not seen. An
+// account may have a parent (e.g. the export queue): every charge is
+// mirrored there, so the parent sees the sum over its jobs and its own
+// peak.
+//
+// MemoryEstimate predicts the same categories from a scene and a config
+// before anything is allocated, for admission against a memory budget.
+
+enum class MemoryCategory {
+    Framebuffer,    // float RGBA output image
+    Textures,       // face texels of a scene copy
+    Scene,          // meshes and triangles of a scene copy
+    Encoder,        // PNG staging and output buffers
+    Renderer,       // tile lists, schedule, cost estimates, sample sums
+    Caches,         // results kept after the job (e.g. for region re-render)
+};
+static constexpr int MEMORY_CATEGORY_COUNT = 6;
+
+const char* memoryCategoryName(MemoryCategory category);
+
+struct MemoryUsage {
+    std::array<uint64_t, MEMORY_CATEGORY_COUNT> bytes{};
+
+    uint64_t operator[](MemoryCategory c) const { return bytes[static_cast<int>(c)]; }
+    uint64_t& operator[](MemoryCategory c) { return bytes[static_cast<int>(c)]; }
+    uint64_t total() const;
+
+    MemoryUsage& operator+=(const MemoryUsage& o);
+};
+
+class MemoryAccount {
+public:
+    explicit MemoryAccount(MemoryAccount* parent = nullptr) : parent_(parent) {}
+
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    void allocate(MemoryCategory category, uint64_t bytes);
+    void release(MemoryCategory category, uint64_t bytes);
+
+    MemoryUsage current() const;
+    uint64_t currentTotal() const;
+
+    // Usage at the moment the total was highest (not the sum of
+    // per-category maxima, which may never have coexisted)
+    MemoryUsage peak() const;
+    uint64_t peakTotal() const;
+
+private:
+    MemoryAccount* parent_;
+    mutable std::mutex mutex_;
+    MemoryUsage current_;
+    MemoryUsage peak_;
+    uint64_t currentTotal_ = 0;
+    uint64_t peakTotal_ = 0;
+};
+
+// RAII charge against an account; a null account makes it a no-op
+class MemoryCharge {
+public:
+    MemoryCharge() = default;
+    MemoryCharge(MemoryAccount* account, MemoryCategory category, uint64_t bytes);
+    ~MemoryCharge() { reset(); }
+
+    MemoryCharge(MemoryCharge&& other) noexcept;
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept;
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    // Follow a buffer that grew or shrank: charge `bytes` from now on
+    void update(uint64_t bytes);
+
+    // Release now instead of at the end of the scope
+    void reset();
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    MemoryAccount* account_ = nullptr;
+    MemoryCategory category_ = MemoryCategory::Framebuffer;
+    uint64_t bytes_ = 0;
+};
+
+// Heap bytes existing buffers hold right now: what charges are made of
+class MemoryFootprint {
+public:
+    // Scene = meshes and triangles, Textures = owned face texels
+    static MemoryUsage scene(const Scene& scene);
+    static uint64_t image(const Image& image) { return of(image.pixels); }
+
+    template <typename T>
+    static uint64_t of(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+};
+
+class MemoryEstimate {
+public:
+    // Heap bytes of a copy of the scene (a copy holds no spare capacity)
+    static MemoryUsage scene(const Scene& scene);
+
+    // Float RGBA output of TileRenderer::render()
+    static uint64_t framebuffer(const RayTracer::Config& config);
+
+    // ImageWriter::writePNG(): RGBA8 staging buffer plus stb's filtered
+    // scanlines, deflate hash table and output (bounded by the filtered size)
+    static uint64_t encoder(int width, int height);
+
+    // Peak of an export job: its scene snapshot, the framebuffer and the
+    // encoder, which are all alive while the PNG is written
+    static MemoryUsage job(const Scene& scene, const RayTracer::Config& config);
+};
@@ -0,0 +1,176 @@
+#include "raytracer/progressive_renderer.h"
+#include "diagnostics/profiler.h"
+#include <algorithm>
+#include <chrono>
+
+// Nearest-neighbour upscale of the coarse pass to `region` of the full
+// width × height frame
+static Image upscale(const Image& src, int width, int height, const Tile& region) {
+    Image out(region.width, region.height);
+    if (src.width <= 0 || src.height <= 0) return out;
+    for (int y = 0; y < region.height; ++y) {
+        int sy = std::min(src.height - 1, (region.y + y) * src.height / height);
+        for (int x = 0; x < region.width; ++x) {
+            int sx = std::min(src.width - 1, (region.x + x) * src.width / width);
+            out.pixels[y * region.width + x] = src.pixels[sy * src.width + sx];
+        }
+    }
+    return out;
+}
+
+ProgressiveRenderer::ProgressiveRenderer(FrameCallback onFrame)
+    : onFrame_(std::move(onFrame))
+{
+    pool_.setMemoryAccount(&memory_);
+    thread_ = std::thread([this]() { run(); });
+}
+
+ProgressiveRenderer::~ProgressiveRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+        generation_.fetch_add(1);
+        pending_.reset();
+        if (active_) active_->cancel.store(true);
+    }
+    wakeCv_.notify_all();
+    thread_.join();
+}
+
+uint64_t ProgressiveRenderer::restart(const Scene& scene, const RayTracer::Config& config,
+                                      const ProgressiveOptions& options) {
+    uint64_t gen;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        gen = generation_.fetch_add(1) + 1;
+        pending_ = Job{scene, config, options, gen};
+        if (active_) active_->cancel.store(true);
+    }
+    wakeCv_.notify_all();
+    return gen;
+}
+
+void ProgressiveRenderer::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_.fetch_add(1);
+    pending_.reset();
+    if (active_) active_->cancel.store(true);
+}
+
+bool ProgressiveRenderer::isIdle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !busy_ && !pending_;
+}
+
+bool ProgressiveRenderer::waitIdle(int timeoutMs) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idleCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this]() { return !busy_ && !pending_; });
+}
+
+// ── Worker thread ───────────────────────────────────────────────────────────
+
+void ProgressiveRenderer::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCv_.wait(lock, [this]() { return quit_ || pending_.has_value(); });
+            if (quit_) return;
+            job = std::move(*pending_);
+            pending_.reset();
+            busy_ = true;
+        }
+
+        renderJob(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+        }
+        idleCv_.notify_all();
+    }
+}
+
+void ProgressiveRenderer::renderJob(const Job& job) {
+    RenderControl control;
+    auto stale = [&]() { return generation_.load() != job.generation; };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stale() || quit_) return;
+        active_ = &control;
+    }
+    struct Detach {
+        ProgressiveRenderer* self;
+        ~Detach() {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            self->active_ = nullptr;
+        }
+    } detach{this};
+
+    const int width = std::max(1, job.config.width);
+    const int height = std::max(1, job.config.height);
+    RayTracer::Config frameConfig = job.config;
+    frameConfig.width = width;
+    frameConfig.height = height;
+    const Tile region = TileRenderer::renderRegion(frameConfig);
+    if (region.width <= 0 || region.height <= 0) return;
+
+    // Passes trace only the region's tiles into one framebuffer; frames
+    // and sums cover the region alone
+    Image framebuffer;
+    // renderInto() sizes the framebuffer to each pass; the charge follows
+    MemoryCharge framebufferCharge(&memory_, MemoryCategory::Framebuffer, 0);
+
+    // Coarse pass: cheap enough to keep up with camera drags
+    const int div = std::max(1, job.options.lowResDivisor);
+    if (div > 1) {
+        RayTracer::Config low = job.config;
+        low.width = std::max(1, (width + div - 1) / div);
+        low.height = std::max(1, (height + div - 1) / div);
+        low.samplesPerPixel = 1;
+        low.sampleOffset = 0;
+        if (low.regionWidth > 0 && low.regionHeight > 0) {
+            low.regionX = job.config.regionX / div;
+            low.regionY = job.config.regionY / div;
+            low.regionWidth = (job.config.regionX + job.config.regionWidth + div - 1) / div - low.regionX;
+            low.regionHeight = (job.config.regionY + job.config.regionHeight + div - 1) / div - low.regionY;
+        }
+        {
+            ProfileZone zone("coarse pass", "stage");
+            TileRenderer::renderInto(job.scene, low, framebuffer, pool_, nullptr, &control);
+        }
+        framebufferCharge.update(MemoryFootprint::image(framebuffer));
+        if (stale()) return;
+        onFrame_(upscale(framebuffer, width, height, region), 0, job.generation);
+    }
+
+    // Refinement: one new sample per pixel per pass, averaged
+    std::vector<Color> sum(static_cast<size_t>(region.width) * region.height,
+                           Color(0.0f, 0.0f, 0.0f, 0.0f));
+    Image frame(region.width, region.height);
+    MemoryCharge frameCharge(&memory_, MemoryCategory::Framebuffer,
+                             MemoryFootprint::of(sum) + MemoryFootprint::image(frame));
+    const int maxSamples = std::max(1, job.options.maxSamples);
+
+    for (int k = 0; k < maxSamples; ++k) {
+        ProfileZone zone("refine pass", "stage", k + 1);
+        RayTracer::Config pass = frameConfig;
+        pass.samplesPerPixel = 1;
+        pass.sampleOffset = k;
+        TileRenderer::renderInto(job.scene, pass, framebuffer, pool_, nullptr, &control);
+        framebufferCharge.update(MemoryFootprint::image(framebuffer));
+        if (stale()) return;
+
+        float inv = 1.0f / static_cast<float>(k + 1);
+        for (int y = 0; y < region.height; ++y) {
+            const Color* src = &framebuffer.pixels[static_cast<size_t>(region.y + y) * width + region.x];
+            size_t row = static_cast<size_t>(y) * region.width;
+            for (int x = 0; x < region.width; ++x) {
+                sum[row + x] += src[x];
+                frame.pixels[row + x] = sum[row + x] * inv;
+            }
+        }
+        onFrame_(frame, k + 1, job.generation);
+    }
+}
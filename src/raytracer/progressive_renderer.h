@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "skin/image.h"
+#include "scene/scene.h"
+#include "raytracer/memory_account.h"
+#include "raytracer/raytracer.h"
+#include "raytracer/render_pool.h"
+#include "raytracer/tile_renderer.h"
+
+// 渐进式光追预览
+//
+// Renders on a background thread of its own. It first renders a coarse pass
+// at 1/lowResDivisor resolution, then refines with one sample per pixel per
+// pass (via Config::sampleOffset) until maxSamples is reached. Each restart()
+// cancels the pass in flight and begins a new generation, so a moving camera
+// only ever gets coarse frames and an idle one converges. With a render
+// region set in the config, only the region is traced and delivered. All
+// jobs share one RenderPool, so its worker threads, tile list and cost
+// estimates carry over from one restart() to the next. The buffers of the
+// job in flight (framebuffer, running sums, frame) and the pool's storage
+// are charged to memory().
+
+struct ProgressiveOptions {
+    int lowResDivisor = 4;   // coarse first pass (1 = skip it)
+    int maxSamples = 16;     // stop refining after this many samples per pixel
+};
+
+class ProgressiveRenderer {
+public:
+    // Called on the render thread with the current frame (full resolution
+    // of TileRenderer::renderRegion(config): the whole frame, or just the
+    // config's region), the samples accumulated per pixel (0 = upscaled
+    // coarse pass) and the generation the frame belongs to. Frames of an
+    // older generation than generation() may still arrive and should be
+    // dropped by the receiver.
+    using FrameCallback = std::function<void(const Image& frame, int samples, uint64_t generation)>;
+
+    explicit ProgressiveRenderer(FrameCallback onFrame);
+    ~ProgressiveRenderer();
+
+    ProgressiveRenderer(const ProgressiveRenderer&) = delete;
+    ProgressiveRenderer& operator=(const ProgressiveRenderer&) = delete;
+
+    // Start over with a new scene and config. The scene is copied, so the
+    // caller may modify its own copy immediately. Returns the new generation.
+    uint64_t restart(const Scene& scene, const RayTracer::Config& config,
+                     const ProgressiveOptions& options = ProgressiveOptions());
+
+    // Cancel the current job; the worker thread goes idle
+    void stop();
+
+    uint64_t generation() const { return generation_.load(); }
+
+    // True when nothing is queued or rendering
+    bool isIdle() const;
+
+    // Block until idle or until timeoutMs elapses; returns isIdle()
+    bool waitIdle(int timeoutMs) const;
+
+    // Accounted memory of the job in flight and of the render pool
+    const MemoryAccount& memory() const { return memory_; }
+
+private:
+    struct Job {
+        Scene scene;
+        RayTracer::Config config;
+        ProgressiveOptions options;
+        uint64_t generation = 0;
+    };
+
+    void run();
+    void renderJob(const Job& job);
+
+    FrameCallback onFrame_;
+    MemoryAccount memory_;
+    RenderPool pool_;                   // render thread only; charged to memory_
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    mutable std::condition_variable idleCv_;
+    std::optional<Job> pending_;
+    RenderControl* active_ = nullptr;   // control of the pass in flight
+    bool busy_ = false;
+    bool quit_ = false;
+    std::atomic<uint64_t> generation_{0};
+
+    std::thread thread_;
+};
@@ -0,0 +1,112 @@
+#include "raytracer/quality_policy.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Nearest and farthest depth along the view axis of the vertices that
+// project into the frame; geometry behind the camera or outside the view
+// frustum does not set the texel size. No vertex on screen (empty scene,
+// or a close-up between the vertices) leaves the config unchanged.
+bool depthRange(const Scene& scene, const RayTracer::Config& config,
+                float& nearest, float& farthest) {
+    const Camera& cam = scene.camera;
+    const Vec3 forward = (cam.target - cam.position).normalize();
+    const Vec3 right = forward.cross(cam.up).normalize();
+    const Vec3 trueUp = right.cross(forward);
+    const float halfH = std::tan(cam.fov * 0.5f * static_cast<float>(M_PI) / 180.0f);
+    const float halfW = halfH * static_cast<float>(config.width) / static_cast<float>(config.height);
+    nearest = std::numeric_limits<float>::max();
+    farthest = 0.0f;
+    for (const Mesh& mesh : scene.meshes) {
+        for (const Triangle& t : mesh.triangles) {
+            for (const Vec3* v : {&t.v0, &t.v1, &t.v2}) {
+                const Vec3 d = *v - cam.position;
+                float z = d.dot(forward);
+                if (z <= 1e-3f) continue;
+                if (std::fabs(d.dot(right)) > z * halfW || std::fabs(d.dot(trueUp)) > z * halfH) continue;
+                nearest = std::min(nearest, z);
+                farthest = std::max(farthest, z);
+            }
+        }
+    }
+    return farthest > 0.0f;
+}
+
+// Pixels per scene unit at depth z
+float pixelsPerUnit(const Scene& scene, const RayTracer::Config& config, float z) {
+    float halfH = std::tan(scene.camera.fov * 0.5f * static_cast<float>(M_PI) / 180.0f);
+    return static_cast<float>(config.height) / (2.0f * z * halfH);
+}
+
+int scaledSamples(int samples, float t, int minimum) {
+    if (samples <= minimum) return samples;
+    return std::max(minimum, static_cast<int>(std::ceil(samples * t)));
+}
+
+}  // namespace
+
+float QualityPolicy::texelPixels(const Scene& scene, const RayTracer::Config& config) {
+    float nearest, farthest;
+    if (config.width <= 0 || config.height <= 0 || !depthRange(scene, config, nearest, farthest)) {
+        return 0.0f;
+    }
+    return pixelsPerUnit(scene, config, nearest);
+}
+
+float QualityPolicy::dofBlurPixels(const Scene& scene, const RayTracer::Config& config) {
+    float nearest, farthest;
+    if (!config.dofEnabled || config.aperture <= 1e-6f || config.width <= 0 || config.height <= 0
+        || !depthRange(scene, config, nearest, farthest)) {
+        return 0.0f;
+    }
+    float focus = config.focusDistance > 0.0f
+                ? config.focusDistance
+                : (scene.camera.target - scene.camera.position).length();
+    // Thin lens: a point at depth z spreads over a disc of radius
+    // aperture * |z - focus| / z on the focus plane
+    float spread = 0.0f;
+    for (float z : {nearest, farthest}) {
+        spread = std::max(spread, config.aperture * std::fabs(z - focus) / z);
+    }
+    return 2.0f * spread * pixelsPerUnit(scene, config, focus);
+}
+
+RayTracer::Config QualityPolicy::apply(const Scene& scene, const RayTracer::Config& config,
+                                       QualityReport* report) const {
+    RayTracer::Config out = config;
+    const float texel = texelPixels(scene, config);
+
+    if (texel > 0.0f && texel < fullDetailTexelPixels) {
+        // A pixel covers 1/t² of a full-detail texel's area, and averages
+        // the samples of the texels it spans
+        const float t = (texel / fullDetailTexelPixels) * (texel / fullDetailTexelPixels);
+        out.shadowSamples = scaledSamples(config.shadowSamples, t, minShadowSamples);
+        out.aoSamples = scaledSamples(config.aoSamples, t, minAoSamples);
+        int cap = texel < singleBounceTexelPixels ? 1 : reducedMaxBounces;
+        out.maxBounces = std::min(config.maxBounces, std::max(0, cap));
+        if (out.dofEnabled && dofBlurPixels(scene, config) < minDofBlurPixels) {
+            out.dofEnabled = false;
+        }
+    }
+
+    if (report) {
+        report->applied = true;
+        report->texelPixels = texel;
+        report->shadowSamples = out.shadowSamples;
+        report->aoSamples = out.aoSamples;
+        report->maxBounces = out.maxBounces;
+        report->dofEnabled = out.dofEnabled;
+    }
+    return out;
+}
+
+RayTracer::Config QualityPolicy::resolve(const Scene& scene, const RayTracer::Config& config,
+                                         QualityReport* report) {
+    return config.autoQuality ? QualityPolicy(config.quality).apply(scene, config, report) : config;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "raytracer/raytracer.h"
+#include "raytracer/render_stats.h"
+#include "scene/scene.h"
+
+// 按分辨率自动降低效果质量
+//
+// At a 64² or 128² output one skin texel covers a pixel or two: soft shadow
+// penumbrae and AO gradients are narrower than a pixel, deep reflections
+// are a handful of pixels, and the depth-of-field blur circle can be
+// smaller than a pixel. The policy measures the on-screen size of a texel
+// (one scene unit) at the nearest geometry and, below fullDetailTexelPixels,
+// scales the shadow and AO samples with the texel's pixel area, caps the
+// bounces and turns DOF off when its largest blur circle stays under
+// minDofBlurPixels.
+//
+// TileRenderer::render() applies the policy of config.quality to configs
+// with autoQuality set (resolve()); what it chose is reported in
+// RenderStats::quality. The thresholds are part of the config, so the
+// effects follow from the config alone.
+
+struct QualityPolicy : QualityThresholds {
+    QualityPolicy() = default;
+    explicit QualityPolicy(const QualityThresholds& thresholds) : QualityThresholds(thresholds) {}
+
+    // Pixels per skin texel at the nearest on-screen vertex; 0 when no
+    // vertex projects into the frame
+    static float texelPixels(const Scene& scene, const RayTracer::Config& config);
+
+    // Largest depth-of-field blur circle over the scene's depth range, in
+    // pixels (0 without DOF)
+    static float dofBlurPixels(const Scene& scene, const RayTracer::Config& config);
+
+    RayTracer::Config apply(const Scene& scene, const RayTracer::Config& config,
+                            QualityReport* report = nullptr) const;
+
+    // Config as TileRenderer::render() traces it: the policy of
+    // config.quality applied if config.autoQuality is set, otherwise config
+    // unchanged
+    static RayTracer::Config resolve(const Scene& scene, const RayTracer::Config& config,
+                                     QualityReport* report = nullptr);
+};
@@ -1,5 +1,6 @@
 #include "raytracer/raytracer.h"
 #include "raytracer/intersection.h"
+#include "raytracer/render_stats.h"
 #include <cmath>
 #include <algorithm>
 #include <random>
@@ -68,6 +69,7 @@ float RayTracer::computeAO(const Vec3& point, const Vec3& normal,
         worldDir = worldDir.normalize();
 
         Ray aoRay(point + N * 1e-3f, worldDir);
+        countRay(RayKind::AO);
         HitResult hit = intersectScene(aoRay, scene);
         if (hit.hit && hit.t < radius) {
             ++occluded;
@@ -89,18 +91,39 @@ Color RayTracer::traceRay(const Ray& ray, const Scene& scene,
                       : scene.backgroundColor;
     }
 
+    countTraceDepth(depth);
     HitResult hit = intersectScene(ray, scene);
 
     if (!hit.hit) {
         // Primary rays get proper gradient; bounced rays get center color
         if (depth == 0 && config) {
             // u,v not available here — approximate from ray direction
-            // This is a fallback; the tile renderer handles primary bg properly
+            // This is a fallback; tracePrimary() handles primary bg properly
             return backgroundColor(scene, 0.5f, 0.5f, config);
         }
         return scene.backgroundColor;
     }
+    return shadeHit(ray, hit, scene, depth, maxBounces, params, config);
+}
+
+Color RayTracer::tracePrimary(const Ray& ray, const Scene& scene, float u, float v,
+                              const Config& config) {
+    if (config.maxBounces < 0) {
+        // Nothing is shaded; a hit still covers the gradient
+        HitResult hit = intersectScene(ray, scene);
+        return backgroundColor(scene, hit.hit ? 0.5f : u, hit.hit ? 0.5f : v, &config);
+    }
 
+    countTraceDepth(0);
+    HitResult hit = intersectScene(ray, scene);
+    if (!hit.hit) return backgroundColor(scene, u, v, &config);
+    return shadeHit(ray, hit, scene, 0, config.maxBounces, ShadingParams{}, &config);
+}
+
+Color RayTracer::shadeHit(const Ray& ray, const HitResult& hit, const Scene& scene,
+                          int depth, int maxBounces,
+                          const ShadingParams& params,
+                          const Config* config) {
     Vec3 viewDir = (ray.origin - hit.point).normalize();
     Color shadedColor;
 
@@ -138,6 +161,7 @@ Color RayTracer::traceRay(const Ray& ray, const Scene& scene,
 
         Vec3 reflectOrigin = hit.point + N * REFLECT_EPSILON;
         Ray reflectRay(reflectOrigin, reflectDir);
+        countRay(RayKind::Reflection);
 
         Color reflectedColor = traceRay(reflectRay, scene, depth + 1, maxBounces, params, config);
         shadedColor = shadedColor * (1.0f - SKIN_REFLECTIVITY) + reflectedColor * SKIN_REFLECTIVITY;
@@ -4,6 +4,23 @@
 #include "math/color.h"
 #include "scene/scene.h"
 #include "raytracer/shading.h"
+#include "raytracer/traversal.h"
+
+// Order in which TileRenderer hands tiles to its workers (see tile_scheduler.h)
+enum class TileSchedule : int {
+    InOrder = 0,    // tile grid order
+    CostFirst,      // estimated costliest first, tail tiles split
+};
+
+// Thresholds of the automatic quality policy (QualityPolicy)
+struct QualityThresholds {
+    float fullDetailTexelPixels = 4.0f;     // at or above: config unchanged
+    int minShadowSamples = 2;
+    int minAoSamples = 4;                   // fewer leaves visible noise
+    int reducedMaxBounces = 2;              // cap below full detail
+    float singleBounceTexelPixels = 1.5f;   // below: at most one bounce
+    float minDofBlurPixels = 0.5f;          // smaller blur circle: pinhole
+};
 
 class RayTracer {
 public:
@@ -12,8 +29,23 @@ public:
         int height = 256;
         int maxBounces = 3;
         int samplesPerPixel = 1;
-        int tileSize = 32;
-        int threadCount = 0; // 0 = auto
+        int tileSize = 32;   // <= 0 = from the tuning profile (Autotuner::resolve)
+        int threadCount = 0; // 0 = auto (Autotuner::resolve)
+        TileSchedule tileSchedule = TileSchedule::InOrder;
+        Traversal traversal = Traversal::RowMajor;  // tile grid and pixels in a tile
+
+        // Index of the first pixel sample. Progressive passes render
+        // successive sample ranges; a single-sample render at offset 0
+        // shoots through pixel centres, everything else is jittered.
+        int sampleOffset = 0;
+
+        // Render region in pixels. Only the parts of tiles inside it are
+        // traced; the rest of the output is left black. An empty region
+        // (width or height <= 0) means the whole frame.
+        int regionX = 0;
+        int regionY = 0;
+        int regionWidth = 0;
+        int regionHeight = 0;
 
         // Soft shadows (area light)
         bool softShadows = true;
@@ -35,6 +67,11 @@ public:
         float gradientScale = 1.0f;
         Color bgCenter{0.91f, 0.89f, 0.86f, 1.0f};  // warm white
         Color bgEdge{0.56f, 0.63f, 0.71f, 1.0f};     // muted blue
+
+        // Scale effect samples, bounces and DOF to the on-screen texel
+        // size (QualityPolicy); mostly pays off for small outputs
+        bool autoQuality = false;
+        QualityThresholds quality;
     };
 
     // Trace a single ray, returning the color.
@@ -43,6 +80,12 @@ public:
                           const ShadingParams& params = ShadingParams{},
                           const Config* config = nullptr);
 
+    // Trace a camera ray through (u, v) of the frame: traceRay() at depth 0,
+    // with the gradient background at (u, v) on a miss. One scene
+    // intersection for both.
+    static Color tracePrimary(const Ray& ray, const Scene& scene, float u, float v,
+                              const Config& config);
+
     // Compute background color for a ray (gradient or flat).
     static Color backgroundColor(const Scene& scene, float u, float v,
                                  const Config* config);
@@ -52,4 +95,11 @@ public:
     static float computeAO(const Vec3& point, const Vec3& normal,
                            const Scene& scene, int samples, float radius,
                            unsigned int seed);
+
+private:
+    // Shading, AO and reflection of a hit found by the callers above
+    static Color shadeHit(const Ray& ray, const HitResult& hit, const Scene& scene,
+                          int depth, int maxBounces,
+                          const ShadingParams& params,
+                          const Config* config);
 };
@@ -0,0 +1,151 @@
+#include "raytracer/render_pool.h"
+#include "io/hash.h"
+#include <algorithm>
+#include <cstddef>
+
+RenderPool::~RenderPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wakeCv_.notify_all();
+    for (std::thread& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+int RenderPool::threads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(threads_.size());
+}
+
+void RenderPool::setMemoryAccount(MemoryAccount* account) {
+    storageCharge_ = MemoryCharge(account, MemoryCategory::Renderer, 0);
+    chargeStorage();
+}
+
+void RenderPool::chargeStorage() {
+    size_t orders = MemoryFootprint::of(orders_);
+    for (const PixelOrder& o : orders_) orders += MemoryFootprint::of(o.order);
+    storageCharge_.update(MemoryFootprint::of(tiles_) + orders + MemoryFootprint::of(coverage_)
+                          + MemoryFootprint::of(costs_)
+                          + scheduler_.capacityBytes() + MemoryFootprint::of(errors_));
+}
+
+void RenderPool::runTask(int workers, void (*fn)(void*), void* task) {
+    workers = std::max(1, workers);
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Only the first jobs start threads; later ones wake the parked workers
+    while (static_cast<int>(threads_.size()) < workers) {
+        int index = static_cast<int>(threads_.size());
+        threads_.emplace_back([this, index]() { workerLoop(index); });
+    }
+    fn_ = fn;
+    task_ = task;
+    active_ = workers;
+    running_ = workers;
+    ++generation_;
+    wakeCv_.notify_all();
+    doneCv_.wait(lock, [this]() { return running_ == 0; });
+    fn_ = nullptr;
+    task_ = nullptr;
+}
+
+void RenderPool::workerLoop(int index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Threads are started by runTask() with the lock held, before it
+    // publishes the task: a new thread takes part in that task
+    uint64_t seen = generation_ - 1;
+    while (true) {
+        wakeCv_.wait(lock, [&]() { return quit_ || generation_ != seen; });
+        if (quit_) return;
+        seen = generation_;
+        if (index >= active_) continue;
+
+        void (*fn)(void*) = fn_;
+        void* task = task_;
+        lock.unlock();
+        fn(task);
+        lock.lock();
+        if (--running_ == 0) doneCv_.notify_all();
+    }
+}
+
+const std::vector<Tile>& RenderPool::tilesFor(const RayTracer::Config& config) {
+    const Tile region = TileRenderer::renderRegion(config);
+    const bool clipped = config.regionWidth > 0 && config.regionHeight > 0;
+    const int key[8] = {config.width, config.height, config.tileSize,
+                        static_cast<int>(config.traversal),
+                        clipped ? region.x : -1, clipped ? region.y : -1,
+                        clipped ? region.width : -1, clipped ? region.height : -1};
+    if (!std::equal(key, key + 8, tileKey_)) {
+        tiles_ = TileRenderer::generateTiles(config.width, config.height, config.tileSize,
+                                             config.traversal);
+        if (clipped) tiles_ = TileRenderer::clipTiles(tiles_, region);
+        std::copy(key, key + 8, tileKey_);
+        ++tilesVersion_;
+
+        // Every shape the scheduler can hand out, including split pieces,
+        // so the workers never build an order mid-render
+        orders_.clear();
+        if (config.traversal != Traversal::RowMajor) {
+            for (const auto& [w, h] : TileScheduler::shapes(tiles_)) {
+                orders_.push_back({w, h, traversalOrder(w, h, config.traversal)});
+            }
+        }
+    }
+    return tiles_;
+}
+
+const std::vector<std::pair<int, int>>* RenderPool::pixelOrder(int width, int height) const {
+    for (const PixelOrder& o : orders_) {
+        if (o.width == width && o.height == height) return &o.order;
+    }
+    return nullptr;
+}
+
+// What the estimate rays can hit: camera, geometry, poses and texel alpha
+// (transparent texels are misses). Triangle fields up to the texture
+// pointer are plain floats; the pointer itself differs between copies of
+// one scene, so its face index is hashed instead.
+static uint64_t sceneKey(const Scene& scene) {
+    const Camera& cam = scene.camera;
+    uint64_t hash = FNV1A64_OFFSET;
+    for (const Vec3* v : {&cam.position, &cam.target, &cam.up}) {
+        hash = fnv1a64(&v->x, sizeof(float), hash);
+        hash = fnv1a64(&v->y, sizeof(float), hash);
+        hash = fnv1a64(&v->z, sizeof(float), hash);
+    }
+    hash = fnv1a64(&cam.fov, sizeof(cam.fov), hash);
+    for (const Mesh& mesh : scene.meshes) {
+        const float pose[6] = {mesh.hasRotation ? 1.0f : 0.0f, mesh.pivot.x, mesh.pivot.y,
+                               mesh.pivot.z, mesh.rotX, mesh.rotZ};
+        hash = fnv1a64(pose, sizeof(pose), hash);
+        for (const std::vector<Triangle>* list : {&mesh.triangles, &mesh.localTriangles}) {
+            for (const Triangle& t : *list) {
+                hash = fnv1a64(&t, offsetof(Triangle, texture), hash);
+                int face = -1;
+                for (int i = 0; i < 6; ++i) {
+                    if (t.texture == &mesh.ownedTextures[i]) face = i;
+                }
+                hash = fnv1a64(&face, sizeof(face), hash);
+            }
+        }
+        for (const TextureRegion& region : mesh.ownedTextures) {
+            hash = fnv1a64(region.pixels.data(), region.pixels.size() * sizeof(Color), hash);
+        }
+    }
+    return hash;
+}
+
+const std::vector<double>& RenderPool::costsFor(const Scene& scene, const RayTracer::Config& config) {
+    const uint64_t key = sceneKey(scene);
+    if (coverageTiles_ != tilesVersion_ || coverageScene_ != key) {
+        TileScheduler::estimateCoverage(scene, config, tiles_, coverage_);
+        coverageScene_ = key;
+        coverageTiles_ = tilesVersion_;
+    }
+    // The effects only weight the coverage: no rays
+    TileScheduler::costsFromCoverage(config, tiles_, coverage_, costs_);
+    return costs_;
+}
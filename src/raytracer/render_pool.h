@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "raytracer/memory_account.h"
+#include "raytracer/tile_renderer.h"
+#include "raytracer/tile_scheduler.h"
+
+// 渲染对象池
+//
+// What TileRenderer::renderInto() keeps from one job to the next, so that a
+// batch or daemon worker rendering frames of the same size does not touch
+// the heap once it is warm: the worker threads (parked between jobs), the
+// tile list (rebuilt only when the size, tile size, traversal or region
+// change) with the curve-order pixel offsets of every tile and piece shape
+// it can yield, the scheduler queue, the tile cost estimates and the error
+// list. The primary-ray coverage behind the cost estimates is kept too,
+// keyed by the tile list and a hash of the camera and geometry: passes
+// over one view (progressive refinement, checkpoint batches) trace no
+// estimate rays after the first. A pool runs one job at a time; give each concurrent job its own.
+// TileRenderer::render() uses a temporary pool, so its threads end with
+// the call. With an account set, the storage is charged to it as
+// MemoryCategory::Renderer and the charge follows it from job to job.
+
+class RenderPool {
+public:
+    RenderPool() = default;
+    ~RenderPool();      // stops and joins the worker threads
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    // Worker threads started so far (started on first use, kept until the
+    // pool is destroyed)
+    int threads() const;
+
+    // Charge the reused storage to `account` (nullptr = stop charging)
+    void setMemoryAccount(MemoryAccount* account);
+
+private:
+    friend class TileRenderer;
+
+    // Run task() on `workers` pool threads and wait for all of them to
+    // return. The task is called by reference, nothing is copied.
+    template <typename F>
+    void run(int workers, F& task) {
+        runTask(workers, [](void* t) { (*static_cast<F*>(t))(); }, &task);
+    }
+    void runTask(int workers, void (*fn)(void*), void* task);
+    void workerLoop(int index);
+
+    // Tiles of the config's grid and region, cached by their inputs
+    const std::vector<Tile>& tilesFor(const RayTracer::Config& config);
+
+    // Pixel offsets of a width × height tile in the traversal of the last
+    // tilesFor() call; nullptr for row-major or a shape it cannot yield
+    const std::vector<std::pair<int, int>>* pixelOrder(int width, int height) const;
+
+    // Tile cost estimates for the tiles of the last tilesFor() call
+    const std::vector<double>& costsFor(const Scene& scene, const RayTracer::Config& config);
+
+    // Update the storage charge; called once the storage of a job is set up
+    void chargeStorage();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    std::vector<std::thread> threads_;
+    uint64_t generation_ = 0;       // bumped per task
+    int active_ = 0;                // workers taking part in the task
+    int running_ = 0;               // of those, not yet returned
+    void (*fn_)(void*) = nullptr;
+    void* task_ = nullptr;
+    bool quit_ = false;
+
+    // Reused per-job storage
+    std::vector<Tile> tiles_;
+    int tileKey_[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    uint64_t tilesVersion_ = 0;     // bumped when tiles_ is rebuilt
+    struct PixelOrder {
+        int width, height;
+        std::vector<std::pair<int, int>> order;
+    };
+    std::vector<PixelOrder> orders_;
+    std::vector<double> coverage_;
+    uint64_t coverageScene_ = 0;
+    uint64_t coverageTiles_ = 0;    // tilesVersion_ of coverage_, 0 = none
+    std::vector<double> costs_;
+    TileScheduler scheduler_;
+    std::vector<TileRenderer::TileError> errors_;
+    MemoryCharge storageCharge_;
+};
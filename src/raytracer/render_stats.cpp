@@ -0,0 +1,123 @@
+#include "raytracer/render_stats.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+WorkCounters& WorkCounters::operator+=(const WorkCounters& o) {
+    rays += o.rays;
+    boxTests += o.boxTests;
+    textureSamples += o.textureSamples;
+    transparentMisses += o.transparentMisses;
+    backFaceFallbacks += o.backFaceFallbacks;
+    for (int i = 0; i < TRACE_DEPTH_BINS; ++i) traceDepth[i] += o.traceDepth[i];
+    return *this;
+}
+
+WorkCounters WorkCounters::operator-(const WorkCounters& o) const {
+    WorkCounters r;
+    r.rays = rays - o.rays;
+    r.boxTests = boxTests - o.boxTests;
+    r.textureSamples = textureSamples - o.textureSamples;
+    r.transparentMisses = transparentMisses - o.transparentMisses;
+    r.backFaceFallbacks = backFaceFallbacks - o.backFaceFallbacks;
+    for (int i = 0; i < TRACE_DEPTH_BINS; ++i) r.traceDepth[i] = traceDepth[i] - o.traceDepth[i];
+    return r;
+}
+
+// ── Snapshot ────────────────────────────────────────────────────────────────
+
+double RenderStatsSnapshot::mraysPerSecond(RayKind kind) const {
+    if (elapsedSeconds <= 0.0) return 0.0;
+    return static_cast<double>(rays[kind]) / elapsedSeconds / 1e6;
+}
+
+double RenderStatsSnapshot::mraysPerSecond() const {
+    if (elapsedSeconds <= 0.0) return 0.0;
+    return static_cast<double>(rays.total()) / elapsedSeconds / 1e6;
+}
+
+// ── Monitor ─────────────────────────────────────────────────────────────────
+
+void RenderMonitor::begin(int totalTiles, int threadCount, double totalCost) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_ = Clock::now();
+    tilesTotal_ = totalTiles;
+    tilesDone_ = 0;
+    threadCount_ = threadCount;
+    activeThreads_ = 0;
+    tileSecondsSum_ = 0.0;
+    totalCost_ = totalCost;
+    costDone_ = 0.0;
+    rays_ = RayCounts();
+}
+
+void RenderMonitor::tileStarted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++activeThreads_;
+}
+
+void RenderMonitor::tileFinished(double seconds, const RayCounts& rays,
+                                 double cost, bool tileDone) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --activeThreads_;
+    if (tileDone) ++tilesDone_;
+    tileSecondsSum_ += seconds;
+    costDone_ += cost;
+    rays_ += rays;
+}
+
+RenderStatsSnapshot RenderMonitor::snapshot() const {
+    RenderStatsSnapshot s;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start_).count();
+        s.tilesDone = tilesDone_;
+        s.tilesTotal = tilesTotal_;
+        s.threadCount = threadCount_;
+        s.activeThreads = activeThreads_;
+        s.rays = rays_;
+        if (tilesDone_ > 0) {
+            // Remaining tiles at the mean tile cost, spread over the workers
+            s.meanTileSeconds = tileSecondsSum_ / tilesDone_;
+            int workers = std::max(1, std::min(threadCount_, tilesTotal_ - tilesDone_));
+            if (totalCost_ > 0.0 && costDone_ > 0.0) {
+                // Remaining estimated cost at the measured seconds per unit
+                double remaining = std::max(0.0, totalCost_ - costDone_);
+                s.etaSeconds = tileSecondsSum_ * remaining / costDone_ / workers;
+            } else {
+                s.etaSeconds = s.meanTileSeconds * (tilesTotal_ - tilesDone_) / workers;
+            }
+        }
+    }
+    s.memoryBytes = processMemoryBytes();
+    return s;
+}
+
+size_t RenderMonitor::processMemoryBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<size_t>(pmc.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__linux__)
+    // /proc/self/statm: size resident shared text lib data dt (in pages)
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
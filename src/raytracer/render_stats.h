@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 渲染统计
+//
+// Work counters are plain per-thread counters bumped by the tracing code.
+// TileRenderer takes the difference across each tile and reports it,
+// together with the tile's wall time, to the RenderMonitor attached to the
+// render's RenderControl; the per-worker totals are merged into a
+// RenderStats at the end of the render (TileRenderer::lastStats()). The UI
+// polls RenderMonitor::snapshot().
+//
+// Building with MCSKIN_RENDER_STATS=0 turns the count*() calls into empty
+// inlines: the counters then stay zero and cost nothing in the hot loop.
+// Tile and phase timing is per tile and always on.
+
+#ifndef MCSKIN_RENDER_STATS
+#define MCSKIN_RENDER_STATS 1
+#endif
+
+enum class RayKind : int { Primary = 0, Shadow, AO, Reflection };
+static constexpr int RAY_KIND_COUNT = 4;
+
+// traceRay() calls by recursion depth; the last bin collects deeper calls
+static constexpr int TRACE_DEPTH_BINS = 8;
+
+struct RayCounts {
+    std::array<uint64_t, RAY_KIND_COUNT> n{};
+
+    uint64_t operator[](RayKind kind) const { return n[static_cast<int>(kind)]; }
+    uint64_t total() const { return n[0] + n[1] + n[2] + n[3]; }
+
+    RayCounts& operator+=(const RayCounts& o) {
+        for (int i = 0; i < RAY_KIND_COUNT; ++i) n[i] += o.n[i];
+        return *this;
+    }
+    RayCounts operator-(const RayCounts& o) const {
+        RayCounts r;
+        for (int i = 0; i < RAY_KIND_COUNT; ++i) r.n[i] = n[i] - o.n[i];
+        return r;
+    }
+};
+
+struct WorkCounters {
+    RayCounts rays;
+    uint64_t boxTests = 0;            // ray-AABB slab tests
+    uint64_t textureSamples = 0;      // TextureRegion::sample() on a hit face
+    uint64_t transparentMisses = 0;   // hits rejected because the texel(s) had alpha 0
+    uint64_t backFaceFallbacks = 0;   // outer layer: transparent entry face, far face tried
+    std::array<uint64_t, TRACE_DEPTH_BINS> traceDepth{};
+
+    WorkCounters& operator+=(const WorkCounters& o);
+    WorkCounters operator-(const WorkCounters& o) const;
+};
+
+// Counters of the calling thread (monotonic, never reset). Inline, so the
+// count*() calls in the intersection loop compile to a TLS increment.
+inline thread_local WorkCounters tlsWorkCounters;
+inline WorkCounters& threadCounters() { return tlsWorkCounters; }
+
+#if MCSKIN_RENDER_STATS
+inline void countRay(RayKind kind) { ++threadCounters().rays.n[static_cast<int>(kind)]; }
+inline void countBoxTest() { ++threadCounters().boxTests; }
+inline void countTextureSample() { ++threadCounters().textureSamples; }
+inline void countTransparentMiss() { ++threadCounters().transparentMisses; }
+inline void countBackFaceFallback() { ++threadCounters().backFaceFallbacks; }
+inline void countTraceDepth(int depth) {
+    ++threadCounters().traceDepth[depth < TRACE_DEPTH_BINS ? depth : TRACE_DEPTH_BINS - 1];
+}
+#else
+inline void countRay(RayKind) {}
+inline void countBoxTest() {}
+inline void countTextureSample() {}
+inline void countTransparentMiss() {}
+inline void countBackFaceFallback() {}
+inline void countTraceDepth(int) {}
+#endif
+
+// Effect levels chosen by the automatic quality policy (QualityPolicy)
+struct QualityReport {
+    bool applied = false;           // config had autoQuality set
+    float texelPixels = 0.0f;       // on-screen size of a skin texel
+    int shadowSamples = 0;
+    int aoSamples = 0;
+    int maxBounces = 0;
+    bool dofEnabled = false;
+};
+
+// Totals of one TileRenderer::render() call
+struct RenderStats {
+    WorkCounters counters;
+    int tiles = 0;
+    int threads = 0;
+    int tileSize = 0;               // as rendered (after Autotuner::resolve)
+    QualityReport quality;
+
+    // Phases, in seconds. Worker phases are summed over all workers.
+    double totalSeconds = 0.0;      // wall time of render()
+    double setupSeconds = 0.0;      // tile generation, output allocation
+    double traceSeconds = 0.0;      // inside renderTile()
+    double callbackSeconds = 0.0;   // progress callback, including its lock
+    double pausedSeconds = 0.0;     // held by RenderControl::paused
+    double tailSeconds = 0.0;       // first worker done → last worker done
+};
+
+struct RenderStatsSnapshot {
+    double elapsedSeconds = 0.0;
+    double etaSeconds = -1.0;       // -1 = unknown (no tile finished yet)
+    double meanTileSeconds = 0.0;
+    int tilesDone = 0;
+    int tilesTotal = 0;
+    int threadCount = 0;
+    int activeThreads = 0;          // workers currently inside a tile
+    RayCounts rays;
+    size_t memoryBytes = 0;         // process resident set size
+
+    // Millions of rays of one kind (or all) per second of wall time
+    double mraysPerSecond(RayKind kind) const;
+    double mraysPerSecond() const;
+};
+
+class RenderMonitor {
+public:
+    // Called by TileRenderer::render() at the start of a render. With the
+    // scheduler's cost estimates (totalCost > 0) the ETA follows the
+    // estimated work done rather than the tile count, which would be far
+    // too pessimistic while the costliest tiles go first.
+    void begin(int totalTiles, int threadCount, double totalCost = 0.0);
+
+    // Per piece of work; a split tile counts as done with its last piece
+    void tileStarted();
+    void tileFinished(double seconds, const RayCounts& rays,
+                      double cost = 0.0, bool tileDone = true);
+
+    RenderStatsSnapshot snapshot() const;
+
+    // Resident memory of this process in bytes (0 if unavailable)
+    static size_t processMemoryBytes();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    mutable std::mutex mutex_;
+    Clock::time_point start_ = Clock::now();
+    int tilesTotal_ = 0;
+    int tilesDone_ = 0;
+    int threadCount_ = 0;
+    int activeThreads_ = 0;
+    double tileSecondsSum_ = 0.0;
+    double totalCost_ = 0.0;
+    double costDone_ = 0.0;
+    RayCounts rays_;
+};
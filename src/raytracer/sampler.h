@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+// 逐像素确定性采样器
+//
+// The random numbers used for pixel (px, py), sample s depend only on those
+// three integers. They never depend on tile size, tile order or thread count,
+// so a progressive pass, a region render or a resumed render draws exactly
+// the samples a single full render would.
+
+// Integer hash with good avalanche (lowbias32)
+inline uint32_t hashUint32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+class PixelSampler {
+public:
+    PixelSampler(int px, int py, int sampleIndex)
+        : state_(hashUint32(hashUint32(hashUint32(static_cast<uint32_t>(px))
+                                       + static_cast<uint32_t>(py))
+                            + static_cast<uint32_t>(sampleIndex)))
+    {
+    }
+
+    // Uniform float in [0, 1) (PCG-RXS-M-XS step)
+    float next() {
+        state_ = state_ * 747796405u + 2891336453u;
+        uint32_t word = ((state_ >> ((state_ >> 28u) + 4u)) ^ state_) * 277803737u;
+        word = (word >> 22u) ^ word;
+        return static_cast<float>(word >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    uint32_t state_;
+};
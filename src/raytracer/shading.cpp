@@ -1,5 +1,6 @@
 #include "raytracer/shading.h"
 #include "raytracer/intersection.h"
+#include "raytracer/render_stats.h"
 #include <cmath>
 #include <algorithm>
 #include <random>
@@ -20,6 +21,7 @@ bool isInShadow(const Vec3& point, const Vec3& normal, const Vec3& lightPos, con
 
     Vec3 dir = toLight / distToLight;
     Ray shadowRay(origin, dir);
+    countRay(RayKind::Shadow);
     HitResult hit = intersectScene(shadowRay, scene);
 
     return hit.hit && hit.t < distToLight;
@@ -1,21 +1,32 @@
 #include "raytracer/tile_renderer.h"
 #include "raytracer/intersection.h"
+#include "raytracer/sampler.h"
+#include "raytracer/render_stats.h"
+#include "diagnostics/profiler.h"
+#include "raytracer/autotuner.h"
+#include "raytracer/cost_model.h"
+#include "raytracer/quality_policy.h"
+#include "raytracer/tile_scheduler.h"
+#include "raytracer/render_pool.h"
 #include "scene/scene.h"
+#include <chrono>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <algorithm>
-#include <random>
 #include <cmath>
 #include <stdexcept>
+#include <string>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-std::vector<TileRenderer::TileError> TileRenderer::errors_;
+thread_local std::vector<TileRenderer::TileError> TileRenderer::errors_;
+thread_local RenderStats TileRenderer::stats_;
 
-std::vector<Tile> TileRenderer::generateTiles(int imageWidth, int imageHeight, int tileSize) {
+std::vector<Tile> TileRenderer::generateTiles(int imageWidth, int imageHeight, int tileSize,
+                                              Traversal traversal) {
     if (imageWidth <= 0 || imageHeight <= 0 || tileSize <= 0) {
         return {};
     }
@@ -25,23 +36,61 @@ std::vector<Tile> TileRenderer::generateTiles(int imageWidth, int imageHeight, i
     int rows = (imageHeight + tileSize - 1) / tileSize;
     tiles.reserve(cols * rows);
 
-    for (int ty = 0; ty < rows; ++ty) {
-        for (int tx = 0; tx < cols; ++tx) {
-            Tile tile;
-            tile.x = tx * tileSize;
-            tile.y = ty * tileSize;
-            tile.width = std::min(tileSize, imageWidth - tile.x);
-            tile.height = std::min(tileSize, imageHeight - tile.y);
-            tiles.push_back(tile);
-        }
+    for (const auto& [tx, ty] : traversalOrder(cols, rows, traversal)) {
+        Tile tile;
+        tile.x = tx * tileSize;
+        tile.y = ty * tileSize;
+        tile.width = std::min(tileSize, imageWidth - tile.x);
+        tile.height = std::min(tileSize, imageHeight - tile.y);
+        tiles.push_back(tile);
     }
     return tiles;
 }
 
+Tile TileRenderer::renderRegion(const RayTracer::Config& config) {
+    Tile full{0, 0, std::max(0, config.width), std::max(0, config.height)};
+    if (config.regionWidth <= 0 || config.regionHeight <= 0) {
+        return full;
+    }
+    int x0 = std::clamp(config.regionX, 0, full.width);
+    int y0 = std::clamp(config.regionY, 0, full.height);
+    int x1 = std::clamp(config.regionX + config.regionWidth, 0, full.width);
+    int y1 = std::clamp(config.regionY + config.regionHeight, 0, full.height);
+    return Tile{x0, y0, x1 - x0, y1 - y0};
+}
+
+std::vector<Tile> TileRenderer::clipTiles(const std::vector<Tile>& tiles, const Tile& region) {
+    std::vector<Tile> clipped;
+    for (const Tile& t : tiles) {
+        int x0 = std::max(t.x, region.x);
+        int y0 = std::max(t.y, region.y);
+        int x1 = std::min(t.x + t.width, region.x + region.width);
+        int y1 = std::min(t.y + t.height, region.y + region.height);
+        if (x1 > x0 && y1 > y0) {
+            clipped.push_back(Tile{x0, y0, x1 - x0, y1 - y0});
+        }
+    }
+    return clipped;
+}
+
+void TileRenderer::compositeRegion(Image& base, const Image& rendered,
+                                   const RayTracer::Config& config) {
+    if (base.width != config.width || base.height != config.height
+        || rendered.width != config.width || rendered.height != config.height) {
+        return;
+    }
+    Tile r = renderRegion(config);
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        std::copy(rendered.pixels.begin() + (y * base.width + r.x),
+                  rendered.pixels.begin() + (y * base.width + r.x + r.width),
+                  base.pixels.begin() + (y * base.width + r.x));
+    }
+}
+
 // Generate a DOF ray using thin-lens model
 static Ray generateDOFRay(const Scene& scene, float u, float v, float aspectRatio,
                           float aperture, float focusDist,
-                          std::mt19937& rng) {
+                          PixelSampler& sampler) {
     // First generate the pinhole ray to find the focus point
     Ray pinholeRay = scene.camera.generateRay(u, v, aspectRatio);
 
@@ -55,9 +104,8 @@ static Ray generateDOFRay(const Scene& scene, float u, float v, float aspectRati
     Vec3 focusPoint = pinholeRay.origin + pinholeRay.direction * focusDist;
 
     // Random point on lens disk
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    float angle = 2.0f * static_cast<float>(M_PI) * dist(rng);
-    float radius = aperture * std::sqrt(dist(rng));
+    float angle = 2.0f * static_cast<float>(M_PI) * sampler.next();
+    float radius = aperture * std::sqrt(sampler.next());
     float lensX = radius * std::cos(angle);
     float lensY = radius * std::sin(angle);
 
@@ -68,15 +116,24 @@ static Ray generateDOFRay(const Scene& scene, float u, float v, float aspectRati
     return Ray(newOrigin, newDir);
 }
 
+void SampleAccumulator::prepare(int width, int height) {
+    const size_t n = static_cast<size_t>(std::max(0, width)) * std::max(0, height);
+    if (sum.size() == n && samples.size() == n) return;
+    sum.assign(n, Color(0.0f, 0.0f, 0.0f, 0.0f));
+    samples.assign(n, 0);
+}
+
 void TileRenderer::renderTile(const Tile& tile,
                               const Scene& scene,
                               const RayTracer::Config& config,
-                              Image& output) {
+                              Image& output,
+                              CostMap* cost,
+                              SampleAccumulator* accumulator,
+                              const std::vector<std::pair<int, int>>* pixelOrder) {
     float aspectRatio = static_cast<float>(config.width) / static_cast<float>(config.height);
     int spp = std::max(1, config.samplesPerPixel);
-
-    std::mt19937 rng(static_cast<unsigned>(tile.y * config.width + tile.x));
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    bool centered = accumulator ? accumulator->totalSamples == 1
+                                : (spp == 1 && config.sampleOffset == 0);
 
     // Compute focus distance
     float focusDist = config.focusDistance;
@@ -84,110 +141,415 @@ void TileRenderer::renderTile(const Tile& tile,
         focusDist = (scene.camera.target - scene.camera.position).length();
     }
 
-    for (int py = tile.y; py < tile.y + tile.height; ++py) {
-        for (int px = tile.x; px < tile.x + tile.width; ++px) {
-            Color accum(0.0f, 0.0f, 0.0f, 0.0f);
-
-            for (int s = 0; s < spp; ++s) {
-                float jx = (spp == 1) ? 0.5f : dist(rng);
-                float jy = (spp == 1) ? 0.5f : dist(rng);
-
-                float u = (static_cast<float>(px) + jx) / static_cast<float>(config.width);
-                float v = (static_cast<float>(py) + jy) / static_cast<float>(config.height);
+    auto shadePixel = [&](int px, int py) {
+        // Samples [first, last) with sampler index base + s; an accumulator
+        // continues each pixel from its own count up to the pass end
+        const size_t index = static_cast<size_t>(py) * output.width + px;
+        int first = 0, last = spp, base = config.sampleOffset;
+        Color accum(0.0f, 0.0f, 0.0f, 0.0f);
+        if (accumulator) {
+            first = static_cast<int>(accumulator->samples[index]);
+            last = std::max(first, config.sampleOffset + spp);
+            base = 0;
+            accum = accumulator->sum[index];
+        }
+        std::chrono::steady_clock::time_point pixelStart;
+        uint64_t raysBefore = 0;
+        if (cost) {
+            raysBefore = threadCounters().rays.total();
+            pixelStart = std::chrono::steady_clock::now();
+        }
 
-                Ray ray;
-                if (config.dofEnabled && config.aperture > 1e-6f) {
-                    ray = generateDOFRay(scene, u, v, aspectRatio,
-                                         config.aperture, focusDist, rng);
-                } else {
-                    ray = scene.camera.generateRay(u, v, aspectRatio);
-                }
+        for (int s = first; s < last; ++s) {
+            countRay(RayKind::Primary);
+            PixelSampler sampler(px, py, base + s);
+            float jx = centered ? 0.5f : sampler.next();
+            float jy = centered ? 0.5f : sampler.next();
+
+            float u = (static_cast<float>(px) + jx) / static_cast<float>(config.width);
+            float v = (static_cast<float>(py) + jy) / static_cast<float>(config.height);
+
+            Ray ray;
+            if (config.dofEnabled && config.aperture > 1e-6f) {
+                ray = generateDOFRay(scene, u, v, aspectRatio,
+                                     config.aperture, focusDist, sampler);
+            } else {
+                ray = scene.camera.generateRay(u, v, aspectRatio);
+            }
 
-                Color c = RayTracer::traceRay(ray, scene, 0, config.maxBounces,
-                                              ShadingParams{}, &config);
+            Color c = RayTracer::tracePrimary(ray, scene, u, v, config);
 
-                // If the ray missed, use the gradient background with proper u,v
-                // (traceRay returns approximate bg for misses; override here)
-                HitResult testHit = intersectScene(ray, scene);
-                if (!testHit.hit) {
-                    c = RayTracer::backgroundColor(scene, u, v, &config);
-                }
+            accum.r += c.r;
+            accum.g += c.g;
+            accum.b += c.b;
+            accum.a += c.a;
+        }
 
-                accum.r += c.r;
-                accum.g += c.g;
-                accum.b += c.b;
-                accum.a += c.a;
-            }
+        if (accumulator) {
+            accumulator->sum[index] = accum;
+            accumulator->samples[index] = static_cast<uint32_t>(last);
+        }
+        float inv = last > 0 ? 1.0f / static_cast<float>(last) : 0.0f;
+        output.pixels[index] = Color(
+            accum.r * inv, accum.g * inv, accum.b * inv, accum.a * inv);
+
+        if (cost) {
+            size_t i = static_cast<size_t>(py) * cost->width + px;
+            cost->pixelSeconds[i] = std::chrono::duration<float>(
+                std::chrono::steady_clock::now() - pixelStart).count();
+            cost->pixelRays[i] = static_cast<uint32_t>(threadCounters().rays.total() - raysBefore);
+        }
+    };
 
-            float inv = 1.0f / static_cast<float>(spp);
-            output.pixels[py * output.width + px] = Color(
-                accum.r * inv, accum.g * inv, accum.b * inv, accum.a * inv);
+    if (config.traversal == Traversal::RowMajor) {
+        for (int py = tile.y; py < tile.y + tile.height; ++py) {
+            for (int px = tile.x; px < tile.x + tile.width; ++px) shadePixel(px, py);
+        }
+    } else {
+        std::vector<std::pair<int, int>> own;
+        if (!pixelOrder) {
+            own = traversalOrder(tile.width, tile.height, config.traversal);
+            pixelOrder = &own;
+        }
+        for (const auto& [dx, dy] : *pixelOrder) {
+            shadePixel(tile.x + dx, tile.y + dy);
         }
     }
 }
 
 Image TileRenderer::render(const Scene& scene,
                            const RayTracer::Config& config,
-                           std::function<void(int, int)> progressCallback) {
-    int threadCount = config.threadCount;
-    if (threadCount <= 0) {
-        threadCount = static_cast<int>(std::thread::hardware_concurrency());
-        if (threadCount <= 0) threadCount = 1;
-    }
+                           std::function<void(int, int)> progressCallback,
+                           RenderControl* control) {
+    RenderPool pool;
+    Image output(std::max(0, config.width), std::max(0, config.height));
+    renderInto(scene, config, output, pool, std::move(progressCallback), control);
+    return output;
+}
+
+void TileRenderer::renderInto(const Scene& scene,
+                              const RayTracer::Config& requested,
+                              Image& output,
+                              RenderPool& pool,
+                              std::function<void(int, int)> progressCallback,
+                              RenderControl* control) {
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    };
+    const Clock::time_point renderStart = Clock::now();
+    ProfileZone renderZone("render", "stage");
+    ProfileZone setupZone("setup", "stage");
+
+    // Effects scaled to the output size first: the lighter config is what
+    // the tuning profile should be looked up for
+    QualityReport quality;
+    const RayTracer::Config scaled = QualityPolicy::resolve(scene, requested, &quality);
+
+    // Unset tile size / thread count come from the tuning profile
+    const RayTracer::Config config = Autotuner::resolve(scaled);
+    const int threadCount = config.threadCount;
 
-    std::vector<Tile> tiles = generateTiles(config.width, config.height, config.tileSize);
+    const std::vector<Tile>& tiles = pool.tilesFor(config);
     int totalTiles = static_cast<int>(tiles.size());
 
-    Image output(config.width, config.height);
+    const int width = std::max(0, config.width);
+    const int height = std::max(0, config.height);
+    if (output.width != width || output.height != height) {
+        output = Image(width, height);
+    }
     errors_.clear();
+    stats_ = RenderStats();
 
     if (totalTiles == 0) {
-        return output;
+        return;
+    }
+
+    int numThreads = std::min(threadCount, totalTiles);
+
+    std::vector<double>& tileCosts = pool.costs_;
+    tileCosts.clear();
+    if (config.tileSchedule == TileSchedule::CostFirst && numThreads > 1) {
+        ProfileZone estimateZone("estimate tile costs", "stage");
+        pool.costsFor(scene, config);
     }
+    TileScheduler& scheduler = pool.scheduler_;
+    scheduler.reset(tiles, tileCosts, config.tileSchedule, numThreads);
+    double totalCost = 0.0;
+    for (double c : tileCosts) totalCost += c;
+
+    RenderMonitor* monitor = control ? control->monitor : nullptr;
+    if (monitor) monitor->begin(totalTiles, numThreads, totalCost);
+    CostMap* cost = control ? control->costMap : nullptr;
+    SampleAccumulator* accumulator = control ? control->accumulator : nullptr;
+    if (accumulator) accumulator->prepare(width, height);
+    if (cost) {
+        cost->reset(config.width, config.height, tiles.size());
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            const Tile& t = tiles[i];
+            cost->tiles[i] = TileCost{t.x, t.y, t.width, t.height, 0.0, 0, -1};
+        }
+    }
+
+    pool.chargeStorage();
+
+    RenderStats stats;
+    stats.tiles = totalTiles;
+    stats.threads = numThreads;
+    stats.tileSize = config.tileSize;
+    stats.quality = quality;
+    stats.setupSeconds = seconds(renderStart, Clock::now());
+    setupZone.end();
 
-    std::atomic<int> nextTile{0};
+    std::atomic<int> nextWorker{0};
     std::atomic<int> completedTiles{0};
     std::mutex progressMutex;
     std::mutex errorMutex;
+    std::mutex costMutex;
+    std::vector<TileError>& errors = pool.errors_;
+    errors.clear();
+    std::mutex statsMutex;
+    Clock::time_point firstDone = Clock::time_point::max();
+    Clock::time_point lastDone = Clock::time_point::min();
 
     auto worker = [&]() {
+        const int workerIndex = nextWorker.fetch_add(1);
+        const WorkCounters workerStart = threadCounters();
+        if (Profiler::enabled()) Profiler::setThreadName("render worker " + std::to_string(workerIndex));
+        double traceSeconds = 0.0, callbackSeconds = 0.0, pausedSeconds = 0.0;
+
         while (true) {
-            int idx = nextTile.fetch_add(1);
-            if (idx >= totalTiles) break;
+            if (control) {
+                if (control->paused.load(std::memory_order_relaxed)) {
+                    ProfileZone pauseZone("paused", "wait");
+                    Clock::time_point pauseStart = Clock::now();
+                    while (control->paused.load(std::memory_order_relaxed)
+                           && !control->cancel.load(std::memory_order_relaxed)
+                           && Clock::now() < control->deadline) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    }
+                    pausedSeconds += seconds(pauseStart, Clock::now());
+                }
+                if (control->cancel.load(std::memory_order_relaxed)) break;
+                if (Clock::now() >= control->deadline) break;
+            }
+            ScheduledTile work;
+            if (!scheduler.next(work)) break;
+            const int idx = work.index;
 
+            RayCounts raysBefore = threadCounters().rays;
+            Clock::time_point tileStart = Clock::now();
+            if (monitor) monitor->tileStarted();
+
+            ProfileZone tileZone("tile", "trace", idx);
             try {
-                renderTile(tiles[idx], scene, config, output);
+                renderTile(work.tile, scene, config, output, cost, accumulator,
+                           pool.pixelOrder(work.tile.width, work.tile.height));
             } catch (const std::exception& e) {
                 std::lock_guard<std::mutex> lock(errorMutex);
-                errors_.push_back({idx, e.what()});
+                errors.push_back({idx, e.what()});
             } catch (...) {
                 std::lock_guard<std::mutex> lock(errorMutex);
-                errors_.push_back({idx, "Unknown error"});
+                errors.push_back({idx, "Unknown error"});
             }
 
+            tileZone.end();
+            Clock::time_point tileEnd = Clock::now();
+            traceSeconds += seconds(tileStart, tileEnd);
+            RayCounts tileRays = threadCounters().rays - raysBefore;
+            const bool tileDone = scheduler.finish(idx);
+            if (monitor) monitor->tileFinished(seconds(tileStart, tileEnd), tileRays, work.cost, tileDone);
+            if (cost) {
+                // Pieces of a split tile add up in its grid entry
+                std::lock_guard<std::mutex> lock(costMutex);
+                TileCost& tc = cost->tiles[idx];
+                tc.seconds += seconds(tileStart, tileEnd);
+                tc.rays += tileRays.total();
+                tc.thread = workerIndex;
+            }
+            if (!tileDone) continue;
+
             int done = completedTiles.fetch_add(1) + 1;
             if (progressCallback) {
+                ProfileZone waitZone("wait progress lock", "lock");
                 std::lock_guard<std::mutex> lock(progressMutex);
+                waitZone.end();
+                ProfileZone callbackZone("progress callback", "callback", done);
                 progressCallback(done, totalTiles);
+                callbackSeconds += seconds(tileEnd, Clock::now());
             }
         }
+
+        // Merge this worker's totals once, at the end
+        Clock::time_point end = Clock::now();
+        ProfileZone waitZone("wait stats lock", "lock");
+        std::lock_guard<std::mutex> lock(statsMutex);
+        waitZone.end();
+        stats.counters += threadCounters() - workerStart;
+        stats.traceSeconds += traceSeconds;
+        stats.callbackSeconds += callbackSeconds;
+        stats.pausedSeconds += pausedSeconds;
+        firstDone = std::min(firstDone, end);
+        lastDone = std::max(lastDone, end);
     };
 
-    std::vector<std::thread> threads;
-    int numThreads = std::min(threadCount, totalTiles);
-    threads.reserve(numThreads);
+    {
+        ProfileZone joinZone("join workers", "stage");
+        pool.run(numThreads, worker);
+    }
+    pool.chargeStorage();     // splits and errors may have grown it
 
-    for (int i = 0; i < numThreads; ++i) {
-        threads.emplace_back(worker);
+    stats.tailSeconds = seconds(firstDone, lastDone);
+    stats.totalSeconds = seconds(renderStart, Clock::now());
+    stats_ = stats;
+    errors_.assign(errors.begin(), errors.end());
+}
+
+// ── Deadline mode ───────────────────────────────────────────────────────────
+
+DeadlineResult TileRenderer::renderWithin(const Scene& scene,
+                                          const RayTracer::Config& config,
+                                          double budgetSeconds,
+                                          const CostModel& model,
+                                          std::function<void(int, int)> progressCallback,
+                                          RenderControl* control) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(std::max(0.0, budgetSeconds)));
+    auto elapsed = [&]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    DeadlineResult result;
+    result.coverage = CostModel::estimateCoverage(scene, config);
+
+    // Plan against 90% of the budget: the model is an estimate
+    const double target = 0.9 * budgetSeconds;
+    RayTracer::Config planned = config;
+    planned.samplesPerPixel = 1;
+    planned.sampleOffset = 0;
+    double perSample = model.predict(planned, result.coverage).wallSeconds;
+    while (perSample > target && (planned.shadowSamples > 1 || planned.aoSamples > 1)) {
+        planned.shadowSamples = std::max(1, planned.shadowSamples / 2);
+        planned.aoSamples = std::max(1, planned.aoSamples / 2);
+        perSample = model.predict(planned, result.coverage).wallSeconds;
     }
+    const int maxSamples = std::max(1, config.samplesPerPixel);
+    result.plannedSamples = perSample > 0.0
+        ? std::clamp(static_cast<int>(target / perSample), 1, maxSamples) : maxSamples;
+    result.shadowSamples = planned.shadowSamples;
+    result.aoSamples = planned.aoSamples;
+    planned.samplesPerPixel = result.plannedSamples;
+    result.predictedSeconds = model.predict(planned, result.coverage).wallSeconds;
+
+    const int width = std::max(0, config.width);
+    const int height = std::max(0, config.height);
+
+    // The passes continue one accumulator, so the samples are those of
+    // render() at plannedSamples (pixel centres only if that is 1)
+    SampleAccumulator accumulator;
+    accumulator.totalSamples = result.plannedSamples;
+    SampleAccumulator kept;     // the sums before a refinement pass
+
+    // Every pass runs under the caller's control with the deadline set
+    RenderControl local;
+    RenderControl& active = control ? *control : local;
+    const Clock::time_point previousDeadline = active.deadline;
+    SampleAccumulator* previousAccumulator = active.accumulator;
+    active.deadline = std::min(deadline, previousDeadline);
+    active.accumulator = &accumulator;
+
+    RenderPool pool;
+    Image img(width, height);
+    const Tile region = renderRegion(config);
+    const Color untraced(0.0f, 0.0f, 0.0f, -1.0f);   // traced pixels have alpha >= 0
+    int done = 0;
+    double secondsPerSample = perSample;    // replaced by the measured rate
+    while (done < result.plannedSamples) {
+        if (active.cancel.load()) break;
+        const int count = std::min(std::max(1, done), result.plannedSamples - done);
+        if (done > 0 && elapsed() + secondsPerSample * count > budgetSeconds) {
+            result.deadlineReached = true;
+            break;
+        }
 
-    for (auto& t : threads) {
-        t.join();
+        int tilesDone = 0;
+        auto countTiles = [&](int d, int) { tilesDone = d; };
+        RayTracer::Config pass = planned;
+        pass.samplesPerPixel = count;
+        pass.sampleOffset = done;
+        const double passStart = elapsed();
+        if (done == 0) {
+            std::fill(img.pixels.begin(), img.pixels.end(), untraced);
+        } else {
+            kept = accumulator;
+        }
+        renderInto(scene, pass, img, pool, countTiles, &active);
+        const bool cut = tilesDone < lastStats().tiles;
+        if (cut && done > 0) {
+            // Drop the cut pass: back to the means of the last whole one
+            accumulator = kept;
+            for (size_t i = 0; i < img.pixels.size(); ++i) {
+                if (accumulator.samples[i] == 0) continue;
+                const Color& sum = accumulator.sum[i];
+                const float inv = 1.0f / static_cast<float>(accumulator.samples[i]);
+                img.pixels[i] = Color(sum.r * inv, sum.g * inv, sum.b * inv, sum.a * inv);
+            }
+            result.deadlineReached = !active.cancel.load();
+            break;
+        }
+
+        if (cut && !active.cancel.load()) {
+            // The deadline left tiles of the first pass black: fill them
+            // from a quarter-resolution pass, run outside the caller's
+            // control so it is not cut short and leaves the monitor and
+            // cost map with the first pass
+            RayTracer::Config coarse = pass;
+            coarse.width = std::max(1, (width + 3) / 4);
+            coarse.height = std::max(1, (height + 3) / 4);
+            coarse.samplesPerPixel = 1;
+            coarse.sampleOffset = 0;
+            coarse.regionX = coarse.regionY = coarse.regionWidth = coarse.regionHeight = 0;
+            Image low;
+            renderInto(scene, coarse, low, pool);
+            for (int y = region.y; y < region.y + region.height; ++y) {
+                const int ly = std::min(low.height - 1, y * low.height / height);
+                for (int x = region.x; x < region.x + region.width; ++x) {
+                    Color& c = img.pixels[static_cast<size_t>(y) * width + x];
+                    if (c.a >= 0.0f) continue;
+                    c = low.pixels[static_cast<size_t>(ly) * low.width
+                                   + std::min(low.width - 1, x * low.width / width)];
+                    ++result.coarsePixels;
+                }
+            }
+        }
+        if (done == 0) {
+            // Still untraced: cancelled, or outside the region
+            for (Color& c : img.pixels) {
+                if (c.a < 0.0f) c = Color(0.0f, 0.0f, 0.0f, 0.0f);
+            }
+        }
+
+        done += count;
+        secondsPerSample = (elapsed() - passStart) / count;
+        if (progressCallback) progressCallback(done, result.plannedSamples);
+        if (cut) {
+            result.deadlineReached = !active.cancel.load();
+            break;
+        }
     }
+    active.deadline = previousDeadline;
+    active.accumulator = previousAccumulator;
 
-    return output;
+    result.image = std::move(img);
+    result.samplesPerPixel = done;
+    result.seconds = elapsed();
+    return result;
 }
 
 const std::vector<TileRenderer::TileError>& TileRenderer::lastErrors() {
     return errors_;
 }
+
+const RenderStats& TileRenderer::lastStats() {
+    return stats_;
+}
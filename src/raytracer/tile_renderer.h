@@ -1,11 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <functional>
 #include <string>
+#include <utility>
 #include "skin/image.h"
 #include "scene/scene.h"
 #include "raytracer/raytracer.h"
+#include "raytracer/render_stats.h"
+#include "raytracer/cost_map.h"
 
 // 渲染图块
 struct Tile {
@@ -13,25 +18,114 @@ struct Tile {
     int width, height;  // 图块尺寸
 };
 
+// Running per-pixel sums of a render split into passes (see
+// render_checkpoint.h). When RenderControl::accumulator is set, renderTile()
+// takes every pixel from samples[i] up to sampleOffset + samplesPerPixel,
+// adding to sum[i] in sample order (the same float additions as one render
+// of all the samples), and writes the running mean to the image.
+struct SampleAccumulator {
+    int totalSamples = 1;           // of the whole render: selects the sampling pattern
+    std::vector<Color> sum;         // per pixel, row-major, config-sized
+    std::vector<uint32_t> samples;  // per pixel: samples in sum = next sample index
+
+    // Config-sized and zeroed, unless it already is config-sized
+    void prepare(int width, int height);
+};
+
+// Cooperative control of a render in flight, shared with the caller's
+// thread: cancel, pause, deadline, and optional per-tile monitor,
+// per-pixel cost map (slower) and running sample sums.
+struct RenderControl {
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> paused{false};
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    RenderMonitor* monitor = nullptr;
+    CostMap* costMap = nullptr;
+    SampleAccumulator* accumulator = nullptr;
+};
+
+class CostModel;
+class RenderPool;
+
+// Outcome of TileRenderer::renderWithin()
+struct DeadlineResult {
+    Image image;
+    int samplesPerPixel = 0;        // samples actually accumulated
+    int plannedSamples = 0;         // what the cost model said would fit
+    int shadowSamples = 0;          // effect samples used (reduced if even
+    int aoSamples = 0;              // one sample per pixel would not fit)
+    double coverage = 0.0;
+    double predictedSeconds = 0.0;  // for plannedSamples
+    double seconds = 0.0;
+    bool deadlineReached = false;   // refinement stopped by the deadline
+    int coarsePixels = 0;           // of a cut first pass, filled from a coarse pass
+};
+
 class TileRenderer {
 public:
-    // Generate tiles that cover the entire image.
-    // Edge tiles are clipped to image bounds.
-    static std::vector<Tile> generateTiles(int imageWidth, int imageHeight, int tileSize);
+    // Generate tiles that cover the entire image, in `traversal` order over
+    // the tile grid. Edge tiles are clipped to image bounds.
+    static std::vector<Tile> generateTiles(int imageWidth, int imageHeight, int tileSize,
+                                           Traversal traversal = Traversal::RowMajor);
+
+    // Pixel rectangle of the config's render region, clamped to the image.
+    // The whole image when no region is set.
+    static Tile renderRegion(const RayTracer::Config& config);
+
+    // Tiles clipped to `region`; tiles outside it are dropped. Clipping the
+    // full-frame grid keeps region renders identical to the same pixels of
+    // a full render.
+    static std::vector<Tile> clipTiles(const std::vector<Tile>& tiles, const Tile& region);
+
+    // Copy the render region of `rendered` into `base` (both config-sized).
+    static void compositeRegion(Image& base, const Image& rendered,
+                                const RayTracer::Config& config);
 
     // Render the scene using multiple threads, one tile at a time per thread.
     // progressCallback is called (completedTiles, totalTiles) after each tile finishes.
     // Returns the rendered image. Errors in individual tiles are recorded but
-    // do not abort the remaining work.
+    // do not abort the remaining work. `control` (optional) allows cancelling.
     static Image render(const Scene& scene,
                         const RayTracer::Config& config,
-                        std::function<void(int, int)> progressCallback = nullptr);
+                        std::function<void(int, int)> progressCallback = nullptr,
+                        RenderControl* control = nullptr);
 
-    // Render a single tile into the output image.
+    // Render into a caller-owned framebuffer, with threads and per-job
+    // storage taken from `pool` (see render_pool.h). The framebuffer is
+    // resized only if it is not config-sized; pixels outside the render
+    // region keep their contents. Once the pool and framebuffer have seen
+    // a job of the same size, this does not allocate (a progress callback
+    // that does not fit std::function's inline storage is the caller's
+    // allocation). Same image, errors and stats as render().
+    static void renderInto(const Scene& scene,
+                           const RayTracer::Config& config,
+                           Image& framebuffer,
+                           RenderPool& pool,
+                           std::function<void(int, int)> progressCallback = nullptr,
+                           RenderControl* control = nullptr);
+
+    // Deadline mode: as many samples (at most config.samplesPerPixel) as the
+    // cost model fits in budgetSeconds, in passes of 1, 1, 2, 4, ... A later
+    // pass cut by the deadline is dropped; a cut first pass is filled coarsely.
+    static DeadlineResult renderWithin(const Scene& scene,
+                                       const RayTracer::Config& config,
+                                       double budgetSeconds,
+                                       const CostModel& model,
+                                       std::function<void(int, int)> progressCallback = nullptr,
+                                       RenderControl* control = nullptr);
+
+    // Render a single tile into the output image, optionally recording the
+    // cost of each pixel into `cost` (sized like the output) and continuing
+    // the sums of `accumulator`. Pixels are visited in config.traversal
+    // order: `pixelOrder` if given (offsets within the tile, as from
+    // traversalOrder()), otherwise built for the call.
     static void renderTile(const Tile& tile,
                            const Scene& scene,
                            const RayTracer::Config& config,
-                           Image& output);
+                           Image& output,
+                           CostMap* cost = nullptr,
+                           SampleAccumulator* accumulator = nullptr,
+                           const std::vector<std::pair<int, int>>* pixelOrder = nullptr);
 
     // Errors collected from worker threads (tile index → message).
     struct TileError {
@@ -39,9 +133,14 @@ public:
         std::string message;
     };
 
-    // Retrieve errors from the last render() call.
+    // Retrieve errors from the last render() call made on this thread.
     static const std::vector<TileError>& lastErrors();
 
+    // Work counters and phase times of the last render() call made on this
+    // thread (counters are zero when built with MCSKIN_RENDER_STATS=0).
+    static const RenderStats& lastStats();
+
 private:
-    static std::vector<TileError> errors_;
+    static thread_local std::vector<TileError> errors_;
+    static thread_local RenderStats stats_;
 };
@@ -0,0 +1,183 @@
+#include "raytracer/tile_scheduler.h"
+#include "raytracer/cost_model.h"
+#include "raytracer/intersection.h"
+#include <algorithm>
+
+static bool cheaper(const ScheduledTile& a, const ScheduledTile& b) {
+    return a.cost < b.cost;
+}
+
+// A tile too small to split, and the piece size along a side of one that
+// is split (halved if at least two minimum pieces fit, else kept whole)
+static bool splittable(const Tile& t, int minSplitSize) {
+    return t.width >= 2 * minSplitSize || t.height >= 2 * minSplitSize;
+}
+
+static int pieceSize(int size, int minSplitSize) {
+    return size >= 2 * minSplitSize ? size / 2 : size;
+}
+
+TileScheduler::TileScheduler(const std::vector<Tile>& tiles, const std::vector<double>& costs,
+                             TileSchedule schedule, int workers, int minSplitSize) {
+    reset(tiles, costs, schedule, workers, minSplitSize);
+}
+
+void TileScheduler::reset(const std::vector<Tile>& tiles, const std::vector<double>& costs,
+                          TileSchedule schedule, int workers, int minSplitSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pieces_.assign(tiles.size(), 1);
+    costOrdered_ = schedule == TileSchedule::CostFirst && costs.size() == tiles.size();
+    workers_ = std::max(1, workers);
+    minSplitSize_ = std::max(1, minSplitSize);
+    splits_ = 0;
+
+    queue_.clear();
+    queue_.reserve(tiles.size() + 4 * static_cast<size_t>(workers_));
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        queue_.push_back({tiles[i], static_cast<int>(i), costOrdered_ ? costs[i] : 0.0});
+    }
+    if (costOrdered_) {
+        // Equal costs keep grid order (std::sort with the index as the
+        // tie-break: stable_sort would allocate a buffer per job)
+        std::sort(queue_.begin(), queue_.end(), [](const ScheduledTile& a, const ScheduledTile& b) {
+            return a.cost != b.cost ? a.cost > b.cost : a.index < b.index;
+        });
+    }
+    std::reverse(queue_.begin(), queue_.end());
+}
+
+bool TileScheduler::next(ScheduledTile& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+
+    // Running dry: share the costliest remaining tile among the idle workers
+    while (costOrdered_ && static_cast<int>(queue_.size()) < workers_) {
+        if (!splittable(queue_.back().tile, minSplitSize_)) break;
+        ScheduledTile item = queue_.back();
+        queue_.pop_back();
+        split(item);
+    }
+
+    out = queue_.back();
+    queue_.pop_back();
+    return true;
+}
+
+// Called with the mutex held
+void TileScheduler::split(ScheduledTile item) {
+    const Tile& t = item.tile;
+    int w0 = pieceSize(t.width, minSplitSize_);
+    int h0 = pieceSize(t.height, minSplitSize_);
+    const double area = static_cast<double>(t.width) * t.height;
+
+    int added = 0;
+    for (int y = t.y; y < t.y + t.height; y += h0) {
+        for (int x = t.x; x < t.x + t.width; x += w0) {
+            ScheduledTile piece;
+            piece.tile = Tile{x, y, std::min(w0, t.x + t.width - x), std::min(h0, t.y + t.height - y)};
+            piece.index = item.index;
+            piece.cost = item.cost * piece.tile.width * piece.tile.height / area;
+            queue_.insert(std::upper_bound(queue_.begin(), queue_.end(), piece, cheaper), piece);
+            ++added;
+        }
+    }
+    pieces_[item.index] += added - 1;
+    ++splits_;
+}
+
+bool TileScheduler::finish(int index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return --pieces_[index] == 0;
+}
+
+int TileScheduler::splits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return splits_;
+}
+
+size_t TileScheduler::capacityBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.capacity() * sizeof(ScheduledTile) + pieces_.capacity() * sizeof(int);
+}
+
+std::vector<std::pair<int, int>> TileScheduler::shapes(const std::vector<Tile>& tiles,
+                                                       int minSplitSize) {
+    minSplitSize = std::max(1, minSplitSize);
+    std::vector<std::pair<int, int>> out;
+    auto add = [&](int w, int h) {
+        if (std::find(out.begin(), out.end(), std::make_pair(w, h)) == out.end()) out.emplace_back(w, h);
+    };
+    for (const Tile& t : tiles) add(t.width, t.height);
+    // Pieces are split again as the queue runs dry: follow split() down
+    for (size_t i = 0; i < out.size(); ++i) {
+        const auto [w, h] = out[i];
+        if (!splittable(Tile{0, 0, w, h}, minSplitSize)) continue;
+        int w0 = pieceSize(w, minSplitSize);
+        int h0 = pieceSize(h, minSplitSize);
+        for (int y = 0; y < h; y += h0) {
+            for (int x = 0; x < w; x += w0) add(std::min(w0, w - x), std::min(h0, h - y));
+        }
+    }
+    return out;
+}
+
+std::vector<double> TileScheduler::estimateCosts(const Scene& scene,
+                                                 const RayTracer::Config& config,
+                                                 const std::vector<Tile>& tiles,
+                                                 int lattice) {
+    std::vector<double> costs;
+    estimateCosts(scene, config, tiles, costs, lattice);
+    return costs;
+}
+
+void TileScheduler::estimateCosts(const Scene& scene, const RayTracer::Config& config,
+                                  const std::vector<Tile>& tiles, std::vector<double>& costs,
+                                  int lattice) {
+    std::vector<double> coverage;
+    estimateCoverage(scene, config, tiles, coverage, lattice);
+    costsFromCoverage(config, tiles, coverage, costs);
+}
+
+void TileScheduler::estimateCoverage(const Scene& scene, const RayTracer::Config& config,
+                                     const std::vector<Tile>& tiles, std::vector<double>& coverage,
+                                     int lattice) {
+    coverage.assign(tiles.size(), 0.0);
+    if (config.width <= 0 || config.height <= 0) return;
+
+    const float aspect = static_cast<float>(config.width) / static_cast<float>(config.height);
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const Tile& t = tiles[i];
+        int gx = std::max(1, std::min(lattice, t.width));
+        int gy = std::max(1, std::min(lattice, t.height));
+        int hits = 0;
+        for (int y = 0; y < gy; ++y) {
+            for (int x = 0; x < gx; ++x) {
+                float px = t.x + (x + 0.5f) * t.width / gx;
+                float py = t.y + (y + 0.5f) * t.height / gy;
+                Ray ray = scene.camera.generateRay(px / config.width, py / config.height, aspect);
+                if (intersectScene(ray, scene).hit) ++hits;
+            }
+        }
+        coverage[i] = static_cast<double>(hits) / (gx * gy);
+    }
+}
+
+void TileScheduler::costsFromCoverage(const RayTracer::Config& config, const std::vector<Tile>& tiles,
+                                      const std::vector<double>& coverage, std::vector<double>& costs) {
+    costs.assign(tiles.size(), 0.0);
+    if (config.width <= 0 || config.height <= 0 || coverage.size() != tiles.size()) return;
+
+    // Rays per pixel sample is linear in coverage
+    RayTracer::Config one = config;
+    one.width = one.height = 1;
+    one.regionX = one.regionY = one.regionWidth = one.regionHeight = 0;
+    one.samplesPerPixel = 1;
+    const CostModel model;
+    const double empty = model.predict(one, 0.0).workSeconds;
+    const double covered = model.predict(one, 1.0).workSeconds;
+
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const Tile& t = tiles[i];
+        costs[i] = static_cast<double>(t.width) * t.height * (empty + (covered - empty) * coverage[i]);
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "raytracer/raytracer.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/scene.h"
+
+// 按开销排序的图块调度
+//
+// TileRenderer::render() hands tiles to its workers through a
+// TileScheduler. With TileSchedule::CostFirst every tile gets an estimated
+// cost from the projected coverage of the character (a small lattice of
+// primary rays per tile, no shading) and the cost model's per-hit rays for
+// the config's effects; the costliest tiles go first, so silhouette and
+// penumbra tiles no longer start last. Once fewer tiles are queued than
+// there are workers, the next tile is split into quarters (down to
+// minSplitSize) so the tail is shared instead of left to one worker.
+// Pieces keep the index of the grid tile they came from.
+
+struct ScheduledTile {
+    Tile tile;
+    int index = 0;          // grid tile this is (a piece of)
+    double cost = 0.0;      // estimate, arbitrary units
+};
+
+class TileScheduler {
+public:
+    TileScheduler() = default;
+    TileScheduler(const std::vector<Tile>& tiles, const std::vector<double>& costs,
+                  TileSchedule schedule, int workers, int minSplitSize = 8);
+
+    // Start over with a new set of tiles, keeping the storage (RenderPool)
+    void reset(const std::vector<Tile>& tiles, const std::vector<double>& costs,
+               TileSchedule schedule, int workers, int minSplitSize = 8);
+
+    // Next piece of work; false when the queue is empty
+    bool next(ScheduledTile& out);
+
+    // A piece of grid tile `index` is done; true if it was the last one
+    bool finish(int index);
+
+    // Tiles split so far
+    int splits() const;
+
+    // Heap bytes of the queue and piece counts
+    size_t capacityBytes() const;
+
+    // Every tile shape (width, height) the queue can hand out for `tiles`:
+    // their own shapes and those of the pieces splitting can cut from them
+    static std::vector<std::pair<int, int>> shapes(const std::vector<Tile>& tiles,
+                                                   int minSplitSize = 8);
+
+    // Relative cost per tile: pixels × (rays per sample at the tile's
+    // coverage), coverage from lattice × lattice primary rays
+    static std::vector<double> estimateCosts(const Scene& scene,
+                                             const RayTracer::Config& config,
+                                             const std::vector<Tile>& tiles,
+                                             int lattice = 4);
+    static void estimateCosts(const Scene& scene, const RayTracer::Config& config,
+                              const std::vector<Tile>& tiles, std::vector<double>& costs,
+                              int lattice = 4);
+
+    // The two halves of estimateCosts(): the fraction of each tile's
+    // lattice rays that hit the scene (traces rays; depends on the scene,
+    // camera and tiles only), and the costs for a config's effects at that
+    // coverage (no rays). RenderPool keeps the coverage between renders.
+    static void estimateCoverage(const Scene& scene, const RayTracer::Config& config,
+                                 const std::vector<Tile>& tiles, std::vector<double>& coverage,
+                                 int lattice = 4);
+    static void costsFromCoverage(const RayTracer::Config& config, const std::vector<Tile>& tiles,
+                                  const std::vector<double>& coverage, std::vector<double>& costs);
+
+private:
+    void split(ScheduledTile item);
+
+    mutable std::mutex mutex_;
+    std::vector<ScheduledTile> queue_;  // next at the back
+    std::vector<int> pieces_;           // outstanding pieces per grid tile
+    bool costOrdered_ = false;
+    int workers_ = 1;
+    int minSplitSize_ = 8;
+    int splits_ = 0;
+};
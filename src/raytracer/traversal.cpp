@@ -0,0 +1,70 @@
+#include "raytracer/traversal.h"
+#include <algorithm>
+
+// Spread the low 32 bits of v to the even bit positions
+static uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+}
+
+uint64_t mortonIndex(uint32_t x, uint32_t y) {
+    return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+uint64_t hilbertIndex(int order, uint32_t x, uint32_t y) {
+    // Classic xy → d: rotate the quadrant so every level sees the curve in
+    // its base orientation
+    const uint32_t n = order > 0 ? (1u << order) : 1;
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+std::vector<std::pair<int, int>> traversalOrder(int width, int height, Traversal traversal) {
+    std::vector<std::pair<int, int>> cells;
+    if (width <= 0 || height <= 0) return cells;
+    cells.reserve(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) cells.emplace_back(x, y);
+    }
+    if (traversal == Traversal::RowMajor) return cells;
+
+    int order = 0;
+    while ((1 << order) < std::max(width, height)) ++order;
+    std::vector<std::pair<uint64_t, std::pair<int, int>>> keyed;
+    keyed.reserve(cells.size());
+    for (const auto& c : cells) {
+        uint32_t x = static_cast<uint32_t>(c.first), y = static_cast<uint32_t>(c.second);
+        uint64_t key = traversal == Traversal::Morton ? mortonIndex(x, y) : hilbertIndex(order, x, y);
+        keyed.emplace_back(key, c);
+    }
+    std::sort(keyed.begin(), keyed.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < keyed.size(); ++i) cells[i] = keyed[i].second;
+    return cells;
+}
+
+const char* traversalName(Traversal traversal) {
+    switch (traversal) {
+    case Traversal::RowMajor: return "rowmajor";
+    case Traversal::Morton:   return "morton";
+    case Traversal::Hilbert:  return "hilbert";
+    }
+    return "unknown";
+}
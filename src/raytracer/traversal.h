@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 空间填充曲线遍历
+//
+// Order in which tiles are dispatched (the grid order TileSchedule::InOrder
+// follows, and the tie-break among equal-cost tiles in CostFirst) and in
+// which renderTile() walks the pixels of a tile. Row-major order jumps from
+// the right edge back to the left every row; Morton (Z-order) and Hilbert
+// curves keep most consecutive items close in both directions, meant to
+// let neighbouring work reuse meshes, texture regions and output cache
+// lines (only throughput has been measured, not cache misses). On a
+// power-of-two square Hilbert moves one cell at a time; Morton jumps
+// between quadrants but is cheaper to compute. Other rectangles are walked
+// along the curve of the enclosing square, skipping the cells outside, so
+// both curves jump wherever the walk leaves the rectangle and comes back.
+
+enum class Traversal : int {
+    RowMajor = 0,
+    Morton,
+    Hilbert,
+};
+
+// Position of (x, y) along the curve over a 2^order × 2^order square
+uint64_t mortonIndex(uint32_t x, uint32_t y);
+uint64_t hilbertIndex(int order, uint32_t x, uint32_t y);
+
+// Cells of a width × height grid in traversal order, as (x, y)
+std::vector<std::pair<int, int>> traversalOrder(int width, int height, Traversal traversal);
+
+const char* traversalName(Traversal traversal);
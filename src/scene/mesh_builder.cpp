@@ -1,4 +1,5 @@
 #include "scene/mesh_builder.h"
+#include "diagnostics/profiler.h"
 #include <cmath>
 
 #ifndef M_PI
@@ -143,6 +144,7 @@ Mesh MeshBuilder::buildBoxWithPose(const BodyPartTexture& tex,
 }
 
 Scene MeshBuilder::buildScene(const SkinData& skin, const Pose& pose) {
+    ProfileZone zone("build scene", "stage");
     Scene scene;
 
     // Body part definitions with pivot points (joint locations)
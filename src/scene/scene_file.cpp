@@ -0,0 +1,249 @@
+#include "scene/scene_file.h"
+#include "scene/mesh_builder.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+static_assert(std::is_trivially_copyable<Color>::value && sizeof(Color) == 16,
+              "scene file stores Color texels verbatim");
+static_assert(std::is_trivially_copyable<SceneFileHeader>::value, "header must be POD");
+static_assert(std::is_trivially_copyable<SceneFileMesh>::value, "mesh record must be POD");
+static_assert(sizeof(SceneFileFace) == 8, "unexpected padding in SceneFileFace");
+
+static constexpr char SCENE_MAGIC[4] = {'M', 'C', 'S', 'C'};
+static constexpr uint64_t SECTION_ALIGN = 16;
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+}
+
+static void computeBounds(const std::vector<Triangle>& tris, Vec3& bmin, Vec3& bmax) {
+    const float inf = std::numeric_limits<float>::max();
+    bmin = Vec3(inf, inf, inf);
+    bmax = Vec3(-inf, -inf, -inf);
+    for (const auto& tri : tris) {
+        for (const Vec3* v : { &tri.v0, &tri.v1, &tri.v2 }) {
+            bmin.x = std::min(bmin.x, v->x); bmax.x = std::max(bmax.x, v->x);
+            bmin.y = std::min(bmin.y, v->y); bmax.y = std::max(bmax.y, v->y);
+            bmin.z = std::min(bmin.z, v->z); bmax.z = std::max(bmax.z, v->z);
+        }
+    }
+}
+
+static void storeVec3(float out[3], const Vec3& v) {
+    out[0] = v.x; out[1] = v.y; out[2] = v.z;
+}
+
+static Vec3 loadVec3(const float in[3]) {
+    return Vec3(in[0], in[1], in[2]);
+}
+
+// ── Writer ──────────────────────────────────────────────────────────────────
+
+bool SceneFile::write(const Scene& scene, const std::string& path) {
+    std::vector<SceneFileMesh> meshes;
+    std::vector<Color> texels;
+
+    meshes.reserve(scene.meshes.size());
+
+    for (const auto& mesh : scene.meshes) {
+        const auto& local = (mesh.hasRotation && !mesh.localTriangles.empty())
+                            ? mesh.localTriangles : mesh.triangles;
+        if (local.empty()) return false;
+
+        SceneFileMesh rec{};
+        Vec3 bmin, bmax;
+        computeBounds(local, bmin, bmax);
+        storeVec3(rec.boxMin, bmin);
+        storeVec3(rec.boxMax, bmax);
+        storeVec3(rec.pivot, mesh.pivot);
+        rec.rotX = mesh.rotX;
+        rec.rotZ = mesh.rotZ;
+        rec.flags = (mesh.isOuterLayer ? SceneFileMesh::OUTER_LAYER : 0u)
+                  | (mesh.hasRotation ? SceneFileMesh::ROTATED : 0u);
+
+        for (int f = 0; f < 6; ++f) {
+            const TextureRegion& tex = mesh.ownedTextures[f];
+            if (tex.width < 0 || tex.height < 0 || tex.width > 0xFFFF || tex.height > 0xFFFF
+                || static_cast<int>(tex.pixels.size()) != tex.width * tex.height) {
+                return false;
+            }
+            if (texels.size() + tex.pixels.size() > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+
+            SceneFileFace& face = rec.faces[f];
+            face.texelOffset = static_cast<uint32_t>(texels.size());
+            face.width = static_cast<uint16_t>(tex.width);
+            face.height = static_cast<uint16_t>(tex.height);
+            texels.insert(texels.end(), tex.pixels.begin(), tex.pixels.end());
+        }
+        meshes.push_back(rec);
+    }
+
+    SceneFileHeader header{};
+    std::memcpy(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC));
+    header.version = SCENE_FILE_VERSION;
+    header.byteOrder = SCENE_FILE_BYTE_ORDER;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.texelCount = static_cast<uint32_t>(texels.size());
+
+    header.meshOffset = alignUp(sizeof(SceneFileHeader));
+    header.texelOffset = alignUp(header.meshOffset + meshes.size() * sizeof(SceneFileMesh));
+    header.fileSize = header.texelOffset + texels.size() * sizeof(Color);
+
+    storeVec3(header.lightPosition, scene.light.position);
+    header.lightColor[0] = scene.light.color.r;
+    header.lightColor[1] = scene.light.color.g;
+    header.lightColor[2] = scene.light.color.b;
+    header.lightColor[3] = scene.light.color.a;
+    header.lightIntensity = scene.light.intensity;
+    header.lightRadius = scene.light.radius;
+    storeVec3(header.cameraPosition, scene.camera.position);
+    storeVec3(header.cameraTarget, scene.camera.target);
+    storeVec3(header.cameraUp, scene.camera.up);
+    header.cameraFov = scene.camera.fov;
+    header.backgroundColor[0] = scene.backgroundColor.r;
+    header.backgroundColor[1] = scene.backgroundColor.g;
+    header.backgroundColor[2] = scene.backgroundColor.b;
+    header.backgroundColor[3] = scene.backgroundColor.a;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    auto writeAt = [&out](uint64_t offset, const void* data, size_t bytes) {
+        static const char zeros[SECTION_ALIGN] = {};
+        auto pos = static_cast<uint64_t>(out.tellp());
+        if (pos < offset) out.write(zeros, static_cast<std::streamsize>(offset - pos));
+        if (bytes > 0) out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.meshOffset, meshes.data(), meshes.size() * sizeof(SceneFileMesh));
+    writeAt(header.texelOffset, texels.data(), texels.size() * sizeof(Color));
+    return static_cast<bool>(out);
+}
+
+// ── Reader ──────────────────────────────────────────────────────────────────
+
+static bool sectionFits(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+    return offset % SECTION_ALIGN == 0 && offset <= fileSize && bytes <= fileSize - offset;
+}
+
+Result<MappedScene, std::string> SceneFile::open(const std::string& path) {
+    using R = Result<MappedScene, std::string>;
+
+    auto file = MappedFile::open(path);
+    if (!file) {
+        return R::err("Failed to map scene file: " + path);
+    }
+
+    const uint64_t size = file->size();
+    if (size < sizeof(SceneFileHeader)) {
+        return R::err("Scene file is truncated: " + path);
+    }
+
+    const auto* header = reinterpret_cast<const SceneFileHeader*>(file->data());
+    if (std::memcmp(header->magic, SCENE_MAGIC, sizeof(SCENE_MAGIC)) != 0) {
+        return R::err("Not a scene file: " + path);
+    }
+    if (header->version != SCENE_FILE_VERSION) {
+        return R::err("Unsupported scene file version " + std::to_string(header->version)
+                      + " (expected " + std::to_string(SCENE_FILE_VERSION) + ")");
+    }
+    if (header->byteOrder != SCENE_FILE_BYTE_ORDER) {
+        return R::err("Scene file was written with a different byte order");
+    }
+    if (header->fileSize != size) {
+        return R::err("Scene file size mismatch: " + path);
+    }
+
+    if (!sectionFits(header->meshOffset, uint64_t(header->meshCount) * sizeof(SceneFileMesh), size)
+        || !sectionFits(header->texelOffset, uint64_t(header->texelCount) * sizeof(Color), size)) {
+        return R::err("Scene file section out of bounds: " + path);
+    }
+
+    MappedScene scene;
+    scene.header_ = header;
+    scene.meshes_ = reinterpret_cast<const SceneFileMesh*>(file->data() + header->meshOffset);
+    scene.texels_ = reinterpret_cast<const Color*>(file->data() + header->texelOffset);
+
+    // Validate face references once so accessors can stay unchecked
+    for (uint32_t m = 0; m < header->meshCount; ++m) {
+        for (const auto& face : scene.meshes_[m].faces) {
+            uint64_t n = uint64_t(face.width) * face.height;
+            if (face.texelOffset + n > header->texelCount) {
+                return R::err("Scene file face " + std::to_string(m) + " out of bounds");
+            }
+        }
+    }
+
+    scene.file_ = std::move(*file);
+    return R::ok(std::move(scene));
+}
+
+Light MappedScene::light() const {
+    Light l;
+    l.position = loadVec3(header_->lightPosition);
+    l.color = Color(header_->lightColor[0], header_->lightColor[1],
+                    header_->lightColor[2], header_->lightColor[3]);
+    l.intensity = header_->lightIntensity;
+    l.radius = header_->lightRadius;
+    return l;
+}
+
+Camera MappedScene::camera() const {
+    Camera c;
+    c.position = loadVec3(header_->cameraPosition);
+    c.target = loadVec3(header_->cameraTarget);
+    c.up = loadVec3(header_->cameraUp);
+    c.fov = header_->cameraFov;
+    return c;
+}
+
+Color MappedScene::backgroundColor() const {
+    return Color(header_->backgroundColor[0], header_->backgroundColor[1],
+                 header_->backgroundColor[2], header_->backgroundColor[3]);
+}
+
+Scene MappedScene::toScene() const {
+    Scene scene;
+    scene.meshes.reserve(meshCount());
+
+    auto region = [this](const SceneFileFace& face) {
+        const Color* px = texels(face);
+        return TextureRegion(face.width, face.height,
+                             std::vector<Color>(px, px + face.width * face.height));
+    };
+
+    for (uint32_t i = 0; i < meshCount(); ++i) {
+        const SceneFileMesh& rec = mesh(i);
+
+        BodyPartTexture tex;
+        tex.front  = region(rec.faces[0]);
+        tex.back   = region(rec.faces[1]);
+        tex.left   = region(rec.faces[2]);
+        tex.right  = region(rec.faces[3]);
+        tex.top    = region(rec.faces[4]);
+        tex.bottom = region(rec.faces[5]);
+
+        Vec3 bmin = loadVec3(rec.boxMin);
+        Vec3 bmax = loadVec3(rec.boxMax);
+        Vec3 center = (bmin + bmax) * 0.5f;
+        Vec3 size = bmax - bmin;
+
+        Mesh m = (rec.flags & SceneFileMesh::ROTATED)
+            ? MeshBuilder::buildBoxWithPose(tex, center, size, 0.0f, loadVec3(rec.pivot),
+                                            PartPose{rec.rotX, rec.rotZ})
+            : MeshBuilder::buildBox(tex, center, size, 0.0f);
+        m.isOuterLayer = (rec.flags & SceneFileMesh::OUTER_LAYER) != 0;
+        scene.meshes.push_back(std::move(m));
+    }
+
+    scene.light = light();
+    scene.camera = camera();
+    scene.backgroundColor = backgroundColor();
+    return scene;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "io/mapped_file.h"
+#include "scene/scene.h"
+#include "skin/skin_parser.h"
+
+// 预编译场景文件 (.mcscene)
+//
+// A versioned, position-independent binary snapshot of a compiled Scene:
+// box bounds, pose transforms and face texels. Every cross reference is an
+// element offset, so SceneFile::open maps the file and validates it
+// without parsing, and MappedScene reads the records in place.
+//
+// What it saves is the skin path up to the Scene: PNG decoding, region
+// extraction, mirroring and transparency checks. The ray tracer renders a
+// Scene, so toScene() still copies the texels and builds the box meshes
+// (one allocation per mesh and face).
+//
+// Layout (all sections 16-byte aligned, little-endian host order):
+//   SceneFileHeader
+//   SceneFileMesh[meshCount]
+//   Color[texelCount]            face texels, row-major per face
+
+static constexpr uint32_t SCENE_FILE_VERSION = 2;
+static constexpr uint32_t SCENE_FILE_BYTE_ORDER = 0x01020304u;
+
+struct SceneFileFace {
+    uint32_t texelOffset;   // index of the first texel in the texel section
+    uint16_t width;
+    uint16_t height;
+};
+
+struct SceneFileMesh {
+    enum Flags : uint32_t {
+        OUTER_LAYER = 1u << 0,
+        ROTATED     = 1u << 1,
+    };
+
+    float boxMin[3];        // unrotated (local-space) bounds
+    float boxMax[3];
+    float pivot[3];
+    float rotX;             // pitch degrees
+    float rotZ;             // roll degrees
+    uint32_t flags;
+    // Face order matches Mesh::ownedTextures: front, back, left, right, top, bottom
+    SceneFileFace faces[6];
+};
+
+struct SceneFileHeader {
+    char magic[4];          // "MCSC"
+    uint32_t version;
+    uint32_t byteOrder;     // SCENE_FILE_BYTE_ORDER as written by the producer
+    uint32_t reserved;
+
+    uint32_t meshCount;
+    uint32_t texelCount;
+
+    uint64_t meshOffset;
+    uint64_t texelOffset;
+    uint64_t fileSize;
+
+    // Light
+    float lightPosition[3];
+    float lightColor[4];
+    float lightIntensity;
+    float lightRadius;
+
+    // Camera
+    float cameraPosition[3];
+    float cameraTarget[3];
+    float cameraUp[3];
+    float cameraFov;
+
+    float backgroundColor[4];
+};
+
+// Read-only view of a scene file mapped into memory.
+// All accessors return pointers into the mapping; they stay valid for
+// the lifetime of this object.
+class MappedScene {
+public:
+    const SceneFileHeader& header() const { return *header_; }
+    uint32_t meshCount() const { return header_->meshCount; }
+    const SceneFileMesh& mesh(uint32_t index) const { return meshes_[index]; }
+
+    // Texels of one face (width * height entries, row-major)
+    const Color* texels(const SceneFileFace& face) const { return texels_ + face.texelOffset; }
+
+    Light light() const;
+    Camera camera() const;
+    Color backgroundColor() const;
+
+    // Materialize an owning Scene for the ray tracer and the preview.
+    // This copies every face's texels and rebuilds every mesh, but skips
+    // PNG decoding, skin region extraction and transparency checks.
+    Scene toScene() const;
+
+private:
+    friend class SceneFile;
+
+    MappedFile file_;
+    const SceneFileHeader* header_ = nullptr;
+    const SceneFileMesh* meshes_ = nullptr;
+    const Color* texels_ = nullptr;
+};
+
+class SceneFile {
+public:
+    // Serialize a scene built by MeshBuilder (every mesh is a textured box).
+    // Returns false if the scene cannot be represented or the file cannot be written.
+    static bool write(const Scene& scene, const std::string& path);
+
+    // Map a scene file and validate its header and section bounds.
+    static Result<MappedScene, std::string> open(const std::string& path);
+};
@@ -0,0 +1,286 @@
+#include "skin/batch_skin_fetcher.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QUrl>
+#include <QStandardPaths>
+#include <QDir>
+
+// Mojang's bulk lookup accepts at most 10 names per request
+static constexpr int UUID_BATCH_SIZE = 10;
+
+static std::string cacheKey(const char* kind, const QString& id) {
+    return std::string(kind) + ":" + id.toStdString();
+}
+
+static std::string resolveCacheDir(const QString& dir) {
+    if (!dir.isEmpty()) return QDir(dir).absolutePath().toStdString();
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+            + QStringLiteral("/skins")).toStdString();
+}
+
+static QByteArray toByteArray(const std::vector<uint8_t>& data) {
+    return QByteArray(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()));
+}
+
+SkinFetchEndpoints SkinFetchEndpoints::defaultEndpoints() {
+    SkinFetchEndpoints e;
+    QString api = qEnvironmentVariable("MCSKIN_API_BASE");
+    QString session = qEnvironmentVariable("MCSKIN_SESSION_BASE");
+    if (!api.isEmpty()) e.apiBase = api;
+    if (!session.isEmpty()) e.sessionBase = session;
+    return e;
+}
+
+BatchSkinFetcher::BatchSkinFetcher(const BatchFetchOptions& options, QObject* parent)
+    : QObject(parent)
+    , options_(options)
+    , nam_(new QNetworkAccessManager(this))
+    , cache_(resolveCacheDir(options.cacheDir))
+{
+    if (options_.maxConcurrent < 1) options_.maxConcurrent = 1;
+}
+
+// ── Request queue ───────────────────────────────────────────────────────────
+
+void BatchSkinFetcher::enqueue(const QNetworkRequest& request, const QByteArray& postBody,
+                               ReplyHandler handler) {
+    queue_.push_back({request, postBody, std::move(handler)});
+    pump();
+}
+
+void BatchSkinFetcher::pump() {
+    while (!queue_.empty() && inFlight_.size() < options_.maxConcurrent) {
+        PendingRequest pending = std::move(queue_.front());
+        queue_.pop_front();
+
+        QNetworkReply* reply = pending.postBody.isEmpty()
+            ? nam_->get(pending.request)
+            : nam_->post(pending.request, pending.postBody);
+        inFlight_.append(reply);
+
+        connect(reply, &QNetworkReply::finished, this,
+                [this, reply, handler = std::move(pending.handler)]() {
+            reply->deleteLater();
+            inFlight_.removeOne(reply);
+            handler(reply);
+            pump();
+        });
+    }
+}
+
+void BatchSkinFetcher::cancel() {
+    queue_.clear();
+    const QList<QNetworkReply*> replies = inFlight_;
+    inFlight_.clear();
+    for (QNetworkReply* reply : replies) {
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+    if (completed_ != total_) {
+        completed_ = total_ = 0;
+        emit finished();
+    }
+}
+
+// ── Fetch chain ─────────────────────────────────────────────────────────────
+
+void BatchSkinFetcher::fetch(const QStringList& usernames) {
+    total_ += usernames.size();
+    emit progress(completed_, total_);
+
+    QStringList needLookup;
+    for (const QString& name : usernames) {
+        auto cached = cache_.lookup(cacheKey("uuid", name.toLower()), options_.uuidTtl);
+        if (cached && cached->fresh) {
+            fetchProfile(name, QString::fromUtf8(toByteArray(cached->data)));
+        } else {
+            needLookup.append(name);
+        }
+    }
+
+    for (int i = 0; i < needLookup.size(); i += UUID_BATCH_SIZE) {
+        lookupUuids(needLookup.mid(i, UUID_BATCH_SIZE));
+    }
+}
+
+void BatchSkinFetcher::lookupUuids(const QStringList& usernames) {
+    QNetworkRequest req(QUrl(options_.endpoints.apiBase + QStringLiteral("/profiles/minecraft")));
+    req.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    QByteArray body = QJsonDocument(QJsonArray::fromStringList(usernames)).toJson(QJsonDocument::Compact);
+
+    enqueue(req, body, [this, usernames](QNetworkReply* reply) {
+        if (reply->error() != QNetworkReply::NoError) {
+            // Fall back to whatever we resolved last time
+            for (const QString& name : usernames) {
+                auto stale = cache_.lookup(cacheKey("uuid", name.toLower()), options_.uuidTtl);
+                if (stale) {
+                    fetchProfile(name, QString::fromUtf8(toByteArray(stale->data)));
+                } else {
+                    fail(name, tr("查询 UUID 失败: %1").arg(reply->errorString()));
+                }
+            }
+            return;
+        }
+
+        // Response: [{"id": "...", "name": "..."}], unknown names are omitted
+        QHash<QString, QString> ids;
+        const QJsonArray results = QJsonDocument::fromJson(reply->readAll()).array();
+        for (const auto& v : results) {
+            QJsonObject obj = v.toObject();
+            ids.insert(obj.value("name").toString().toLower(), obj.value("id").toString());
+        }
+
+        for (const QString& name : usernames) {
+            QString uuid = ids.value(name.toLower());
+            if (uuid.isEmpty()) {
+                fail(name, tr("找不到用户: %1").arg(name));
+                continue;
+            }
+            QByteArray bytes = uuid.toUtf8();
+            cache_.store(cacheKey("uuid", name.toLower()),
+                         reinterpret_cast<const uint8_t*>(bytes.constData()),
+                         static_cast<size_t>(bytes.size()));
+            fetchProfile(name, uuid);
+        }
+    });
+}
+
+void BatchSkinFetcher::fetchProfile(const QString& username, const QString& uuid) {
+    const std::string key = cacheKey("profile", uuid);
+    auto cached = cache_.lookup(key, options_.profileTtl);
+    if (cached && cached->fresh) {
+        handleProfile(username, toByteArray(cached->data));
+        return;
+    }
+
+    QNetworkRequest req(QUrl(options_.endpoints.sessionBase
+                             + QStringLiteral("/session/minecraft/profile/") + uuid));
+    enqueue(req, QByteArray(), [this, username, key, cached](QNetworkReply* reply) {
+        if (reply->error() != QNetworkReply::NoError) {
+            if (cached) {
+                handleProfile(username, toByteArray(cached->data));
+            } else {
+                fail(username, tr("查询玩家档案失败: %1").arg(reply->errorString()));
+            }
+            return;
+        }
+        QByteArray json = reply->readAll();
+        cache_.store(key, reinterpret_cast<const uint8_t*>(json.constData()),
+                     static_cast<size_t>(json.size()));
+        handleProfile(username, json);
+    });
+}
+
+QString BatchSkinFetcher::skinUrlFromProfile(const QByteArray& profileJson, QString* errorMessage) {
+    auto setError = [errorMessage](const QString& msg) {
+        if (errorMessage) *errorMessage = msg;
+        return QString();
+    };
+
+    QJsonDocument doc = QJsonDocument::fromJson(profileJson);
+    if (!doc.isObject()) {
+        return setError(tr("玩家档案返回了无效的 JSON"));
+    }
+
+    // Parse properties array, find "textures" entry
+    QJsonArray properties = doc.object().value("properties").toArray();
+    QString texturesBase64;
+    for (const auto& prop : properties) {
+        QJsonObject obj = prop.toObject();
+        if (obj.value("name").toString() == "textures") {
+            texturesBase64 = obj.value("value").toString();
+            break;
+        }
+    }
+    if (texturesBase64.isEmpty()) {
+        return setError(tr("该玩家没有皮肤数据"));
+    }
+
+    // Decode base64 → JSON → skin URL
+    QByteArray decoded = QByteArray::fromBase64(texturesBase64.toUtf8());
+    QJsonDocument texDoc = QJsonDocument::fromJson(decoded);
+    if (!texDoc.isObject()) {
+        return setError(tr("皮肤纹理数据解析失败"));
+    }
+
+    QJsonObject textures = texDoc.object().value("textures").toObject();
+    QString skinUrl = textures.value("SKIN").toObject().value("url").toString();
+    if (skinUrl.isEmpty()) {
+        return setError(tr("该玩家未设置自定义皮肤"));
+    }
+    return skinUrl;
+}
+
+void BatchSkinFetcher::handleProfile(const QString& username, const QByteArray& profileJson) {
+    QString message;
+    QString url = skinUrlFromProfile(profileJson, &message);
+    if (url.isEmpty()) {
+        fail(username, message);
+        return;
+    }
+    fetchSkin(username, url);
+}
+
+void BatchSkinFetcher::fetchSkin(const QString& username, const QString& url) {
+    const std::string key = cacheKey("skin", url);
+    auto cached = cache_.lookup(key, options_.skinTtl);
+    if (cached && cached->fresh) {
+        succeed(username, toByteArray(cached->data));
+        return;
+    }
+
+    QNetworkRequest req{QUrl(url)};
+    if (cached && !cached->etag.empty()) {
+        req.setRawHeader("If-None-Match", QByteArray::fromStdString(cached->etag));
+    }
+
+    enqueue(req, QByteArray(), [this, username, key, cached](QNetworkReply* reply) {
+        int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status == 304 && cached) {
+            cache_.touch(key);
+            succeed(username, toByteArray(cached->data));
+            return;
+        }
+        if (reply->error() != QNetworkReply::NoError) {
+            if (cached) {
+                succeed(username, toByteArray(cached->data));
+            } else {
+                fail(username, tr("下载皮肤失败: %1").arg(reply->errorString()));
+            }
+            return;
+        }
+
+        QByteArray data = reply->readAll();
+        if (data.isEmpty()) {
+            fail(username, tr("下载的皮肤文件为空"));
+            return;
+        }
+        cache_.store(key, reinterpret_cast<const uint8_t*>(data.constData()),
+                     static_cast<size_t>(data.size()), reply->rawHeader("ETag").toStdString());
+        succeed(username, data);
+    });
+}
+
+// ── Completion ──────────────────────────────────────────────────────────────
+
+void BatchSkinFetcher::succeed(const QString& username, const QByteArray& pngData) {
+    emit skinFetched(username, pngData);
+    complete();
+}
+
+void BatchSkinFetcher::fail(const QString& username, const QString& message) {
+    emit fetchFailed(username, message);
+    complete();
+}
+
+void BatchSkinFetcher::complete() {
+    ++completed_;
+    emit progress(completed_, total_);
+    if (completed_ == total_) {
+        completed_ = total_ = 0;
+        emit finished();
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <deque>
+#include <functional>
+#include "skin/skin_cache.h"
+
+// Mojang endpoints. Override to point at a local stand-in server; the
+// MCSKIN_API_BASE / MCSKIN_SESSION_BASE environment variables are honoured
+// by defaultEndpoints().
+struct SkinFetchEndpoints {
+    QString apiBase = QStringLiteral("https://api.mojang.com");
+    QString sessionBase = QStringLiteral("https://sessionserver.mojang.com");
+
+    static SkinFetchEndpoints defaultEndpoints();
+};
+
+struct BatchFetchOptions {
+    SkinFetchEndpoints endpoints = SkinFetchEndpoints::defaultEndpoints();
+    int maxConcurrent = 8;              // requests in flight at once
+    QString cacheDir;                   // empty = <CacheLocation>/skins
+    int64_t uuidTtl = 7 * 24 * 3600;    // username → UUID rarely changes
+    int64_t profileTtl = 10 * 60;       // profile carries the current skin URL
+    int64_t skinTtl = 30 * 24 * 3600;   // texture URLs are content-addressed
+};
+
+// Fetches skins for many players at once.
+//
+// Usernames are resolved to UUIDs in bulk (up to 10 names per POST), then
+// each player's profile and skin PNG are requested with at most
+// maxConcurrent requests in flight. UUIDs, profiles and skin bytes are kept
+// in a SkinCache: fresh entries skip the network, stale skins are
+// revalidated with If-None-Match, and stale data is used if a request fails.
+class BatchSkinFetcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BatchSkinFetcher(const BatchFetchOptions& options = BatchFetchOptions{},
+                              QObject* parent = nullptr);
+
+    // Queue usernames. May be called again while a batch is running.
+    void fetch(const QStringList& usernames);
+
+    // Drop queued requests and abort the ones in flight
+    void cancel();
+
+    bool isIdle() const { return completed_ == total_; }
+
+    // Extract the skin URL from a session-server profile JSON.
+    // Returns an empty string and sets *errorMessage on failure.
+    static QString skinUrlFromProfile(const QByteArray& profileJson, QString* errorMessage);
+
+signals:
+    void skinFetched(const QString& username, const QByteArray& pngData);
+    void fetchFailed(const QString& username, const QString& message);
+    void progress(int completed, int total);
+    // Emitted when every queued username has succeeded or failed
+    void finished();
+
+private:
+    using ReplyHandler = std::function<void(QNetworkReply*)>;
+
+    struct PendingRequest {
+        QNetworkRequest request;
+        QByteArray postBody;        // empty = GET
+        ReplyHandler handler;
+    };
+
+    void enqueue(const QNetworkRequest& request, const QByteArray& postBody, ReplyHandler handler);
+    void pump();
+
+    void lookupUuids(const QStringList& usernames);
+    void fetchProfile(const QString& username, const QString& uuid);
+    void handleProfile(const QString& username, const QByteArray& profileJson);
+    void fetchSkin(const QString& username, const QString& url);
+
+    void succeed(const QString& username, const QByteArray& pngData);
+    void fail(const QString& username, const QString& message);
+    void complete();
+
+    BatchFetchOptions options_;
+    QNetworkAccessManager* nam_;
+    SkinCache cache_;
+
+    std::deque<PendingRequest> queue_;
+    QList<QNetworkReply*> inFlight_;
+    int total_ = 0;
+    int completed_ = 0;
+};
@@ -1,6 +1,7 @@
 #include "skin/image.h"
 #include <stb/stb_image.h>
 #include <stb/stb_image_write.h>
+#include <climits>
 #include <cstdint>
 
 std::optional<Image> Image::load(const std::string& path) {
@@ -24,6 +25,38 @@ std::optional<Image> Image::load(const std::string& path) {
     return img;
 }
 
+// Take ownership of an stb_image RGBA buffer
+static Rgba8Image fromStb(unsigned char* data, int w, int h) {
+    Rgba8Image img;
+    img.width = w;
+    img.height = h;
+    img.pixels.assign(data, data + static_cast<size_t>(w) * h * 4);
+    stbi_image_free(data);
+    return img;
+}
+
+std::optional<Rgba8Image> Rgba8Image::load(const std::string& path) {
+    int w, h, channels;
+    unsigned char* data = stbi_load(path.c_str(), &w, &h, &channels, 4);  // force RGBA
+    if (!data) {
+        return std::nullopt;
+    }
+    return fromStb(data, w, h);
+}
+
+std::optional<Rgba8Image> Rgba8Image::decode(const uint8_t* bytes, size_t size) {
+    if (!bytes || size == 0 || size > static_cast<size_t>(INT_MAX)) {
+        return std::nullopt;
+    }
+    int w, h, channels;
+    unsigned char* data = stbi_load_from_memory(bytes, static_cast<int>(size),
+                                                &w, &h, &channels, 4);  // force RGBA
+    if (!data) {
+        return std::nullopt;
+    }
+    return fromStb(data, w, h);
+}
+
 void Image::savePNG(const std::string& path) const {
     std::vector<uint8_t> data(width * height * 4);
     for (int i = 0; i < width * height; ++i) {
@@ -1,11 +1,51 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <optional>
 #include "math/color.h"
 #include "skin/texture_region.h"
 
+// Non-owning view of 8-bit RGBA pixels, e.g. a decoded PNG or a skin pack entry
+struct Rgba8View {
+    const uint8_t* data = nullptr;  // row-major RGBA, width * height * 4 bytes
+    int width = 0;
+    int height = 0;
+
+    // Extract a rectangular sub-region as a TextureRegion
+    TextureRegion extractRegion(int x, int y, int w, int h) const {
+        TextureRegion region(w, h);
+        for (int row = 0; row < h; ++row) {
+            for (int col = 0; col < w; ++col) {
+                int srcX = x + col;
+                int srcY = y + row;
+                if (srcX >= 0 && srcX < width && srcY >= 0 && srcY < height) {
+                    const uint8_t* p = data + (srcY * width + srcX) * 4;
+                    region.pixels[row * w + col] = Color(
+                        p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, p[3] / 255.0f);
+                }
+            }
+        }
+        return region;
+    }
+};
+
+// Owning 8-bit RGBA pixel buffer (PNG decoded without float expansion)
+struct Rgba8Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;  // row-major RGBA
+
+    // Load a PNG file. Returns std::nullopt on failure.
+    static std::optional<Rgba8Image> load(const std::string& path);
+
+    // Decode an in-memory PNG. Returns std::nullopt on failure.
+    static std::optional<Rgba8Image> decode(const uint8_t* data, size_t size);
+
+    Rgba8View view() const { return {pixels.data(), width, height}; }
+};
+
 struct Image {
     int width = 0;
     int height = 0;
@@ -0,0 +1,150 @@
+#include "skin/skin_cache.h"
+#include "io/hash.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <type_traits>
+
+namespace fs = std::filesystem;
+
+static constexpr char ENTRY_MAGIC[4] = {'M', 'C', 'S', 'E'};
+static constexpr uint32_t ENTRY_VERSION = 1;
+
+struct CacheEntryHeader {
+    char magic[4];          // "MCSE"
+    uint32_t version;
+    int64_t storedAt;
+    uint32_t keyLength;
+    uint32_t etagLength;
+    uint64_t dataLength;
+};
+
+static_assert(std::is_trivially_copyable<CacheEntryHeader>::value, "header must be POD");
+
+SkinCache::SkinCache(std::string directory)
+    : directory_(std::move(directory))
+{
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+}
+
+int64_t SkinCache::nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string SkinCache::pathFor(const std::string& key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".entry", fnv1a64(key.data(), key.size()));
+    return (fs::path(directory_) / name).string();
+}
+
+std::optional<SkinCacheEntry> SkinCache::lookup(const std::string& key, int64_t ttlSeconds,
+                                                int64_t now) const {
+    const std::string path = pathFor(key);
+    std::error_code ec;
+    const uint64_t fileSize = fs::file_size(path, ec);
+    if (ec) return std::nullopt;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+
+    // The stored lengths must add up to the file size exactly, so a corrupt
+    // or truncated entry never sizes a buffer
+    CacheEntryHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0
+        || header.version != ENTRY_VERSION
+        || header.keyLength != key.size()
+        || fileSize < sizeof(header) + header.keyLength) {
+        return std::nullopt;
+    }
+    const uint64_t payload = fileSize - sizeof(header) - header.keyLength;
+    if (header.etagLength > payload || header.dataLength != payload - header.etagLength) {
+        return std::nullopt;
+    }
+
+    std::string storedKey(header.keyLength, '\0');
+    if (!in.read(&storedKey[0], static_cast<std::streamsize>(storedKey.size()))
+        || storedKey != key) {
+        return std::nullopt;
+    }
+
+    SkinCacheEntry entry;
+    entry.etag.resize(header.etagLength);
+    entry.data.resize(static_cast<size_t>(header.dataLength));
+    if (!in.read(&entry.etag[0], static_cast<std::streamsize>(entry.etag.size()))
+        || !in.read(reinterpret_cast<char*>(entry.data.data()),
+                    static_cast<std::streamsize>(entry.data.size()))) {
+        return std::nullopt;
+    }
+
+    entry.storedAt = header.storedAt;
+    entry.fresh = now - header.storedAt < ttlSeconds;
+    return entry;
+}
+
+bool SkinCache::store(const std::string& key, const uint8_t* data, size_t size,
+                      const std::string& etag, int64_t now) {
+    CacheEntryHeader header{};
+    std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+    header.version = ENTRY_VERSION;
+    header.storedAt = now;
+    header.keyLength = static_cast<uint32_t>(key.size());
+    header.etagLength = static_cast<uint32_t>(etag.size());
+    header.dataLength = size;
+
+    // A temp name of its own per writer: processes sharing the cache may
+    // store the same key at once, and the last rename wins
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016" PRIx64 ".tmp", static_cast<uint64_t>(rng()));
+    const std::string path = pathFor(key);
+    const std::string tmpPath = path + suffix;
+
+    std::error_code ec;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        out.write(etag.data(), static_cast<std::streamsize>(etag.size()));
+        if (size > 0) out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        out.close();
+        if (!out) {
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool SkinCache::touch(const std::string& key, int64_t now) {
+    std::fstream file(pathFor(key), std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) return false;
+
+    CacheEntryHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0
+        || header.version != ENTRY_VERSION) {
+        return false;
+    }
+    header.storedAt = now;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+void SkinCache::remove(const std::string& key) {
+    std::error_code ec;
+    fs::remove(pathFor(key), ec);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// 皮肤下载缓存
+//
+// A small persistent key → bytes cache used by the skin fetcher for
+// username → UUID lookups, session profiles and skin PNGs. Each entry keeps
+// the server's ETag and the time it was stored, so callers can serve fresh
+// entries directly, revalidate stale ones with If-None-Match, and fall back
+// to stale data when the network is unavailable.
+//
+// One file per key (<fnv1a64(key)>.entry) under the cache directory; the key
+// is stored in the file as well so a hash collision reads as a miss.
+// Writes go to a temporary file with a random suffix and are renamed into
+// place, so processes sharing the directory never write the same temp file.
+
+struct SkinCacheEntry {
+    std::vector<uint8_t> data;
+    std::string etag;
+    int64_t storedAt = 0;   // seconds since epoch
+    bool fresh = false;     // storedAt + ttl > now
+};
+
+class SkinCache {
+public:
+    explicit SkinCache(std::string directory);
+
+    const std::string& directory() const { return directory_; }
+
+    // Read an entry. Stale entries are returned with fresh == false;
+    // std::nullopt means there is no usable entry for this key.
+    std::optional<SkinCacheEntry> lookup(const std::string& key, int64_t ttlSeconds,
+                                         int64_t now = nowSeconds()) const;
+
+    // Store or replace an entry. Returns false if it cannot be written.
+    bool store(const std::string& key, const uint8_t* data, size_t size,
+               const std::string& etag = std::string(), int64_t now = nowSeconds());
+
+    // Mark an entry as just revalidated (HTTP 304) without rewriting its data
+    bool touch(const std::string& key, int64_t now = nowSeconds());
+
+    void remove(const std::string& key);
+
+    static int64_t nowSeconds();
+
+private:
+    std::string pathFor(const std::string& key) const;
+
+    std::string directory_;
+};
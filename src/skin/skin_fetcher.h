@@ -2,11 +2,13 @@
 
 #include <QObject>
 #include <QString>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
+#include <QByteArray>
+#include "skin/batch_skin_fetcher.h"
 
 // Fetches a Minecraft Java Edition player skin from Mojang API.
 // Flow: username → UUID → profile (base64 textures) → skin PNG download.
+// Single-player front end over BatchSkinFetcher, so lookups share its
+// on-disk cache.
 class SkinFetcher : public QObject {
     Q_OBJECT
 
@@ -17,17 +19,11 @@ public:
     void fetch(const QString& username);
 
 signals:
-    // Emitted when the skin PNG has been saved to a temp file.
-    void finished(const QString& filePath);
+    // Emitted with the downloaded skin PNG bytes (no temp file round-trip).
+    void finished(const QByteArray& pngData);
     // Emitted on any error during the fetch chain.
     void error(const QString& message);
 
-private slots:
-    void onUuidReply(QNetworkReply* reply);
-    void onProfileReply(QNetworkReply* reply);
-    void onSkinReply(QNetworkReply* reply);
-
 private:
-    QNetworkAccessManager* nam_;
-    QString username_;
+    BatchSkinFetcher* batch_;
 };
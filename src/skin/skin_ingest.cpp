@@ -0,0 +1,273 @@
+#include "skin/skin_ingest.h"
+#include "io/hash.h"
+#include "scene/mesh_builder.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+static_assert(std::is_trivially_copyable<SkinIndexHeader>::value, "header must be POD");
+static_assert(sizeof(SkinIndexRecord) == 24, "unexpected padding in SkinIndexRecord");
+
+static constexpr char INDEX_MAGIC[4] = {'M', 'C', 'S', 'I'};
+static constexpr uint32_t INDEX_BYTE_ORDER = 0x01020304u;
+
+static uint64_t alignUp(uint64_t v, uint64_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+static bool isPng(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".png";
+}
+
+// ── Ingestion ───────────────────────────────────────────────────────────────
+
+std::vector<std::string> SkinIngest::collectPngFiles(const std::vector<std::string>& inputs,
+                                                     std::vector<std::string>* missing) {
+    std::vector<std::string> files;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            for (const auto& entry : fs::recursive_directory_iterator(input, ec)) {
+                if (entry.is_regular_file() && isPng(entry.path())) {
+                    files.push_back(entry.path().string());
+                }
+            }
+        } else if (fs::is_regular_file(input, ec)) {
+            files.push_back(input);
+        } else if (missing) {
+            missing->push_back(input);
+        }
+    }
+    // Sorted so that pack and index order is reproducible
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+uint8_t SkinIngest::outerLayerMask(const SkinData& skin) {
+    const BodyPartTexture* parts[] = {
+        &skin.headOuter, &skin.bodyOuter, &skin.rightArmOuter,
+        &skin.leftArmOuter, &skin.rightLegOuter, &skin.leftLegOuter,
+    };
+    uint8_t mask = 0;
+    for (int i = 0; i < 6; ++i) {
+        if (!MeshBuilder::isFullyTransparent(*parts[i])) {
+            mask |= static_cast<uint8_t>(1u << i);
+        }
+    }
+    return mask;
+}
+
+SkinMetadata SkinIngest::inspect(const std::string& path, const uint8_t* data, size_t size) {
+    SkinMetadata meta;
+    meta.path = path;
+    meta.fileSize = size;
+
+    // Reject wrong-sized or non-PNG files before paying for inflate
+    auto header = SkinParser::checkPngHeader(data, size);
+    if (!header.isOk()) {
+        meta.error = *header.error;
+        return meta;
+    }
+
+    auto img = Rgba8Image::decode(data, size);
+    if (!img) {
+        meta.error = "Failed to decode PNG image";
+        return meta;
+    }
+
+    auto skin = SkinParser::parse(img->view());
+    if (!skin.isOk()) {
+        meta.error = *skin.error;
+        return meta;
+    }
+
+    meta.valid = true;
+    meta.format = skin.value->format;
+    meta.outerMask = outerLayerMask(*skin.value);
+    meta.contentHash = fnv1a64(img->pixels.data(), img->pixels.size());
+    return meta;
+}
+
+SkinMetadata SkinIngest::inspectFile(const std::string& path) {
+    auto file = MappedFile::open(path);
+    if (!file) {
+        SkinMetadata meta;
+        meta.path = path;
+        meta.error = "Failed to read file: " + path;
+        return meta;
+    }
+    return inspect(path, file->data(), file->size());
+}
+
+std::vector<SkinMetadata> SkinIngest::run(const std::vector<std::string>& paths,
+                                          int threadCount,
+                                          std::function<void(size_t, size_t)> progressCallback) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+
+    const size_t total = paths.size();
+    std::vector<SkinMetadata> results(total);
+    if (total == 0) {
+        return results;
+    }
+
+    // Each worker owns its slot in `results`, so only progress needs a lock.
+    // Files are mapped rather than read so decoding runs straight off the
+    // page cache and many reads stay in flight at once.
+    std::atomic<size_t> nextFile{0};
+    std::atomic<size_t> completed{0};
+    std::mutex progressMutex;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t idx = nextFile.fetch_add(1);
+            if (idx >= total) break;
+
+            results[idx] = inspectFile(paths[idx]);
+
+            size_t done = completed.fetch_add(1) + 1;
+            if (progressCallback) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                progressCallback(done, total);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t numThreads = std::min(static_cast<size_t>(threadCount), total);
+    threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return results;
+}
+
+SkinCorpusStats SkinIngest::summarize(const std::vector<SkinMetadata>& skins) {
+    SkinCorpusStats stats;
+    std::unordered_set<uint64_t> seen;
+    for (const auto& s : skins) {
+        ++stats.total;
+        stats.totalBytes += s.fileSize;
+        if (!s.valid) {
+            ++stats.invalid;
+            continue;
+        }
+        ++stats.valid;
+        if (s.format == SkinData::NEW_64x64) ++stats.modern;
+        else ++stats.legacy;
+        if (s.outerMask) ++stats.withOuterLayer;
+        else ++stats.transparentOuter;
+        if (!seen.insert(s.contentHash).second) ++stats.duplicates;
+    }
+    return stats;
+}
+
+// ── Index file ──────────────────────────────────────────────────────────────
+
+bool SkinIndex::write(const std::vector<SkinMetadata>& skins, const std::string& path) {
+    std::vector<SkinIndexRecord> records;
+    std::string paths;
+    for (const auto& s : skins) {
+        if (!s.valid) continue;
+        // Path lengths are uint16_t, path offsets and the record count uint32_t
+        if (s.path.size() > UINT16_MAX) return false;
+        if (paths.size() + s.path.size() > UINT32_MAX || records.size() == UINT32_MAX) return false;
+        SkinIndexRecord r{};
+        r.contentHash = s.contentHash;
+        r.fileSize = s.fileSize;
+        r.pathOffset = static_cast<uint32_t>(paths.size());
+        r.pathLength = static_cast<uint16_t>(s.path.size());
+        r.format = static_cast<uint8_t>(s.format);
+        r.outerMask = s.outerMask;
+        records.push_back(r);
+        paths += s.path;
+    }
+
+    SkinIndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = SKIN_INDEX_VERSION;
+    header.byteOrder = INDEX_BYTE_ORDER;
+    header.recordCount = static_cast<uint32_t>(records.size());
+    header.recordOffset = alignUp(sizeof(SkinIndexHeader), 8);
+    header.pathOffset = header.recordOffset + records.size() * sizeof(SkinIndexRecord);
+    header.fileSize = header.pathOffset + paths.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    static const char zeros[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(zeros, static_cast<std::streamsize>(header.recordOffset - sizeof(header)));
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(SkinIndexRecord)));
+    out.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+    return static_cast<bool>(out);
+}
+
+Result<SkinIndex, std::string> SkinIndex::open(const std::string& path) {
+    using R = Result<SkinIndex, std::string>;
+
+    auto file = MappedFile::open(path);
+    if (!file) {
+        return R::err("Failed to map skin index: " + path);
+    }
+
+    const uint64_t size = file->size();
+    if (size < sizeof(SkinIndexHeader)) {
+        return R::err("Skin index is truncated: " + path);
+    }
+
+    const auto* header = reinterpret_cast<const SkinIndexHeader*>(file->data());
+    if (std::memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return R::err("Not a skin index: " + path);
+    }
+    if (header->version != SKIN_INDEX_VERSION) {
+        return R::err("Unsupported skin index version " + std::to_string(header->version)
+                      + " (expected " + std::to_string(SKIN_INDEX_VERSION) + ")");
+    }
+    if (header->byteOrder != INDEX_BYTE_ORDER) {
+        return R::err("Skin index was written with a different byte order");
+    }
+    if (header->fileSize != size
+        || header->recordOffset % 8 != 0
+        || header->recordOffset + uint64_t(header->recordCount) * sizeof(SkinIndexRecord) > header->pathOffset
+        || header->pathOffset > size) {
+        return R::err("Skin index section out of bounds: " + path);
+    }
+
+    SkinIndex index;
+    const uint8_t* base = file->data();
+    index.header_ = header;
+    index.records_ = reinterpret_cast<const SkinIndexRecord*>(base + header->recordOffset);
+    index.paths_ = reinterpret_cast<const char*>(base + header->pathOffset);
+
+    const uint64_t pathBytes = size - header->pathOffset;
+    for (uint32_t i = 0; i < header->recordCount; ++i) {
+        const SkinIndexRecord& r = index.records_[i];
+        if (uint64_t(r.pathOffset) + r.pathLength > pathBytes
+            || r.format > SkinData::OLD_64x32) {
+            return R::err("Skin index record " + std::to_string(i) + " out of bounds");
+        }
+    }
+
+    index.file_ = std::move(*file);
+    return R::ok(std::move(index));
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "io/mapped_file.h"
+#include "skin/skin_parser.h"
+
+// 皮肤批量导入 (ingestion)
+//
+// Validates and classifies a folder of skin PNGs in parallel before a batch
+// run, and writes a compact index (.mcidx) that later batch renders can
+// iterate without re-decoding anything.
+
+// One bit per body part; set when that part's outer layer has at least one
+// non-transparent texel (i.e. MeshBuilder would emit an outer-layer mesh).
+enum OuterLayerBits : uint8_t {
+    OUTER_HEAD      = 1 << 0,
+    OUTER_BODY      = 1 << 1,
+    OUTER_RIGHT_ARM = 1 << 2,
+    OUTER_LEFT_ARM  = 1 << 3,
+    OUTER_RIGHT_LEG = 1 << 4,
+    OUTER_LEFT_LEG  = 1 << 5,
+};
+
+// Per-skin result of ingestion
+struct SkinMetadata {
+    std::string path;
+    bool valid = false;
+    std::string error;              // set when !valid
+    SkinData::Format format = SkinData::NEW_64x64;
+    uint8_t outerMask = 0;          // OuterLayerBits
+    uint64_t contentHash = 0;       // fnv1a64 of the RGBA8 texels (same as SkinPackEntry)
+    uint64_t fileSize = 0;
+};
+
+// Corpus-wide counts over a set of SkinMetadata
+struct SkinCorpusStats {
+    size_t total = 0;
+    size_t valid = 0;
+    size_t invalid = 0;
+    size_t modern = 0;              // 64×64
+    size_t legacy = 0;              // 64×32
+    size_t withOuterLayer = 0;      // any outer part visible
+    size_t transparentOuter = 0;    // all outer parts fully transparent
+    size_t duplicates = 0;          // valid skins whose content hash was already seen
+    uint64_t totalBytes = 0;
+};
+
+class SkinIngest {
+public:
+    // Expand files and directories (recursively) into a sorted list of
+    // *.png paths. Inputs that do not exist are appended to `missing`.
+    static std::vector<std::string> collectPngFiles(const std::vector<std::string>& inputs,
+                                                    std::vector<std::string>* missing = nullptr);
+
+    // Outer-layer opacity mask of a parsed skin (OuterLayerBits)
+    static uint8_t outerLayerMask(const SkinData& skin);
+
+    // Validate and classify one in-memory PNG. `path` is only recorded.
+    static SkinMetadata inspect(const std::string& path, const uint8_t* data, size_t size);
+
+    // Map a file and inspect it
+    static SkinMetadata inspectFile(const std::string& path);
+
+    // Inspect all paths on a worker pool (threadCount <= 0 means one per
+    // hardware thread). Results are in input order.
+    // progressCallback is called (completed, total) after each file.
+    static std::vector<SkinMetadata> run(const std::vector<std::string>& paths,
+                                         int threadCount = 0,
+                                         std::function<void(size_t, size_t)> progressCallback = nullptr);
+
+    static SkinCorpusStats summarize(const std::vector<SkinMetadata>& skins);
+};
+
+// ── Index file (.mcidx) ─────────────────────────────────────────────────────
+//
+// Layout (little-endian host order):
+//   SkinIndexHeader
+//   SkinIndexRecord[recordCount]      valid skins only, in ingestion order
+//   char[]                            paths, not NUL-terminated
+
+static constexpr uint32_t SKIN_INDEX_VERSION = 1;
+
+struct SkinIndexHeader {
+    char magic[4];          // "MCSI"
+    uint32_t version;
+    uint32_t byteOrder;     // 0x01020304 as written by the producer
+    uint32_t recordCount;
+    uint64_t recordOffset;
+    uint64_t pathOffset;
+    uint64_t fileSize;
+};
+
+struct SkinIndexRecord {
+    uint64_t contentHash;
+    uint64_t fileSize;
+    uint32_t pathOffset;    // relative to the path section
+    uint16_t pathLength;
+    uint8_t format;         // SkinData::Format
+    uint8_t outerMask;      // OuterLayerBits
+};
+
+// Read-only, memory-mapped skin index
+class SkinIndex {
+public:
+    // Write the valid entries of `skins`. Returns false if the file cannot be
+    // written, a path is longer than 65535 bytes, or the paths pass the
+    // 4 GiB the uint32_t offsets can address.
+    static bool write(const std::vector<SkinMetadata>& skins, const std::string& path);
+
+    static Result<SkinIndex, std::string> open(const std::string& path);
+
+    size_t size() const { return header_->recordCount; }
+    const SkinIndexRecord& record(size_t i) const { return records_[i]; }
+    std::string_view path(size_t i) const {
+        return std::string_view(paths_ + records_[i].pathOffset, records_[i].pathLength);
+    }
+
+private:
+    MappedFile file_;
+    const SkinIndexHeader* header_ = nullptr;
+    const SkinIndexRecord* records_ = nullptr;
+    const char* paths_ = nullptr;
+};
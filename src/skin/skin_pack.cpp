@@ -0,0 +1,260 @@
+#include "skin/skin_pack.h"
+#include "io/hash.h"
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<SkinPackHeader>::value, "header must be POD");
+static_assert(sizeof(SkinPackEntry) == 32, "unexpected padding in SkinPackEntry");
+
+static constexpr char PACK_MAGIC[4] = {'M', 'C', 'P', 'K'};
+static constexpr uint32_t PACK_BYTE_ORDER = 0x01020304u;
+static constexpr uint64_t TEXEL_ALIGN = 64;  // cache line
+static constexpr size_t TEXEL_HEAD = (sizeof(SkinPackHeader) + TEXEL_ALIGN - 1) / TEXEL_ALIGN * TEXEL_ALIGN;
+static constexpr int SKIN_WIDTH = 64;
+
+static uint32_t indexSlotsFor(size_t entryCount) {
+    uint32_t slots = 16;
+    while (slots < entryCount * 2) slots <<= 1;
+    return slots;
+}
+
+static uint64_t hashName(std::string_view name) {
+    return fnv1a64(name.data(), name.size());
+}
+
+// ── Builder ─────────────────────────────────────────────────────────────────
+
+// The index stores entry + 1 in uint32_t slots and needs twice as many
+// slots as entries
+static constexpr size_t MAX_ENTRIES = size_t(1) << 30;
+
+bool SkinPackBuilder::open(const std::string& path) {
+    out_ = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    texelBytes_ = 0;
+    entries_.clear();
+    index_.clear();
+    names_.clear();
+    growIndex(0);
+
+    // Zeroed header and padding up to the texel section; finish() fills it in
+    static const char zeros[TEXEL_HEAD] = {};
+    out_.write(zeros, sizeof(zeros));
+    return static_cast<bool>(out_);
+}
+
+uint32_t SkinPackBuilder::findSlot(std::string_view name, uint64_t hash) const {
+    const uint32_t mask = static_cast<uint32_t>(index_.size()) - 1;
+    uint32_t slot = static_cast<uint32_t>(hash) & mask;
+    while (index_[slot] != 0) {
+        const SkinPackEntry& e = entries_[index_[slot] - 1];
+        if (e.nameHash == hash
+            && std::string_view(names_.data() + e.nameOffset, e.nameLength) == name) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void SkinPackBuilder::growIndex(size_t entryCount) {
+    const uint32_t slots = indexSlotsFor(entryCount);
+    if (index_.size() >= slots) return;
+
+    // Linear probing; names are unique so every insert finds a free slot
+    index_.assign(slots, 0);
+    const uint32_t mask = slots - 1;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        uint32_t slot = static_cast<uint32_t>(entries_[i].nameHash) & mask;
+        while (index_[slot] != 0) slot = (slot + 1) & mask;
+        index_[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+Result<bool, std::string> SkinPackBuilder::add(const std::string& name, const Rgba8View& pixels) {
+    using R = Result<bool, std::string>;
+
+    if (!out_.is_open()) {
+        return R::err("Skin pack is not open");
+    }
+    if (name.empty() || name.size() > 0xFFFF) {
+        return R::err("Invalid entry name length: " + std::to_string(name.size()));
+    }
+    if (!pixels.data || pixels.width != SKIN_WIDTH
+        || (pixels.height != 64 && pixels.height != 32)) {
+        return R::err("Invalid skin dimensions for " + name + ": " +
+                      std::to_string(pixels.width) + "x" + std::to_string(pixels.height) +
+                      " (expected 64x64 or 64x32)");
+    }
+    // Name offsets are uint32_t
+    if (entries_.size() >= MAX_ENTRIES || names_.size() + name.size() > UINT32_MAX) {
+        return R::err("Skin pack is full: cannot add " + name);
+    }
+
+    growIndex(entries_.size() + 1);
+    const uint64_t nameHash = hashName(name);
+    const uint32_t slot = findSlot(name, nameHash);
+    if (index_[slot] != 0) {
+        return R::err("Duplicate entry name: " + name);
+    }
+
+    size_t bytes = static_cast<size_t>(pixels.width) * pixels.height * 4;
+    out_.write(reinterpret_cast<const char*>(pixels.data), static_cast<std::streamsize>(bytes));
+    if (!out_) {
+        return R::err("Cannot write skin pack texels for " + name);
+    }
+
+    SkinPackEntry e{};
+    e.nameHash = nameHash;
+    e.contentHash = fnv1a64(pixels.data, bytes);
+    e.texelOffset = texelBytes_;
+    e.nameOffset = static_cast<uint32_t>(names_.size());
+    e.nameLength = static_cast<uint16_t>(name.size());
+    e.height = static_cast<uint16_t>(pixels.height);
+    texelBytes_ += bytes;
+    names_ += name;
+    entries_.push_back(e);
+    index_[slot] = static_cast<uint32_t>(entries_.size());
+    return R::ok(true);
+}
+
+Result<bool, std::string> SkinPackBuilder::addFile(const std::string& name, const std::string& path) {
+    auto img = Rgba8Image::load(path);
+    if (!img) {
+        return Result<bool, std::string>::err(
+            "Failed to load file: " + path + " (not a valid PNG or file not found)");
+    }
+    return add(name, img->view());
+}
+
+bool SkinPackBuilder::finish() {
+    if (!out_.is_open()) return false;
+
+    SkinPackHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = SKIN_PACK_VERSION;
+    header.byteOrder = PACK_BYTE_ORDER;
+    header.entryCount = static_cast<uint32_t>(entries_.size());
+    header.indexSlotCount = static_cast<uint32_t>(index_.size());
+
+    // Texel blocks are multiples of 64 bytes, so the tables start aligned
+    header.texelOffset = TEXEL_HEAD;
+    header.entryOffset = header.texelOffset + texelBytes_;
+    header.indexOffset = header.entryOffset + entries_.size() * sizeof(SkinPackEntry);
+    header.nameOffset = header.indexOffset + index_.size() * sizeof(uint32_t);
+    header.fileSize = header.nameOffset + names_.size();
+
+    out_.write(reinterpret_cast<const char*>(entries_.data()),
+               static_cast<std::streamsize>(entries_.size() * sizeof(SkinPackEntry)));
+    out_.write(reinterpret_cast<const char*>(index_.data()),
+               static_cast<std::streamsize>(index_.size() * sizeof(uint32_t)));
+    out_.write(names_.data(), static_cast<std::streamsize>(names_.size()));
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.close();
+    return static_cast<bool>(out_);
+}
+
+// ── Reader ──────────────────────────────────────────────────────────────────
+
+Result<SkinPack, std::string> SkinPack::open(const std::string& path) {
+    using R = Result<SkinPack, std::string>;
+
+    auto file = MappedFile::open(path);
+    if (!file) {
+        return R::err("Failed to map skin pack: " + path);
+    }
+
+    const uint64_t size = file->size();
+    if (size < sizeof(SkinPackHeader)) {
+        return R::err("Skin pack is truncated: " + path);
+    }
+
+    const auto* header = reinterpret_cast<const SkinPackHeader*>(file->data());
+    if (std::memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+        return R::err("Not a skin pack: " + path);
+    }
+    if (header->version != SKIN_PACK_VERSION) {
+        return R::err("Unsupported skin pack version " + std::to_string(header->version)
+                      + " (expected " + std::to_string(SKIN_PACK_VERSION) + ")");
+    }
+    if (header->byteOrder != PACK_BYTE_ORDER) {
+        return R::err("Skin pack was written with a different byte order");
+    }
+    if (header->fileSize != size
+        || header->indexSlotCount == 0
+        || (header->indexSlotCount & (header->indexSlotCount - 1)) != 0
+        || header->indexSlotCount < uint64_t(header->entryCount) * 2
+        || header->entryOffset % 8 != 0 || header->indexOffset % 8 != 0
+        || header->texelOffset > header->entryOffset
+        || header->entryOffset + uint64_t(header->entryCount) * sizeof(SkinPackEntry) > header->indexOffset
+        || header->indexOffset + uint64_t(header->indexSlotCount) * sizeof(uint32_t) > header->nameOffset
+        || header->nameOffset > size) {
+        return R::err("Skin pack section out of bounds: " + path);
+    }
+
+    SkinPack pack;
+    const uint8_t* base = file->data();
+    pack.header_ = header;
+    pack.entries_ = reinterpret_cast<const SkinPackEntry*>(base + header->entryOffset);
+    pack.index_ = reinterpret_cast<const uint32_t*>(base + header->indexOffset);
+    pack.names_ = reinterpret_cast<const char*>(base + header->nameOffset);
+    pack.texels_ = base + header->texelOffset;
+
+    // Validate every entry once so item() can stay unchecked
+    const uint64_t texelBytes = header->entryOffset - header->texelOffset;
+    const uint64_t nameBytes = size - header->nameOffset;
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const SkinPackEntry& e = pack.entries_[i];
+        uint64_t blockBytes = uint64_t(SKIN_WIDTH) * e.height * 4;
+        if ((e.height != 64 && e.height != 32)
+            || uint64_t(e.nameOffset) + e.nameLength > nameBytes
+            || e.texelOffset > texelBytes || blockBytes > texelBytes - e.texelOffset) {
+            return R::err("Skin pack entry " + std::to_string(i) + " out of bounds");
+        }
+    }
+    for (uint32_t s = 0; s < header->indexSlotCount; ++s) {
+        if (pack.index_[s] > header->entryCount) {
+            return R::err("Skin pack index is corrupt: " + path);
+        }
+    }
+
+    pack.file_ = std::move(*file);
+    return R::ok(std::move(pack));
+}
+
+SkinPackItem SkinPack::item(size_t index) const {
+    const SkinPackEntry& e = entries_[index];
+    SkinPackItem it;
+    it.name = std::string_view(names_ + e.nameOffset, e.nameLength);
+    it.contentHash = e.contentHash;
+    it.pixels = Rgba8View{texels_ + e.texelOffset, SKIN_WIDTH, e.height};
+    return it;
+}
+
+std::optional<size_t> SkinPack::find(std::string_view name) const {
+    const uint64_t hash = hashName(name);
+    const uint32_t mask = header_->indexSlotCount - 1;
+    uint32_t slot = static_cast<uint32_t>(hash) & mask;
+
+    // The table is at most half full, so probing always reaches an empty slot
+    for (uint32_t probes = 0; probes < header_->indexSlotCount; ++probes) {
+        uint32_t ref = index_[slot];
+        if (ref == 0) return std::nullopt;
+        const SkinPackEntry& e = entries_[ref - 1];
+        if (e.nameHash == hash
+            && std::string_view(names_ + e.nameOffset, e.nameLength) == name) {
+            return ref - 1;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return std::nullopt;
+}
+
+Result<SkinData, std::string> SkinPack::parse(size_t index) const {
+    if (index >= size()) {
+        return Result<SkinData, std::string>::err(
+            "Skin pack index out of range: " + std::to_string(index));
+    }
+    return SkinParser::parse(item(index).pixels);
+}
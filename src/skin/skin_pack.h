@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "io/mapped_file.h"
+#include "skin/image.h"
+#include "skin/skin_parser.h"
+
+// 皮肤包 (.mcpack)
+//
+// An archive of pre-decoded skins for batch jobs. Texels are stored as raw
+// RGBA8 blocks (64×64 or 64×32), so reading a skin is a pointer lookup into
+// an mmap instead of a file open plus PNG inflate.
+//
+// Layout (little-endian host order):
+//   SkinPackHeader
+//   uint8_t[]                         texel blocks, contiguous, 64-byte aligned
+//   SkinPackEntry[entryCount]         in insertion order
+//   uint32_t[indexSlotCount]          open-addressing hash index (entry + 1, 0 = empty)
+//   char[]                            entry names, not NUL-terminated
+//
+// The texels come first so a builder can stream them to the file as skins
+// are added; the tables follow once the entry count is known.
+
+static constexpr uint32_t SKIN_PACK_VERSION = 1;
+
+struct SkinPackHeader {
+    char magic[4];          // "MCPK"
+    uint32_t version;
+    uint32_t byteOrder;     // 0x01020304 as written by the producer
+    uint32_t entryCount;
+    uint32_t indexSlotCount; // power of two, at least 2 × entryCount
+    uint32_t reserved;
+    uint64_t entryOffset;
+    uint64_t indexOffset;
+    uint64_t nameOffset;
+    uint64_t texelOffset;
+    uint64_t fileSize;
+};
+
+struct SkinPackEntry {
+    uint64_t nameHash;      // fnv1a64 of the name
+    uint64_t contentHash;   // fnv1a64 of the RGBA8 texels
+    uint64_t texelOffset;   // byte offset relative to the texel section
+    uint32_t nameOffset;    // byte offset relative to the name section
+    uint16_t nameLength;
+    uint16_t height;        // 64 or 32 (width is always 64)
+};
+
+// One skin inside a mapped pack. Both members point into the mapping.
+struct SkinPackItem {
+    std::string_view name;
+    uint64_t contentHash = 0;
+    Rgba8View pixels;
+};
+
+// Read-only, memory-mapped skin pack
+class SkinPack {
+public:
+    static Result<SkinPack, std::string> open(const std::string& path);
+
+    size_t size() const { return header_->entryCount; }
+
+    // Entry by position (insertion order = on-disk order, so iterating
+    // 0..size() streams the texel section front to back)
+    SkinPackItem item(size_t index) const;
+
+    // Look up an entry by name through the hash index
+    std::optional<size_t> find(std::string_view name) const;
+
+    // Parse an entry into SkinData directly from the mapped texels
+    Result<SkinData, std::string> parse(size_t index) const;
+
+    // Hint the OS to read ahead for a sequential pass over the pack
+    void adviseSequential() const { file_.adviseSequential(); }
+
+private:
+    MappedFile file_;
+    const SkinPackHeader* header_ = nullptr;
+    const SkinPackEntry* entries_ = nullptr;
+    const uint32_t* index_ = nullptr;
+    const char* names_ = nullptr;
+    const uint8_t* texels_ = nullptr;
+};
+
+// Writes a pack file. Texel blocks go to the file as they are added; only
+// the entry table, the hash index and the names stay in memory (about 50
+// bytes per skin), so a million-skin corpus packs in constant texel memory.
+class SkinPackBuilder {
+public:
+    // Create the output file. A pack that is not finished has no valid
+    // header and is rejected by SkinPack::open.
+    bool open(const std::string& path);
+
+    // Add decoded RGBA8 pixels. Returns an error if the builder is not
+    // open, the dimensions are not 64×64/64×32, the name is empty or too
+    // long, the name already exists, the pack is full or the write fails.
+    Result<bool, std::string> add(const std::string& name, const Rgba8View& pixels);
+
+    // Decode a PNG file and add it
+    Result<bool, std::string> addFile(const std::string& name, const std::string& path);
+
+    size_t size() const { return entries_.size(); }
+
+    // Write the entry table, index, names and header, and close the file.
+    // Returns false if the file cannot be written.
+    bool finish();
+
+private:
+    // Slot holding `name`, or the empty slot where it would go
+    uint32_t findSlot(std::string_view name, uint64_t hash) const;
+    void growIndex(size_t entryCount);
+
+    std::ofstream out_;
+    uint64_t texelBytes_ = 0;
+    std::vector<SkinPackEntry> entries_;
+    std::vector<uint32_t> index_;   // same scheme as the file's index
+    std::string names_;             // the file's name section
+};
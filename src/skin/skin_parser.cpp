@@ -1,5 +1,6 @@
 #include "skin/skin_parser.h"
 #include <algorithm>
+#include <cstring>
 
 // Minecraft skin box texture layout:
 // Given a box with pixel dimensions (w, h, d) and texture origin (ox, oy):
@@ -8,7 +9,8 @@
 //   Row oy:       [top w×d]  [bottom w×d]
 //   Row oy+d: [left d×h] [front w×h] [right d×h] [back w×h]
 //
-BodyPartTexture SkinParser::extractBodyPart(const Image& img, int ox, int oy, int w, int h, int d) {
+template<typename Source>
+BodyPartTexture SkinParser::extractBodyPart(const Source& img, int ox, int oy, int w, int h, int d) {
     BodyPartTexture part;
     part.top    = img.extractRegion(ox + d,         oy,     w, d);
     part.bottom = img.extractRegion(ox + d + w,     oy,     w, d);
@@ -42,7 +44,8 @@ BodyPartTexture SkinParser::mirrorBodyPart(const BodyPartTexture& part) {
     return m;
 }
 
-SkinData SkinParser::parseNew(const Image& img) {
+template<typename Source>
+SkinData SkinParser::parseNew(const Source& img) {
     SkinData skin;
     skin.format = SkinData::NEW_64x64;
 
@@ -79,7 +82,8 @@ SkinData SkinParser::parseNew(const Image& img) {
     return skin;
 }
 
-SkinData SkinParser::parseOld(const Image& img) {
+template<typename Source>
+SkinData SkinParser::parseOld(const Source& img) {
     SkinData skin;
     skin.format = SkinData::OLD_64x32;
 
@@ -109,16 +113,8 @@ SkinData SkinParser::parseOld(const Image& img) {
     return skin;
 }
 
-Result<SkinData, std::string> SkinParser::parse(const std::string& filePath) {
-    // Load the image
-    auto imgOpt = Image::load(filePath);
-    if (!imgOpt.has_value()) {
-        return Result<SkinData, std::string>::err(
-            "Failed to load file: " + filePath + " (not a valid PNG or file not found)");
-    }
-
-    const Image& img = imgOpt.value();
-
+template<typename Source>
+Result<SkinData, std::string> SkinParser::parseImage(const Source& img) {
     // Validate dimensions
     if (img.width == 64 && img.height == 64) {
         return Result<SkinData, std::string>::ok(parseNew(img));
@@ -130,3 +126,58 @@ Result<SkinData, std::string> SkinParser::parse(const std::string& filePath) {
             std::to_string(img.height) + " (expected 64x64 or 64x32)");
     }
 }
+
+Result<SkinData, std::string> SkinParser::parse(const std::string& filePath) {
+    // Load the image
+    auto imgOpt = Image::load(filePath);
+    if (!imgOpt.has_value()) {
+        return Result<SkinData, std::string>::err(
+            "Failed to load file: " + filePath + " (not a valid PNG or file not found)");
+    }
+
+    return parseImage(imgOpt.value());
+}
+
+Result<SkinData, std::string> SkinParser::parse(const Rgba8View& pixels) {
+    if (!pixels.data) {
+        return Result<SkinData, std::string>::err("No pixel data");
+    }
+    return parseImage(pixels);
+}
+
+// Read a big-endian 32-bit value
+static uint32_t readBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+Result<bool, std::string> SkinParser::checkPngHeader(const uint8_t* data, size_t size) {
+    // PNG layout: 8-byte signature, then the IHDR chunk
+    // (4-byte length, "IHDR", 4-byte width, 4-byte height, ...)
+    static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (!data || size < 24 || std::memcmp(data, PNG_SIGNATURE, 8) != 0
+        || std::memcmp(data + 12, "IHDR", 4) != 0) {
+        return Result<bool, std::string>::err("Not a valid PNG image");
+    }
+
+    uint32_t width = readBE32(data + 16);
+    uint32_t height = readBE32(data + 20);
+    if (width != 64 || (height != 64 && height != 32)) {
+        return Result<bool, std::string>::err(
+            "Invalid skin dimensions: " + std::to_string(width) + "x" +
+            std::to_string(height) + " (expected 64x64 or 64x32)");
+    }
+    return Result<bool, std::string>::ok(true);
+}
+
+Result<SkinData, std::string> SkinParser::parseFromMemory(const uint8_t* data, size_t size) {
+    auto header = checkPngHeader(data, size);
+    if (!header.isOk()) {
+        return Result<SkinData, std::string>::err(*header.error);
+    }
+
+    auto img = Rgba8Image::decode(data, size);
+    if (!img) {
+        return Result<SkinData, std::string>::err("Failed to decode PNG image");
+    }
+    return parseImage(img->view());
+}
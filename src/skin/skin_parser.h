@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <optional>
 #include "skin/image.h"
@@ -47,6 +49,20 @@ public:
     // Parse a skin file, auto-detecting 64x64 or 64x32 format
     static Result<SkinData, std::string> parse(const std::string& filePath);
 
+    // Parse an in-memory PNG (e.g. a network download or an upload).
+    // The PNG header is checked first, so non-PNG data and images that
+    // are not 64x64/64x32 are rejected before any inflate work; valid
+    // images are decoded straight to RGBA8.
+    static Result<SkinData, std::string> parseFromMemory(const uint8_t* data, size_t size);
+
+    // Validate the PNG signature and IHDR dimensions without decoding.
+    // Returns the same errors parseFromMemory reports for bad headers.
+    static Result<bool, std::string> checkPngHeader(const uint8_t* data, size_t size);
+
+    // Parse already-decoded RGBA8 pixels (e.g. a skin pack entry) in place,
+    // without an intermediate Image
+    static Result<SkinData, std::string> parse(const Rgba8View& pixels);
+
     // Utility: mirror a TextureRegion horizontally
     static TextureRegion mirrorHorizontal(const TextureRegion& region);
 
@@ -54,13 +70,21 @@ private:
     // Extract body part textures from a box-layout region in the image.
     // (ox, oy) is the top-left origin of the body part's texture block.
     // w, h, d are the box dimensions (width, height, depth) in pixels.
-    static BodyPartTexture extractBodyPart(const Image& img, int ox, int oy, int w, int h, int d);
+    // Source is any pixel container with extractRegion() (Image, Rgba8View).
+    template<typename Source>
+    static BodyPartTexture extractBodyPart(const Source& img, int ox, int oy, int w, int h, int d);
 
     // Parse 64x64 new format
-    static SkinData parseNew(const Image& img);
+    template<typename Source>
+    static SkinData parseNew(const Source& img);
 
     // Parse 64x32 old format
-    static SkinData parseOld(const Image& img);
+    template<typename Source>
+    static SkinData parseOld(const Source& img);
+
+    // Dispatch on image dimensions
+    template<typename Source>
+    static Result<SkinData, std::string> parseImage(const Source& img);
 
     // Mirror an entire BodyPartTexture horizontally (and swap left/right faces)
     static BodyPartTexture mirrorBodyPart(const BodyPartTexture& part);
@@ -0,0 +1,85 @@
+// mcskin_fetch — download skins for many players at once
+//
+//   mcskin_fetch [-j concurrency] [-o outdir] <username | @roster.txt>...
+//
+// A roster file lists one username per line. Skins are written as
+// <outdir>/<username>.png. Lookups go through the shared skin cache, so
+// repeat runs only revalidate; MCSKIN_API_BASE / MCSKIN_SESSION_BASE
+// redirect requests to a stand-in server.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+#include "skin/batch_skin_fetcher.h"
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "Usage:\n"
+        "  mcskin_fetch [-j concurrency] [-o outdir] <username | @roster.txt>...\n");
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("mcskin_raytracer"));
+
+    BatchFetchOptions options;
+    QString outDir = QStringLiteral(".");
+    QStringList usernames;
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        if (arg == QLatin1String("-j") && i + 1 < args.size()) {
+            options.maxConcurrent = args[++i].toInt();
+        } else if (arg == QLatin1String("-o") && i + 1 < args.size()) {
+            outDir = args[++i];
+        } else if (arg.startsWith('@')) {
+            QFile roster(arg.mid(1));
+            if (!roster.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                std::fprintf(stderr, "error: cannot read %s\n", qPrintable(arg.mid(1)));
+                return 1;
+            }
+            QTextStream in(&roster);
+            while (!in.atEnd()) {
+                QString name = in.readLine().trimmed();
+                if (!name.isEmpty()) usernames.append(name);
+            }
+        } else {
+            usernames.append(arg);
+        }
+    }
+    if (usernames.isEmpty()) {
+        printUsage();
+        return 2;
+    }
+    QDir().mkpath(outDir);
+
+    BatchSkinFetcher fetcher(options);
+    int failures = 0;
+
+    QObject::connect(&fetcher, &BatchSkinFetcher::skinFetched,
+                     [&](const QString& name, const QByteArray& png) {
+        QFile out(QDir(outDir).filePath(name + QStringLiteral(".png")));
+        if (!out.open(QIODevice::WriteOnly) || out.write(png) != png.size()) {
+            std::fprintf(stderr, "error: cannot write %s\n", qPrintable(out.fileName()));
+            ++failures;
+        }
+    });
+    QObject::connect(&fetcher, &BatchSkinFetcher::fetchFailed,
+                     [&](const QString& name, const QString& message) {
+        std::fprintf(stderr, "%s: %s\n", qPrintable(name), qPrintable(message));
+        ++failures;
+    });
+    QObject::connect(&fetcher, &BatchSkinFetcher::finished, &app, &QCoreApplication::quit,
+                     Qt::QueuedConnection);
+
+    fetcher.fetch(usernames);
+    if (!fetcher.isIdle()) app.exec();
+
+    std::printf("%lld skins fetched, %d failed\n",
+                static_cast<long long>(usernames.size()) - failures, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// mcskin_pack — build or inspect a skin pack (.mcpack)
+//
+//   mcskin_pack build <output.mcpack> <dir-or-png>...
+//   mcskin_pack list  <pack.mcpack>
+//
+// `build` walks directories recursively and adds every *.png. The entry
+// name is the file name without extension (usually a username or UUID);
+// duplicates and invalid skins are reported and skipped.
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "skin/skin_ingest.h"
+#include "skin/skin_pack.h"
+
+namespace fs = std::filesystem;
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "Usage:\n"
+        "  mcskin_pack build <output.mcpack> <dir-or-png>...\n"
+        "  mcskin_pack list  <pack.mcpack>\n");
+}
+
+static int buildPack(const std::string& output, const std::vector<std::string>& inputs) {
+    std::vector<std::string> missing;
+    std::vector<std::string> files = SkinIngest::collectPngFiles(inputs, &missing);
+    for (const auto& m : missing) {
+        std::fprintf(stderr, "warning: skipping %s (not found)\n", m.c_str());
+    }
+
+    SkinPackBuilder builder;
+    if (!builder.open(output)) {
+        std::fprintf(stderr, "error: cannot write %s\n", output.c_str());
+        return 1;
+    }
+    int skipped = 0;
+    for (const auto& file : files) {
+        auto result = builder.addFile(fs::path(file).stem().string(), file);
+        if (!result.isOk()) {
+            std::fprintf(stderr, "warning: %s\n", result.error->c_str());
+            ++skipped;
+        }
+    }
+
+    if (!builder.finish()) {
+        std::fprintf(stderr, "error: cannot write %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("%s: %zu skins packed, %d skipped\n", output.c_str(), builder.size(), skipped);
+    return 0;
+}
+
+static int listPack(const std::string& path) {
+    auto pack = SkinPack::open(path);
+    if (!pack.isOk()) {
+        std::fprintf(stderr, "error: %s\n", pack.error->c_str());
+        return 1;
+    }
+    for (size_t i = 0; i < pack.value->size(); ++i) {
+        SkinPackItem item = pack.value->item(i);
+        std::printf("%016llx  64x%-2d  %.*s\n",
+                    static_cast<unsigned long long>(item.contentHash),
+                    item.pixels.height,
+                    static_cast<int>(item.name.size()), item.name.data());
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+    if (command == "build" && argc >= 4) {
+        return buildPack(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+    if (command == "list" && argc == 3) {
+        return listPack(argv[2]);
+    }
+
+    printUsage();
+    return 2;
+}
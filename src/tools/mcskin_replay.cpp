@@ -0,0 +1,251 @@
+// mcskin_replay — re-run a captured render job (.mcjob) with profiling
+//
+//   mcskin_replay [-o image.png] [--trace trace.json] [-j threads]
+//                 [--tune profile.txt | --tuning profile.txt] [--predict]
+//                 [--checkpoint file.mcckpt [--checkpoint-interval s]] <job.mcjob>
+//
+// Rebuilds the scene from the captured skin, pose, camera, light and
+// config, renders it and prints where the time went. --trace writes the
+// Chrome trace_event timeline of the replay (chrome://tracing,
+// ui.perfetto.dev); -j overrides the captured thread count.
+//
+// --tune first runs the autotuner on the job's workload class, merges the
+// winner into the given per-machine tuning profile (created if missing)
+// and replays with it. --tuning replays with an existing profile. Either
+// applies only if the captured tile size is unset (0, as the application
+// captures it).
+//
+// --predict calibrates the render cost model on the job's scene and prints
+// its prediction next to the measured rays and time.
+//
+// --checkpoint renders in passes of one sample per pixel and saves the
+// running sums to the given file every --checkpoint-interval seconds
+// (default 600) and on SIGINT / SIGTERM, then exits with status 3. Run
+// the same command again to resume; the finished image is bit-identical
+// to an uninterrupted render and the checkpoint is deleted.
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "output/image_writer.h"
+#include "output/render_checkpoint.h"
+#include "output/render_job.h"
+#include "raytracer/autotuner.h"
+#include "raytracer/cost_model.h"
+#include "raytracer/memory_account.h"
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "Usage:\n"
+        "  mcskin_replay [-o image.png] [--trace trace.json] [-j threads]\n"
+        "                [--tune profile.txt | --tuning profile.txt] [--predict]\n"
+        "                [--checkpoint file.mcckpt [--checkpoint-interval s]] <job.mcjob>\n");
+}
+
+// Preemption notice: finish the tiles in flight, save, exit
+static RenderControl* interruptTarget = nullptr;
+
+static void onInterrupt(int) {
+    if (interruptTarget) interruptTarget->cancel.store(true);
+}
+
+static int renderWithCheckpoints(const RenderJob& job, int threadCount, CheckpointOptions options,
+                                 const std::string& imagePath) {
+    auto scene = job.buildScene();
+    if (!scene.isOk()) {
+        std::fprintf(stderr, "error: %s\n", scene.error->c_str());
+        return 1;
+    }
+    RayTracer::Config config = job.config;
+    if (threadCount > 0) config.threadCount = threadCount;
+
+    MemoryAccount memory;
+    options.memory = &memory;
+    RenderControl control;
+    interruptTarget = &control;
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    auto progress = [](int done, int total) { std::fprintf(stderr, "  %d/%d spp\n", done, total); };
+    auto result = RenderCheckpointFile::render(*scene.value, config, options, progress, &control);
+    interruptTarget = nullptr;
+    if (!result.isOk()) {
+        std::fprintf(stderr, "error: %s\n", result.error->c_str());
+        return 1;
+    }
+
+    const CheckpointResult& r = *result.value;
+    if (r.resumedFrom >= 0) std::printf("  resumed at         %d spp\n", r.resumedFrom);
+    std::printf("  checkpoints        %d written\n", r.checkpointsWritten);
+    if (!r.complete) {
+        std::printf("  interrupted at     %d/%d spp, state in %s\n",
+                    r.samplesPerPixel, config.samplesPerPixel, options.path.c_str());
+        return 3;
+    }
+    std::printf("  rendered           %d spp\n", r.samplesPerPixel);
+    if (!imagePath.empty() && !ImageWriter::writePNG(r.image, imagePath, &memory)) {
+        std::fprintf(stderr, "error: cannot write %s\n", imagePath.c_str());
+        return 1;
+    }
+    std::printf("  memory peak        %.1f MiB\n", memory.peakTotal() / (1024.0 * 1024.0));
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string jobPath, imagePath, tracePath, tunePath, profilePath;
+    int threadCount = 0;
+    bool predict = false;
+    CheckpointOptions checkpoint;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-o" && hasValue) {
+            imagePath = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            tracePath = argv[++i];
+        } else if (arg == "--tune" && hasValue) {
+            tunePath = argv[++i];
+        } else if (arg == "--tuning" && hasValue) {
+            profilePath = argv[++i];
+        } else if (arg == "--checkpoint" && hasValue) {
+            checkpoint.path = argv[++i];
+        } else if (arg == "--checkpoint-interval" && hasValue) {
+            checkpoint.intervalSeconds = std::atof(argv[++i]);
+        } else if (arg == "--predict") {
+            predict = true;
+        } else if (arg == "-j" && hasValue) {
+            threadCount = std::atoi(argv[++i]);
+        } else if (jobPath.empty() && !arg.empty() && arg[0] != '-') {
+            jobPath = arg;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (jobPath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    auto job = RenderJobFile::read(jobPath);
+    if (!job.isOk()) {
+        std::fprintf(stderr, "error: %s\n", job.error->c_str());
+        return 1;
+    }
+    const RenderJob& j = *job.value;
+    const RayTracer::Config& c = j.config;
+    std::printf("%s: %dx%d, %d spp, %d bounces, pose \"%s\", skin %s\n",
+                jobPath.c_str(), c.width, c.height, c.samplesPerPixel, c.maxBounces,
+                j.pose.name.c_str(), j.skin.pixels.empty() ? "default" :
+                (std::to_string(j.skin.width) + "x" + std::to_string(j.skin.height)).c_str());
+
+    if (!profilePath.empty()) {
+        auto loaded = TuningProfile::load(profilePath);
+        if (!loaded.isOk()) {
+            std::fprintf(stderr, "error: %s\n", loaded.error->c_str());
+            return 1;
+        }
+        if (!Autotuner::setProfile(*loaded.value)) {
+            std::fprintf(stderr, "warning: %s was measured on another machine, not applied\n",
+                         profilePath.c_str());
+        }
+    }
+
+    if (!tunePath.empty()) {
+        auto scene = j.buildScene();
+        if (!scene.isOk()) {
+            std::fprintf(stderr, "error: %s\n", scene.error->c_str());
+            return 1;
+        }
+        TuningProfile profile;
+        auto existing = TuningProfile::load(tunePath);
+        if (existing.isOk() && existing.value->machine == TuningProfile::machineFingerprint()) {
+            profile = *existing.value;
+        }
+        profile.machine = TuningProfile::machineFingerprint();
+
+        TuningResult tuned = Autotuner::tune(*scene.value, c);
+        for (const TuningProbe& p : tuned.probes) {
+            std::printf("  probe tile %3d  threads %3d  %8.3f ms\n", p.tileSize, p.threadCount, p.seconds * 1e3);
+        }
+        std::printf("  tuned %-12s tile %d, %d threads (%.2f Mpx/s)\n", tuned.workload.c_str(),
+                    tuned.best.tileSize, tuned.best.threadCount, tuned.best.megapixelsPerSecond);
+        profile.entries[tuned.workload] = tuned.best;
+        if (!profile.save(tunePath)) {
+            std::fprintf(stderr, "error: cannot write %s\n", tunePath.c_str());
+            return 1;
+        }
+        Autotuner::setProfile(profile);
+    }
+
+    std::optional<CostPrediction> prediction;
+    if (predict) {
+        auto scene = j.buildScene();
+        if (!scene.isOk()) {
+            std::fprintf(stderr, "error: %s\n", scene.error->c_str());
+            return 1;
+        }
+        RayTracer::Config predicted = c;
+        if (threadCount > 0) predicted.threadCount = threadCount;
+        auto model = CostModel::calibrate(*scene.value, predicted);
+        if (!model.isOk()) {
+            std::fprintf(stderr, "error: %s\n", model.error->c_str());
+            return 1;
+        }
+        prediction = model.value->predict(predicted, CostModel::estimateCoverage(*scene.value, predicted));
+    }
+
+    if (!checkpoint.path.empty()) {
+        return renderWithCheckpoints(j, threadCount, checkpoint, imagePath);
+    }
+
+    auto replay = RenderJobFile::replay(j, threadCount);
+    if (!replay.isOk()) {
+        std::fprintf(stderr, "error: %s\n", replay.error->c_str());
+        return 1;
+    }
+    const ReplayResult& r = *replay.value;
+    const RenderStats& s = r.stats;
+    const WorkCounters& w = s.counters;
+
+    std::printf("  parse skin         %8.3f ms\n", r.parseSeconds * 1e3);
+    std::printf("  build scene        %8.3f ms\n", r.buildSeconds * 1e3);
+    std::printf("  render             %8.3f s  (%d tiles of %d px, %d threads)\n",
+                r.renderSeconds, s.tiles, s.tileSize, s.threads);
+    std::printf("    setup            %8.3f ms\n", s.setupSeconds * 1e3);
+    std::printf("    trace (sum)      %8.3f s\n", s.traceSeconds);
+    std::printf("    callbacks (sum)  %8.3f s\n", s.callbackSeconds);
+    std::printf("    tail             %8.3f s\n", s.tailSeconds);
+    std::printf("  rays               %llu (primary %llu, shadow %llu, AO %llu, reflection %llu)\n",
+                static_cast<unsigned long long>(w.rays.total()),
+                static_cast<unsigned long long>(w.rays[RayKind::Primary]),
+                static_cast<unsigned long long>(w.rays[RayKind::Shadow]),
+                static_cast<unsigned long long>(w.rays[RayKind::AO]),
+                static_cast<unsigned long long>(w.rays[RayKind::Reflection]));
+    if (prediction) {
+        std::printf("  predicted          %8.3f s, %llu rays (%+.0f%% time, %+.0f%% rays)\n",
+                    prediction->wallSeconds,
+                    static_cast<unsigned long long>(prediction->rays.total()),
+                    r.renderSeconds > 0.0 ? (prediction->wallSeconds / r.renderSeconds - 1.0) * 100.0 : 0.0,
+                    w.rays.total() > 0 ? (static_cast<double>(prediction->rays.total()) / w.rays.total() - 1.0) * 100.0 : 0.0);
+    }
+    std::printf("  box tests          %llu\n", static_cast<unsigned long long>(w.boxTests));
+    std::printf("  texture samples    %llu\n", static_cast<unsigned long long>(w.textureSamples));
+
+    if (!imagePath.empty() && !ImageWriter::writePNG(r.image, imagePath)) {
+        std::fprintf(stderr, "error: cannot write %s\n", imagePath.c_str());
+        return 1;
+    }
+    if (!tracePath.empty()) {
+        std::ofstream out(tracePath, std::ios::binary | std::ios::trunc);
+        out << r.traceJson;
+        if (!out) {
+            std::fprintf(stderr, "error: cannot write %s\n", tracePath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,458 @@
+#include <gtest/gtest.h>
+#include "bench_common.h"
+#include "raytracer/tile_renderer.h"
+#include "output/image_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// 渲染回归门禁
+//
+// A fixed set of small scenarios is rendered and checked against the
+// baselines in baselines/:
+//   - the image against <name>.png, with a perceptual tolerance (CIE76 ΔE
+//     in Lab space; a few pixels may flip across compilers, a shifted
+//     shadow or a colour change may not);
+//   - the ray counts per kind (deterministic, so tight; skipped when the
+//     counters are compiled out);
+//   - the render time, in units of a fixed arithmetic calibration loop so
+//     that the baseline travels between machines, with a threshold that
+//     widens with the measured noise. Timing is only checked when the build
+//     type matches the one the baseline was recorded with.
+//
+// A readable report (and actual/diff PNGs of failing images) is written to
+// MCSKIN_REGRESSION_OUT. MCSKIN_UPDATE_BASELINES=1 re-records everything;
+// MCSKIN_REGRESSION_TIMING=0/1 turns the timing check off/on regardless of
+// build type.
+
+#ifndef MCSKIN_BUILD_TYPE
+#define MCSKIN_BUILD_TYPE ""
+#endif
+
+// ── Thresholds ──────────────────────────────────────────────────────────────
+
+static constexpr double kJnd = 2.3;              // just noticeable ΔE
+static constexpr double kMaxMeanDeltaE = 0.5;
+static constexpr double kMaxFractionOverJnd = 0.01;
+static constexpr double kMaxRayDrift = 0.005;    // relative, per kind
+static constexpr double kMinTimeSlack = 0.30;    // always allow +30%
+static constexpr double kNoiseSigmas = 4.0;      // plus 4 × (MAD-based σ)
+static constexpr int kTimingRuns = 7;
+
+// Automatic quality LOD: against the full-quality render of the same small
+// frame (both noisy, so looser than the golden check)
+static constexpr double kLodMaxMeanDeltaE = 1.5;
+static constexpr double kLodMaxFractionOverJnd = 0.10;
+static constexpr double kLodMaxRayRatio = 0.6;   // traced rays, all kinds
+
+// ── Scenarios ───────────────────────────────────────────────────────────────
+
+struct RegressionScenario {
+    std::string name;
+    int pose;
+    bool closeUp;
+    RayTracer::Config config;
+};
+
+static std::vector<RegressionScenario> scenarios() {
+    std::vector<RegressionScenario> list;
+
+    RayTracer::Config c;
+    c.width = 96;
+    c.height = 96;
+    c.samplesPerPixel = 1;
+    c.maxBounces = 2;
+    c.softShadows = false;
+    c.tileSize = 16;
+    c.threadCount = 1;
+    list.push_back({"standing_hard_shadow", 0, false, c});
+
+    RayTracer::Config soft = c;
+    soft.samplesPerPixel = 2;
+    soft.softShadows = true;
+    soft.shadowSamples = 4;
+    soft.aoEnabled = true;
+    soft.aoSamples = 4;
+    list.push_back({"running_soft_shadow_ao", 2, false, soft});
+
+    RayTracer::Config dof = c;
+    dof.width = 64;
+    dof.height = 64;
+    dof.samplesPerPixel = 4;
+    dof.dofEnabled = true;
+    dof.aperture = 0.5f;
+    list.push_back({"head_dof", 5, true, dof});
+
+    return list;
+}
+
+static Scene sceneFor(const RegressionScenario& s) {
+    Scene scene = bench::makeScene(s.pose);
+    if (s.closeUp) {
+        scene.camera.position = Vec3(0, 28, 16);
+        scene.camera.target = Vec3(0, 28, 0);
+    }
+    return scene;
+}
+
+// ── Baselines file ──────────────────────────────────────────────────────────
+
+struct Baseline {
+    double timeUnits = 0.0;   // median render time / calibration time
+    double noise = 0.0;       // MAD of the same, at recording time
+    RayCounts rays;
+};
+
+struct BaselineSet {
+    std::string buildType;
+    std::map<std::string, Baseline> entries;
+};
+
+static fs::path baselineDir() { return fs::path(MCSKIN_REGRESSION_DIR); }
+static fs::path outputDir() { return fs::path(MCSKIN_REGRESSION_OUT); }
+
+static bool envFlag(const char* name, bool& value) {
+    const char* v = std::getenv(name);
+    if (!v || !*v) return false;
+    value = std::string(v) != "0";
+    return true;
+}
+
+static bool updating() {
+    bool v = false;
+    return envFlag("MCSKIN_UPDATE_BASELINES", v) && v;
+}
+
+static BaselineSet loadBaselines() {
+    BaselineSet set;
+    std::ifstream in(baselineDir() / "baselines.txt");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::istringstream ss(line);
+        if (line[0] == '#') {
+            std::string hash, key;
+            ss >> hash >> key;
+            if (key == "build") ss >> set.buildType;
+            continue;
+        }
+        std::string name;
+        Baseline b;
+        ss >> name >> b.timeUnits >> b.noise;
+        for (int k = 0; k < RAY_KIND_COUNT; ++k) ss >> b.rays.n[k];
+        if (ss) set.entries[name] = b;
+    }
+    return set;
+}
+
+static void saveBaselines(const BaselineSet& set) {
+    std::ofstream out(baselineDir() / "baselines.txt");
+    out << "# build " << set.buildType << "\n";
+    out << "# name time_units noise primary shadow ao reflection\n";
+    for (const auto& [name, b] : set.entries) {
+        out << name << ' ' << std::setprecision(6) << b.timeUnits << ' ' << b.noise;
+        for (int k = 0; k < RAY_KIND_COUNT; ++k) out << ' ' << b.rays.n[k];
+        out << "\n";
+    }
+}
+
+// ── Measurement ─────────────────────────────────────────────────────────────
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// Median absolute deviation, scaled to estimate σ of normal noise
+static double madSigma(const std::vector<double>& v) {
+    double m = median(v);
+    std::vector<double> dev;
+    for (double x : v) dev.push_back(std::abs(x - m));
+    return 1.4826 * median(dev);
+}
+
+// Fixed floating-point workload independent of the renderer, so that a
+// slower renderer cannot hide behind a slower calibration
+static double calibrationSeconds() {
+    std::vector<double> runs;
+    for (int r = 0; r < kTimingRuns; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t x = 2463534242u;
+        float acc = 0.0f;
+        for (int i = 0; i < 2000000; ++i) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            float f = static_cast<float>(x & 0xffff) * (1.0f / 65536.0f);
+            acc += std::sqrt(f * f + 1.0f) * 0.5f;
+        }
+        volatile float sink = acc;
+        (void)sink;
+        runs.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return median(runs);
+}
+
+static double calibration() {
+    static double seconds = calibrationSeconds();
+    return seconds;
+}
+
+// ΔE between two sRGB8 pixels (CIE76, D65)
+static void toLab(const uint8_t* p, double lab[3]) {
+    double rgb[3];
+    for (int i = 0; i < 3; ++i) {
+        double c = p[i] / 255.0;
+        rgb[i] = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+    double X = (0.4124 * rgb[0] + 0.3576 * rgb[1] + 0.1805 * rgb[2]) / 0.95047;
+    double Y = (0.2126 * rgb[0] + 0.7152 * rgb[1] + 0.0722 * rgb[2]);
+    double Z = (0.0193 * rgb[0] + 0.1192 * rgb[1] + 0.9505 * rgb[2]) / 1.08883;
+    auto f = [](double t) { return t > 216.0 / 24389.0 ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0; };
+    lab[0] = 116.0 * f(Y) - 16.0;
+    lab[1] = 500.0 * (f(X) - f(Y));
+    lab[2] = 200.0 * (f(Y) - f(Z));
+}
+
+static double deltaE(const uint8_t* a, const uint8_t* b) {
+    double la[3], lb[3];
+    toLab(a, la);
+    toLab(b, lb);
+    return std::sqrt((la[0] - lb[0]) * (la[0] - lb[0]) +
+                     (la[1] - lb[1]) * (la[1] - lb[1]) +
+                     (la[2] - lb[2]) * (la[2] - lb[2]));
+}
+
+struct ImageDiff {
+    bool sizeMatches = false;
+    double meanDeltaE = 0.0;
+    double maxDeltaE = 0.0;
+    double fractionOverJnd = 0.0;
+    Image heatmap;   // ΔE per pixel, black → red at 4 × JND
+};
+
+static ImageDiff compareImages(const std::vector<uint8_t>& actual, const Rgba8Image& golden,
+                               int width, int height) {
+    ImageDiff d;
+    d.sizeMatches = golden.width == width && golden.height == height;
+    if (!d.sizeMatches) return d;
+
+    d.heatmap = Image(width, height);
+    size_t over = 0;
+    const size_t n = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < n; ++i) {
+        double e = deltaE(&actual[i * 4], &golden.pixels[i * 4]);
+        d.meanDeltaE += e;
+        d.maxDeltaE = std::max(d.maxDeltaE, e);
+        if (e > kJnd) ++over;
+        float t = static_cast<float>(std::min(1.0, e / (4.0 * kJnd)));
+        d.heatmap.pixels[i] = Color(t, 0.0f, 0.0f, 1.0f);
+    }
+    d.meanDeltaE /= static_cast<double>(n);
+    d.fractionOverJnd = static_cast<double>(over) / static_cast<double>(n);
+    return d;
+}
+
+// ── Report ──────────────────────────────────────────────────────────────────
+
+static std::ostringstream& report() {
+    static std::ostringstream r;
+    return r;
+}
+
+class RegressionReport : public ::testing::Environment {
+public:
+    void TearDown() override {
+        fs::create_directories(outputDir());
+        fs::path path = outputDir() / "report.txt";
+        std::ofstream(path) << report().str();
+        std::printf("\n── Render regression report (%s) ──\n%s", path.string().c_str(),
+                    report().str().c_str());
+    }
+};
+
+[[maybe_unused]] static ::testing::Environment* const kReportEnv =
+    ::testing::AddGlobalTestEnvironment(new RegressionReport);
+
+// ── Tests ───────────────────────────────────────────────────────────────────
+
+class RenderRegression : public ::testing::TestWithParam<RegressionScenario> {};
+
+TEST_P(RenderRegression, MatchesBaseline) {
+    const RegressionScenario& s = GetParam();
+    Scene scene = sceneFor(s);
+    std::ostringstream& rep = report();
+    rep << std::fixed << std::setprecision(3);
+    rep << "[" << s.name << "] " << s.config.width << "x" << s.config.height
+        << " spp " << s.config.samplesPerPixel << "\n";
+
+    // Render: first run gives the image and ray counts, all runs the timing
+    RenderMonitor monitor;
+    RenderControl control;
+    control.monitor = &monitor;
+    std::vector<double> units;
+    Image image;
+    RayCounts rays;
+    for (int r = 0; r < kTimingRuns; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        Image img = TileRenderer::render(scene, s.config, nullptr, &control);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        units.push_back(seconds / calibration());
+        if (r == 0) {
+            image = std::move(img);
+            rays = monitor.snapshot().rays;
+        }
+    }
+    std::vector<uint8_t> rgba = ImageWriter::toRGBA8(image);
+    const double timeUnits = median(units);
+    const double noise = madSigma(units);
+
+    fs::path goldenPath = baselineDir() / (s.name + ".png");
+    if (updating()) {
+        ASSERT_TRUE(ImageWriter::writePNG(image, goldenPath.string()));
+        BaselineSet set = loadBaselines();
+        set.buildType = MCSKIN_BUILD_TYPE;
+        set.entries[s.name] = Baseline{timeUnits, noise, rays};
+        saveBaselines(set);
+        rep << "  baseline updated\n";
+        return;
+    }
+
+    // Image
+    std::optional<Rgba8Image> golden = Rgba8Image::load(goldenPath.string());
+    ASSERT_TRUE(golden.has_value()) << "missing golden image " << goldenPath
+                                    << " (run with MCSKIN_UPDATE_BASELINES=1)";
+    ImageDiff diff = compareImages(rgba, *golden, image.width, image.height);
+    bool imageOk = diff.sizeMatches && diff.meanDeltaE <= kMaxMeanDeltaE &&
+                   diff.fractionOverJnd <= kMaxFractionOverJnd;
+    rep << "  image  " << (imageOk ? "PASS" : "FAIL");
+    if (diff.sizeMatches) {
+        rep << "  mean ΔE " << diff.meanDeltaE << " (≤ " << kMaxMeanDeltaE << ")"
+            << "  max ΔE " << diff.maxDeltaE
+            << "  over JND " << diff.fractionOverJnd * 100.0 << "% (≤ "
+            << kMaxFractionOverJnd * 100.0 << "%)\n";
+    } else {
+        rep << "  size " << image.width << "x" << image.height << " vs golden "
+            << golden->width << "x" << golden->height << "\n";
+    }
+    if (!imageOk) {
+        fs::create_directories(outputDir());
+        ImageWriter::writePNG(image, (outputDir() / (s.name + ".actual.png")).string());
+        if (diff.sizeMatches) {
+            ImageWriter::writePNG(diff.heatmap, (outputDir() / (s.name + ".diff.png")).string());
+        }
+        rep << "         see " << (outputDir() / (s.name + ".actual.png")).string() << "\n";
+    }
+    EXPECT_TRUE(imageOk) << s.name << ": rendered image differs from golden";
+
+    // Ray counts
+    BaselineSet set = loadBaselines();
+    auto it = set.entries.find(s.name);
+    ASSERT_NE(it, set.entries.end()) << "no baseline entry for " << s.name;
+    const Baseline& base = it->second;
+
+    static const char* kKindNames[RAY_KIND_COUNT] = {"primary", "shadow", "ao", "reflection"};
+    for (int k = 0; k < RAY_KIND_COUNT && MCSKIN_RENDER_STATS; ++k) {
+        double expected = static_cast<double>(base.rays.n[k]);
+        double actual = static_cast<double>(rays.n[k]);
+        double drift = expected > 0.0 ? std::abs(actual - expected) / expected : actual;
+        bool ok = drift <= kMaxRayDrift;
+        rep << "  rays   " << (ok ? "PASS" : "FAIL") << "  " << std::setw(10) << kKindNames[k]
+            << " " << rays.n[k] << " vs " << base.rays.n[k] << "\n";
+        EXPECT_TRUE(ok) << s.name << ": " << kKindNames[k] << " rays " << rays.n[k]
+                        << " vs baseline " << base.rays.n[k];
+    }
+
+    // Timing
+    bool checkTiming = !set.buildType.empty() && set.buildType == MCSKIN_BUILD_TYPE;
+    bool forced = envFlag("MCSKIN_REGRESSION_TIMING", checkTiming);
+    double slack = std::max(kMinTimeSlack, kNoiseSigmas * (base.noise + noise) / base.timeUnits);
+    double limit = base.timeUnits * (1.0 + slack);
+    double ratio = timeUnits / base.timeUnits;
+    if (!checkTiming) {
+        if (forced) {
+            rep << "  time   SKIP  (MCSKIN_REGRESSION_TIMING=0)  ";
+        } else {
+            rep << "  time   SKIP  (build '" << MCSKIN_BUILD_TYPE << "', baseline '"
+                << set.buildType << "')  ";
+        }
+        rep << ratio << "x baseline\n";
+        return;
+    }
+    bool timeOk = timeUnits <= limit;
+    rep << "  time   " << (timeOk ? "PASS" : "FAIL") << "  " << timeUnits << " units vs "
+        << base.timeUnits << " (" << ratio << "x, limit " << 1.0 + slack << "x)\n";
+    EXPECT_TRUE(timeOk) << s.name << ": " << ratio << "x slower than baseline (limit "
+                        << 1.0 + slack << "x)";
+}
+
+INSTANTIATE_TEST_SUITE_P(Scenarios, RenderRegression, ::testing::ValuesIn(scenarios()),
+    [](const ::testing::TestParamInfo<RegressionScenario>& info) { return info.param.name; });
+
+// ── Automatic quality LOD ───────────────────────────────────────────────────
+
+class AutoQuality : public ::testing::TestWithParam<int> {};
+
+TEST_P(AutoQuality, SmallOutputStaysWithinToleranceAndTracesFewerRays) {
+    const int size = GetParam();
+    Scene scene = bench::makeScene(0);
+    RayTracer::Config full;
+    full.width = size;
+    full.height = size;
+    full.samplesPerPixel = 4;
+    full.maxBounces = 4;
+    full.softShadows = true;
+    full.shadowSamples = 16;
+    full.aoEnabled = true;
+    full.aoSamples = 16;
+    full.dofEnabled = true;
+    full.aperture = 0.3f;
+    full.tileSize = 16;
+    full.threadCount = 1;
+    RayTracer::Config lod = full;
+    lod.autoQuality = true;
+
+    // Rays traced rather than wall time: deterministic for a given config,
+    // and what the reduced effects are meant to save
+    auto traced = [&](const RayTracer::Config& config, Image& image) {
+        image = TileRenderer::render(scene, config);
+        return static_cast<double>(TileRenderer::lastStats().counters.rays.total());
+    };
+    Image reference, reduced;
+    double fullRays = traced(full, reference);
+    double lodRays = traced(lod, reduced);
+    const QualityReport q = TileRenderer::lastStats().quality;
+
+    Rgba8Image golden;
+    golden.width = size;
+    golden.height = size;
+    golden.pixels = ImageWriter::toRGBA8(reference);
+    ImageDiff diff = compareImages(ImageWriter::toRGBA8(reduced), golden, size, size);
+    double ratio = lodRays / fullRays;
+
+    std::ostringstream& rep = report();
+    rep << std::fixed << std::setprecision(3);
+    rep << "[auto_quality_" << size << "] texel " << q.texelPixels << " px: shadow "
+        << q.shadowSamples << ", AO " << q.aoSamples << ", bounces " << q.maxBounces
+        << ", DOF " << (q.dofEnabled ? "on" : "off") << "\n"
+        << "  mean ΔE " << diff.meanDeltaE << " (≤ " << kLodMaxMeanDeltaE << ")"
+        << "  over JND " << diff.fractionOverJnd * 100.0 << "% (≤ "
+        << kLodMaxFractionOverJnd * 100.0 << "%)"
+        << "  rays " << ratio << "x full (≤ " << kLodMaxRayRatio << "x)\n";
+
+    EXPECT_TRUE(q.applied);
+    EXPECT_LE(diff.meanDeltaE, kLodMaxMeanDeltaE);
+    EXPECT_LE(diff.fractionOverJnd, kLodMaxFractionOverJnd);
+    EXPECT_GT(fullRays, 0.0);
+    EXPECT_LE(ratio, kLodMaxRayRatio);
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, AutoQuality, ::testing::Values(64, 128),
+    [](const ::testing::TestParamInfo<int>& info) { return std::to_string(info.param); });
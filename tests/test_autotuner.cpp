@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "raytracer/autotuner.h"
+#include "raytracer/tile_renderer.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// The active profile is global; every test starts without one
+class AutotunerTest : public ::testing::Test {
+protected:
+    void SetUp() override { Autotuner::clearProfile(); }
+    void TearDown() override { Autotuner::clearProfile(); }
+
+    static RayTracer::Config makeConfig(int w, int h) {
+        RayTracer::Config config;
+        config.width = w;
+        config.height = h;
+        config.maxBounces = 1;
+        config.shadowSamples = 2;
+        config.tileSize = 0;        // opt in to the profile
+        return config;
+    }
+};
+
+TEST_F(AutotunerTest, WorkloadClassBySizeAndCost) {
+    RayTracer::Config config = makeConfig(128, 128);
+    EXPECT_EQ(Autotuner::workloadClass(config), "avatar/light");
+
+    config.width = 3840;
+    config.height = 2160;
+    EXPECT_EQ(Autotuner::workloadClass(config), "poster/light");
+
+    config.samplesPerPixel = 16;
+    config.aoEnabled = true;
+    EXPECT_EQ(Autotuner::workloadClass(config), "poster/heavy");
+}
+
+TEST_F(AutotunerTest, HeuristicGivesSmallFramesSmallTiles) {
+    EXPECT_EQ(Autotuner::defaultTileSize(128, 128, 8), 16);     // 64 tiles for 8 threads
+    EXPECT_EQ(Autotuner::defaultTileSize(128, 128, 1), 64);
+    EXPECT_EQ(Autotuner::defaultTileSize(7680, 4320, 32), 64);
+    EXPECT_EQ(Autotuner::defaultTileSize(16, 16, 64), 8);
+}
+
+TEST_F(AutotunerTest, ResolveFillsOnlyUnsetFields) {
+    RayTracer::Config config = makeConfig(128, 128);
+    config.threadCount = 8;
+    RayTracer::Config r = Autotuner::resolve(config);
+    EXPECT_EQ(r.threadCount, 8);
+    EXPECT_EQ(r.tileSize, 16);
+
+    config.tileSize = 48;
+    config.threadCount = 0;
+    r = Autotuner::resolve(config);
+    EXPECT_EQ(r.tileSize, 48);
+    EXPECT_EQ(r.threadCount, Autotuner::hardwareThreads());
+
+    // A profile entry wins over the heuristic
+    TuningProfile profile;
+    profile.machine = TuningProfile::machineFingerprint();
+    profile.entries["avatar/light"] = TuningEntry{24, 3, 1.0};
+    ASSERT_TRUE(Autotuner::setProfile(profile));
+    r = Autotuner::resolve(makeConfig(128, 128));
+    EXPECT_EQ(r.tileSize, 24);
+    EXPECT_EQ(r.threadCount, 3);
+
+    Scene scene = MeshBuilder::buildDefaultScene();
+    TileRenderer::render(scene, makeConfig(40, 40));
+    EXPECT_EQ(TileRenderer::lastStats().tileSize, 24);
+    EXPECT_EQ(TileRenderer::lastStats().threads, 3);
+
+    // Other workload classes keep the heuristic
+    r = Autotuner::resolve(makeConfig(2000, 2000));
+    EXPECT_EQ(r.tileSize, Autotuner::defaultTileSize(2000, 2000, r.threadCount));
+}
+
+TEST_F(AutotunerTest, LibraryDefaultsIgnoreTheProfile) {
+    TuningProfile profile;
+    profile.machine = TuningProfile::machineFingerprint();
+    profile.entries["avatar/light"] = TuningEntry{24, 3, 1.0};
+    ASSERT_TRUE(Autotuner::setProfile(profile));
+
+    RayTracer::Config config;
+    config.width = 128;
+    config.height = 128;
+    EXPECT_EQ(config.tileSchedule, TileSchedule::InOrder);
+    RayTracer::Config r = Autotuner::resolve(config);
+    EXPECT_EQ(r.tileSize, 32);
+    EXPECT_EQ(r.threadCount, Autotuner::hardwareThreads());
+}
+
+TEST_F(AutotunerTest, ProfileOfAnotherMachineIsIgnored) {
+    TuningProfile profile;
+    profile.machine = "1 threads, some other cpu";
+    profile.entries["avatar/light"] = TuningEntry{24, 3, 1.0};
+    EXPECT_FALSE(Autotuner::setProfile(profile));
+    EXPECT_NE(Autotuner::resolve(makeConfig(128, 128)).tileSize, 24);
+}
+
+TEST_F(AutotunerTest, ProfileRoundTrip) {
+    TuningProfile profile;
+    profile.machine = TuningProfile::machineFingerprint();
+    profile.entries["avatar/light"] = TuningEntry{16, 8, 12.5};
+    profile.entries["poster/heavy"] = TuningEntry{64, 32, 0.75};
+    fs::path path = fs::temp_directory_path() / "mcskin_test_tuning.txt";
+    ASSERT_TRUE(profile.save(path.string()));
+
+    auto loaded = TuningProfile::load(path.string());
+    ASSERT_TRUE(loaded.isOk()) << *loaded.error;
+    EXPECT_EQ(loaded.value->machine, profile.machine);
+    ASSERT_EQ(loaded.value->entries.size(), 2u);
+    EXPECT_EQ(loaded.value->find("poster/heavy")->tileSize, 64);
+    EXPECT_EQ(loaded.value->find("poster/heavy")->threadCount, 32);
+    EXPECT_DOUBLE_EQ(loaded.value->find("avatar/light")->megapixelsPerSecond, 12.5);
+    EXPECT_FALSE(loaded.value->find("hd/light").has_value());
+
+    std::ofstream(path, std::ios::app) << "broken line\n";
+    EXPECT_FALSE(TuningProfile::load(path.string()).isOk());
+    fs::remove(path);
+}
+
+TEST_F(AutotunerTest, TunePicksFastestProbe) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig(64, 48);
+    TuningOptions options;
+    options.tileSizes = {8, 32};
+    options.threadCounts = {1, 2};
+    options.repeats = 1;
+
+    TuningResult result = Autotuner::tune(scene, config, options);
+    EXPECT_EQ(result.workload, Autotuner::workloadClass(config));
+    ASSERT_EQ(result.probes.size(), 4u);
+    double fastest = result.probes.front().seconds;
+    for (const TuningProbe& p : result.probes) fastest = std::min(fastest, p.seconds);
+    EXPECT_GT(result.best.tileSize, 0);
+    EXPECT_GT(result.best.megapixelsPerSecond, 0.0);
+    EXPECT_NEAR(64.0 * 48.0 / fastest / 1e6, result.best.megapixelsPerSecond, 1e-9);
+}
+
+TEST_F(AutotunerTest, CancelledTuneStopsEarly) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    std::atomic<bool> cancel{true};
+    TuningOptions options;
+    options.tileSizes = {8, 32};
+    options.threadCounts = {1, 2};
+    options.cancel = &cancel;
+
+    TuningResult result = Autotuner::tune(scene, makeConfig(64, 48), options);
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_TRUE(result.probes.empty());
+    EXPECT_EQ(result.best.tileSize, 0);
+}
+
+TEST_F(AutotunerTest, TuningDoesNotChangeTheImage) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config a = makeConfig(50, 30);
+    a.samplesPerPixel = 2;
+    a.tileSize = 8;
+    a.threadCount = 3;
+    RayTracer::Config b = a;
+    b.tileSize = 0;
+    b.threadCount = 0;
+    EXPECT_EQ(ImageWriter::toRGBA8(TileRenderer::render(scene, a)),
+              ImageWriter::toRGBA8(TileRenderer::render(scene, b)));
+}
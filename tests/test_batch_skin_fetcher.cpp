@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "skin/batch_skin_fetcher.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ── Stand-in server ─────────────────────────────────────────────────────────
+
+// Plays the Mojang API, the session server and the texture host on one
+// local port. One request per connection ("Connection: close"), so the
+// number of requests received but not yet answered is the number the
+// fetcher has in flight.
+class StubMojangServer {
+public:
+    StubMojangServer() {
+        QObject::connect(&server_, &QTcpServer::newConnection, &server_, [this] { accept(); });
+        server_.listen(QHostAddress::LocalHost);
+    }
+
+    QString baseUrl() const {
+        return QStringLiteral("http://127.0.0.1:%1").arg(server_.serverPort());
+    }
+
+    static QString uuidFor(const QString& name) { return QStringLiteral("uuid-") + name.toLower(); }
+    static QByteArray skinFor(const QString& uuid) { return "PNG:" + uuid.toUtf8(); }
+
+    // Knobs
+    int responseDelayMs = 0;
+    bool failAll = false;           // answer everything with 500
+
+    // Observations
+    std::vector<int> uuidBatchSizes;
+    int profileRequests = 0;
+    int skinRequests = 0;
+    int notModified = 0;
+    int maxInFlight = 0;
+
+private:
+    struct Response {
+        int status = 200;
+        QByteArray reason = "OK";
+        QByteArray body;
+        QByteArray etag;
+    };
+
+    void accept() {
+        while (QTcpSocket* socket = server_.nextPendingConnection()) {
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket] { read(socket); });
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    void read(QTcpSocket* socket) {
+        QByteArray& buffer = buffers_[socket];
+        buffer += socket->readAll();
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+
+        const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+        QHash<QByteArray, QByteArray> headers;
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines[i].indexOf(':');
+            if (colon > 0) {
+                headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+            }
+        }
+        const int length = headers.value("content-length", "0").toInt();
+        if (buffer.size() < headerEnd + 4 + length) return;
+
+        const QByteArray body = buffer.mid(headerEnd + 4, length);
+        buffers_.remove(socket);
+        QObject::disconnect(socket, &QTcpSocket::readyRead, nullptr, nullptr);
+
+        ++inFlight_;
+        maxInFlight = std::max(maxInFlight, inFlight_);
+        const Response r = route(requestLine.value(0), requestLine.value(1), headers, body);
+
+        QTimer::singleShot(responseDelayMs, socket, [this, socket, r] {
+            --inFlight_;
+            QByteArray out = "HTTP/1.1 " + QByteArray::number(r.status) + " " + r.reason + "\r\n";
+            out += "Content-Length: " + QByteArray::number(r.body.size()) + "\r\n";
+            if (!r.etag.isEmpty()) out += "ETag: " + r.etag + "\r\n";
+            out += "Connection: close\r\n\r\n";
+            out += r.body;
+            socket->write(out);
+            socket->disconnectFromHost();
+        });
+    }
+
+    Response route(const QByteArray& method, const QByteArray& path,
+                   const QHash<QByteArray, QByteArray>& headers, const QByteArray& body) {
+        static const QByteArray profilePrefix = "/session/minecraft/profile/";
+        static const QByteArray texturePrefix = "/textures/";
+
+        if (method == "POST" && path == "/profiles/minecraft") {
+            const QJsonArray names = QJsonDocument::fromJson(body).array();
+            uuidBatchSizes.push_back(static_cast<int>(names.size()));
+            if (failAll) return {500, "Internal Server Error", {}, {}};
+
+            QJsonArray result;
+            for (const auto& v : names) {
+                result.append(QJsonObject{{"id", uuidFor(v.toString())}, {"name", v.toString()}});
+            }
+            return {200, "OK", QJsonDocument(result).toJson(QJsonDocument::Compact), {}};
+        }
+
+        if (path.startsWith(profilePrefix)) {
+            ++profileRequests;
+            if (failAll) return {500, "Internal Server Error", {}, {}};
+
+            const QString uuid = QString::fromUtf8(path.mid(profilePrefix.size()));
+            const QJsonObject textures{{"textures", QJsonObject{{"SKIN", QJsonObject{
+                {"url", baseUrl() + QString::fromLatin1(texturePrefix) + uuid}}}}}};
+            const QByteArray value = QJsonDocument(textures).toJson(QJsonDocument::Compact).toBase64();
+            const QJsonObject profile{
+                {"id", uuid},
+                {"properties", QJsonArray{QJsonObject{{"name", "textures"},
+                                                      {"value", QString::fromLatin1(value)}}}}};
+            return {200, "OK", QJsonDocument(profile).toJson(QJsonDocument::Compact), {}};
+        }
+
+        if (path.startsWith(texturePrefix)) {
+            ++skinRequests;
+            if (failAll) return {500, "Internal Server Error", {}, {}};
+
+            const QString uuid = QString::fromUtf8(path.mid(texturePrefix.size()));
+            const QByteArray etag = "\"" + uuid.toUtf8() + "\"";
+            if (headers.value("if-none-match") == etag) {
+                ++notModified;
+                return {304, "Not Modified", {}, etag};
+            }
+            return {200, "OK", skinFor(uuid), etag};
+        }
+
+        return {404, "Not Found", {}, {}};
+    }
+
+    QTcpServer server_;
+    QHash<QTcpSocket*, QByteArray> buffers_;
+    int inFlight_ = 0;
+};
+
+// ── Fixture ─────────────────────────────────────────────────────────────────
+
+class BatchSkinFetcherTest : public ::testing::Test {
+protected:
+    struct Outcome {
+        QHash<QString, QByteArray> skins;
+        QStringList failed;
+    };
+
+    void SetUp() override {
+        dir_ = (fs::temp_directory_path() / "mcskin_fetch_test").string();
+        fs::remove_all(dir_);
+        // Point the default endpoints at the stub, as a user would
+        qputenv("MCSKIN_API_BASE", server_.baseUrl().toUtf8());
+        qputenv("MCSKIN_SESSION_BASE", server_.baseUrl().toUtf8());
+    }
+    void TearDown() override {
+        qunsetenv("MCSKIN_API_BASE");
+        qunsetenv("MCSKIN_SESSION_BASE");
+        fs::remove_all(dir_);
+    }
+
+    BatchFetchOptions options() const {
+        BatchFetchOptions o;
+        o.cacheDir = QString::fromStdString(dir_);
+        return o;
+    }
+
+    static QStringList players(int count) {
+        QStringList names;
+        for (int i = 0; i < count; ++i) names.append(QStringLiteral("Player%1").arg(i));
+        return names;
+    }
+
+    // Fetch and run the event loop until the fetcher reports finished
+    Outcome run(const BatchFetchOptions& opts, const QStringList& names) {
+        Outcome outcome;
+        BatchSkinFetcher fetcher(opts);
+        QObject::connect(&fetcher, &BatchSkinFetcher::skinFetched, &fetcher,
+                         [&](const QString& name, const QByteArray& png) { outcome.skins.insert(name, png); });
+        QObject::connect(&fetcher, &BatchSkinFetcher::fetchFailed, &fetcher,
+                         [&](const QString& name, const QString&) { outcome.failed.append(name); });
+
+        QEventLoop loop;
+        QObject::connect(&fetcher, &BatchSkinFetcher::finished, &loop, &QEventLoop::quit);
+        QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+
+        fetcher.fetch(names);
+        // Everything may already have been served from the cache
+        if (!fetcher.isIdle()) loop.exec();
+        EXPECT_TRUE(fetcher.isIdle()) << "fetch did not finish in time";
+        return outcome;
+    }
+
+    StubMojangServer server_;
+    std::string dir_;
+};
+
+// ── Tests ───────────────────────────────────────────────────────────────────
+
+TEST_F(BatchSkinFetcherTest, ResolvesUuidsTenNamesPerRequest) {
+    const QStringList names = players(25);
+    Outcome outcome = run(options(), names);
+
+    EXPECT_EQ(server_.uuidBatchSizes, (std::vector<int>{10, 10, 5}));
+    EXPECT_TRUE(outcome.failed.isEmpty());
+    ASSERT_EQ(outcome.skins.size(), 25);
+    for (const QString& name : names) {
+        EXPECT_EQ(outcome.skins.value(name), StubMojangServer::skinFor(StubMojangServer::uuidFor(name)));
+    }
+}
+
+TEST_F(BatchSkinFetcherTest, KeepsAtMostMaxConcurrentRequestsInFlight) {
+    server_.responseDelayMs = 20;
+    BatchFetchOptions opts = options();
+    opts.maxConcurrent = 3;
+
+    Outcome outcome = run(opts, players(12));
+
+    EXPECT_EQ(outcome.skins.size(), 12);
+    // Twelve profile and skin requests queue up behind the delay, so the
+    // bound is reached, not just respected
+    EXPECT_EQ(server_.maxInFlight, 3);
+}
+
+TEST_F(BatchSkinFetcherTest, RevalidatesStaleSkinWithIfNoneMatch) {
+    const QStringList names = players(2);
+    Outcome first = run(options(), names);
+    ASSERT_EQ(first.skins.size(), 2);
+    EXPECT_EQ(server_.skinRequests, 2);
+    EXPECT_EQ(server_.notModified, 0);
+
+    BatchFetchOptions opts = options();
+    opts.skinTtl = 0;   // every cached skin is stale
+    Outcome second = run(opts, names);
+
+    EXPECT_EQ(server_.skinRequests, 4);
+    EXPECT_EQ(server_.notModified, 2);
+    EXPECT_EQ(second.skins, first.skins);
+}
+
+TEST_F(BatchSkinFetcherTest, RefetchesProfileOnlyAfterTtl) {
+    const QStringList names = players(3);
+    run(options(), names);
+    EXPECT_EQ(server_.profileRequests, 3);
+
+    // Within the TTL the cached profiles (and skins) are used as they are
+    Outcome cached = run(options(), names);
+    EXPECT_EQ(cached.skins.size(), 3);
+    EXPECT_EQ(server_.profileRequests, 3);
+    EXPECT_EQ(server_.uuidBatchSizes.size(), 1u);
+
+    BatchFetchOptions opts = options();
+    opts.profileTtl = 0;    // expired
+    Outcome expired = run(opts, names);
+    EXPECT_EQ(expired.skins.size(), 3);
+    EXPECT_EQ(server_.profileRequests, 6);
+}
+
+TEST_F(BatchSkinFetcherTest, FallsBackToStaleDataWhenServerFails) {
+    const QStringList names = players(2);
+    Outcome first = run(options(), names);
+    ASSERT_EQ(first.skins.size(), 2);
+
+    server_.failAll = true;
+    BatchFetchOptions opts = options();
+    opts.uuidTtl = 0;
+    opts.profileTtl = 0;
+    opts.skinTtl = 0;
+    Outcome second = run(opts, names + QStringList{QStringLiteral("Newcomer")});
+
+    // Every stage was asked again and failed, yet the cached data was served
+    EXPECT_EQ(server_.uuidBatchSizes.size(), 2u);
+    EXPECT_EQ(server_.profileRequests, 4);
+    EXPECT_EQ(server_.skinRequests, 4);
+    EXPECT_EQ(second.skins, first.skins);
+    // A name with nothing cached has nothing to fall back to
+    EXPECT_EQ(second.failed, QStringList{QStringLiteral("Newcomer")});
+}
+
+int main(int argc, char** argv) {
+    // QNetworkAccessManager and the stub server need an application object
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
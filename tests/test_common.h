@@ -0,0 +1,17 @@
+#pragma once
+
+#include "raytracer/raytracer.h"
+
+// Small render config shared by the renderer tests: one bounce, 16 px tiles
+// and two threads, so a frame has several tiles and they are shared out.
+// Tests set the fields they exercise on top of it.
+inline RayTracer::Config testRenderConfig(int width, int height, int samplesPerPixel = 1) {
+    RayTracer::Config config;
+    config.width = width;
+    config.height = height;
+    config.samplesPerPixel = samplesPerPixel;
+    config.maxBounces = 1;
+    config.tileSize = 16;
+    config.threadCount = 2;
+    return config;
+}
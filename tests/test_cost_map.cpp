@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "raytracer/cost_map.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static size_t countLines(const fs::path& path) {
+    std::ifstream in(path);
+    size_t n = 0;
+    std::string line;
+    while (std::getline(in, line)) ++n;
+    return n;
+}
+
+// ── Recording ──────────────────────────────────────────────────────────────
+
+TEST(CostMap, RecordsEveryPixelAndTile) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(40, 30, 2);
+
+    CostMap cost;
+    RenderControl control;
+    control.costMap = &cost;
+    Image withCost = TileRenderer::render(scene, config, nullptr, &control);
+
+    ASSERT_EQ(cost.width, 40);
+    ASSERT_EQ(cost.height, 30);
+    ASSERT_EQ(cost.tiles.size(), 6u);   // 3x2 tiles of 16px
+    for (const TileCost& t : cost.tiles) {
+        EXPECT_GE(t.thread, 0);
+        EXPECT_LT(t.thread, 2);
+        EXPECT_GT(t.seconds, 0.0);
+    }
+    for (float s : cost.pixelSeconds) EXPECT_GE(s, 0.0f);
+
+#if MCSKIN_RENDER_STATS
+    // Every pixel traces at least its primary rays; the per-pixel and
+    // per-tile counts add up to the render's total
+    uint64_t pixelSum = 0, tileSum = 0;
+    for (uint32_t r : cost.pixelRays) {
+        EXPECT_GE(r, 2u);
+        pixelSum += r;
+    }
+    for (const TileCost& t : cost.tiles) tileSum += t.rays;
+    EXPECT_EQ(pixelSum, TileRenderer::lastStats().counters.rays.total());
+    EXPECT_EQ(tileSum, pixelSum);
+#endif
+
+    // Recording must not change the image
+    Image plain = TileRenderer::render(scene, config);
+    EXPECT_EQ(withCost.pixels, plain.pixels);
+}
+
+TEST(CostMap, TileTimeSpreadsOverTilePixels) {
+    CostMap cost;
+    cost.reset(4, 2, 2);
+    cost.tiles[0] = TileCost{0, 0, 2, 2, 4.0, 0, 0};
+    cost.tiles[1] = TileCost{2, 0, 2, 2, 8.0, 0, 1};
+
+    std::vector<float> v = cost.values(CostMetric::TileTime);
+    ASSERT_EQ(v.size(), 8u);
+    EXPECT_FLOAT_EQ(v[0], 1.0f);
+    EXPECT_FLOAT_EQ(v[4 + 1], 1.0f);
+    EXPECT_FLOAT_EQ(v[2], 2.0f);
+    EXPECT_FLOAT_EQ(v[4 + 3], 2.0f);
+}
+
+// ── Output ─────────────────────────────────────────────────────────────────
+
+TEST(CostMap, WritesHeatmapAndCsv) {
+    fs::path dir = fs::temp_directory_path() / "mcskin_cost_map_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    CostMap cost;
+    RenderControl control;
+    control.costMap = &cost;
+    TileRenderer::render(MeshBuilder::buildDefaultScene(), testRenderConfig(40, 30, 2), nullptr, &control);
+
+    Image heat = cost.heatmap(CostMetric::PixelTime);
+    EXPECT_EQ(heat.width, 40);
+    EXPECT_EQ(heat.height, 30);
+
+    EXPECT_TRUE(cost.writeHeatmapPNG((dir / "time.png").string(), CostMetric::PixelTime));
+    EXPECT_TRUE(cost.writeHeatmapPNG((dir / "tiles.png").string(), CostMetric::TileTime));
+    EXPECT_TRUE(cost.writePixelCSV((dir / "pixels.csv").string()));
+    EXPECT_TRUE(cost.writeTileCSV((dir / "tiles.csv").string()));
+
+    auto loaded = Image::load((dir / "time.png").string());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->width, 40);
+    EXPECT_EQ(countLines(dir / "pixels.csv"), 1u + 40u * 30u);
+    EXPECT_EQ(countLines(dir / "tiles.csv"), 1u + 6u);
+
+    EXPECT_FALSE(cost.writePixelCSV((dir / "missing" / "pixels.csv").string()));
+    fs::remove_all(dir);
+}
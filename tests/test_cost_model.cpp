@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "raytracer/cost_model.h"
+#include "raytracer/tile_renderer.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <chrono>
+
+TEST(CostModel, CoverageIsAFraction) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    double c = CostModel::estimateCoverage(scene, testRenderConfig(64, 64));
+    EXPECT_GT(c, 0.0);
+    EXPECT_LT(c, 1.0);
+
+    Scene empty;
+    empty.camera = scene.camera;
+    EXPECT_EQ(CostModel::estimateCoverage(empty, testRenderConfig(64, 64)), 0.0);
+}
+
+TEST(CostModel, PredictionFollowsTheRayModel) {
+    CostModel model;
+    model.reflectionHitRate = 0.5;
+    RayTracer::Config config = testRenderConfig(100, 100);
+    config.maxBounces = 2;
+    config.softShadows = true;
+    config.shadowSamples = 4;
+    config.aoEnabled = false;
+
+    CostPrediction p = model.predict(config, 0.5);
+    EXPECT_EQ(p.rays[RayKind::Primary], 10000u);
+    EXPECT_EQ(p.rays[RayKind::Reflection], 5000u * 3 / 2);     // c * (1 + h)
+    EXPECT_EQ(p.rays[RayKind::Shadow], 5000u * 7 / 4 * 4);     // c * (1 + h + h²) * S
+    EXPECT_EQ(p.rays[RayKind::AO], 0u);
+
+    // Linear in samples per pixel
+    config.samplesPerPixel = 4;
+    CostPrediction p4 = model.predict(config, 0.5);
+    EXPECT_NEAR(p4.workSeconds, 4.0 * p.workSeconds, 1e-9);
+    EXPECT_GT(p.wallSeconds, 0.0);
+}
+
+#if MCSKIN_RENDER_STATS
+
+TEST(CostModel, CalibratedPredictionIsClose) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(96, 96);
+    config.softShadows = true;
+    config.shadowSamples = 4;
+    config.aoEnabled = true;
+    config.aoSamples = 4;
+    config.samplesPerPixel = 2;
+
+    auto model = CostModel::calibrate(scene, config, 48 * 48);
+    ASSERT_TRUE(model.isOk()) << *model.error;
+    EXPECT_TRUE(model.value->calibrated);
+
+    double coverage = CostModel::estimateCoverage(scene, config);
+    CostPrediction p = model.value->predict(config, coverage);
+    TileRenderer::render(scene, config);
+    const RenderStats& s = TileRenderer::lastStats();
+
+    // Ray counts come from the counters and should be tight; times are
+    // noisy on shared machines
+    double rays = static_cast<double>(s.counters.rays.total());
+    EXPECT_NEAR(static_cast<double>(p.rays.total()) / rays, 1.0, 0.25);
+    EXPECT_GT(p.wallSeconds, s.totalSeconds / 5.0);
+    EXPECT_LT(p.wallSeconds, s.totalSeconds * 5.0);
+}
+
+#endif
+
+TEST(CostModel, DeadlineModeStaysWithinBudget) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(64, 64);
+    config.samplesPerPixel = 64;
+
+    // Planning with a model that is far too optimistic: the deadline still
+    // stops the refinement
+    CostModel optimistic;
+    optimistic.secondsPerRay = 1e-12;
+    optimistic.secondsPerSample = 1e-12;
+    const double budget = 0.2;
+
+    int lastSamples = 0;
+    auto start = std::chrono::steady_clock::now();
+    DeadlineResult r = TileRenderer::renderWithin(scene, config, budget, optimistic,
+                                                  [&](int done, int) { lastSamples = done; });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(r.plannedSamples, 64);
+    EXPECT_GE(r.samplesPerPixel, 1);
+    EXPECT_EQ(lastSamples, r.samplesPerPixel);
+    if (r.samplesPerPixel < r.plannedSamples) {
+        EXPECT_TRUE(r.deadlineReached);
+    }
+    EXPECT_LT(wall, budget + 0.5);
+    ASSERT_EQ(r.image.width, 64);
+    ASSERT_EQ(r.image.height, 64);
+
+    // A generous budget renders everything that was asked for
+    config.samplesPerPixel = 2;
+    r = TileRenderer::renderWithin(scene, config, 60.0, CostModel{});
+    EXPECT_EQ(r.samplesPerPixel, 2);
+    EXPECT_FALSE(r.deadlineReached);
+}
+
+TEST(CostModel, CutFirstPassIsFilledFromACoarsePass) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    scene.backgroundColor = Color(0.2f, 0.3f, 0.4f);
+    RayTracer::Config config = testRenderConfig(64, 64);
+    config.samplesPerPixel = 4;
+    config.tileSize = 8;
+
+    // The deadline has passed before the first tile: nothing is traced at
+    // full resolution, every pixel comes from the coarse pass
+    RenderMonitor monitor;
+    CostMap costMap;
+    RenderControl control;
+    control.monitor = &monitor;
+    control.costMap = &costMap;
+    DeadlineResult r = TileRenderer::renderWithin(scene, config, 0.0, CostModel{}, nullptr, &control);
+    EXPECT_EQ(r.samplesPerPixel, 1);
+    EXPECT_TRUE(r.deadlineReached);
+    EXPECT_EQ(r.coarsePixels, 64 * 64);
+    for (const Color& c : r.image.pixels) {
+        ASSERT_GT(c.r + c.g + c.b, 0.0f);
+        ASSERT_GE(c.a, 0.0f);
+    }
+
+    // The caller's control ran the full-resolution pass, not the coarse
+    // one, and got its deadline back
+    EXPECT_EQ(monitor.snapshot().tilesTotal, 64);
+    EXPECT_EQ(costMap.width, 64);
+    EXPECT_EQ(costMap.height, 64);
+    EXPECT_EQ(control.deadline, std::chrono::steady_clock::time_point::max());
+    EXPECT_EQ(control.accumulator, nullptr);
+}
+
+TEST(CostModel, DeadlineImageIsTheSampleSetOfRender) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(48, 40);
+    config.samplesPerPixel = 5;     // passes of 1, 1, 2 and a final 1
+
+    DeadlineResult r = TileRenderer::renderWithin(scene, config, 60.0, CostModel{});
+    ASSERT_EQ(r.samplesPerPixel, 5);
+    EXPECT_EQ(ImageWriter::toRGBA8(r.image),
+              ImageWriter::toRGBA8(TileRenderer::render(scene, config)));
+}
+
+TEST(CostModel, TightBudgetReducesEffectSamples) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(64, 64);
+    config.softShadows = true;
+    config.shadowSamples = 16;
+    config.aoEnabled = true;
+    config.aoSamples = 16;
+    config.samplesPerPixel = 8;
+
+    CostModel slow;
+    slow.secondsPerRay = 1e-3;
+    DeadlineResult r = TileRenderer::renderWithin(scene, config, 0.05, slow);
+    EXPECT_EQ(r.plannedSamples, 1);
+    EXPECT_LT(r.shadowSamples, 16);
+    EXPECT_LT(r.aoSamples, 16);
+    EXPECT_GE(r.samplesPerPixel, 1);
+}
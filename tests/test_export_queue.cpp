@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include "output/export_queue.h"
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class ExportQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / "mcskin_export_queue_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    static Scene makeScene() {
+        Scene scene;
+        scene.backgroundColor = Color(0.1f, 0.1f, 0.1f);
+        scene.light = Light{Vec3(0, 50, 50), Color(1, 1, 1), 1.0f};
+        scene.camera = Camera{Vec3(0, 18, 40), Vec3(0, 18, 0), Vec3(0, 1, 0), 60.0f};
+        return scene;
+    }
+
+    static RayTracer::Config makeConfig(int w, int h) {
+        RayTracer::Config config;
+        config.width = w;
+        config.height = h;
+        config.maxBounces = 0;
+        config.tileSize = 8;
+        config.threadCount = 2;
+        return config;
+    }
+
+    std::string path(const char* name) const { return (dir_ / name).string(); }
+
+    fs::path dir_;
+};
+
+TEST_F(ExportQueueTest, RunsJobsInOrderAndWritesFiles) {
+    std::mutex mutex;
+    std::vector<std::pair<int, ExportStatus>> events;
+    ExportQueue queue([&](const ExportJobInfo& info) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (events.empty() || events.back() != std::make_pair(info.id, info.status)) {
+            events.emplace_back(info.id, info.status);
+        }
+    });
+
+    int a = queue.enqueue(makeScene(), makeConfig(16, 16), path("a.png"));
+    int b = queue.enqueue(makeScene(), makeConfig(24, 8), path("b.png"));
+    EXPECT_NE(a, b);
+    ASSERT_TRUE(queue.waitIdle(10000));
+
+    EXPECT_TRUE(fs::exists(path("a.png")));
+    EXPECT_TRUE(fs::exists(path("b.png")));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::pair<int, ExportStatus>> expected = {
+        {a, ExportStatus::Running}, {a, ExportStatus::Done},
+        {b, ExportStatus::Running}, {b, ExportStatus::Done},
+    };
+    EXPECT_EQ(events, expected);
+
+    auto info = queue.job(b);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->width, 24);
+    EXPECT_EQ(info->tilesDone, info->tilesTotal);
+    EXPECT_EQ(info->tilesTotal, 3);
+    EXPECT_DOUBLE_EQ(info->etaSeconds, 0.0);
+
+    // The last successful export is kept for region re-renders
+    auto last = queue.lastResult();
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(last->info.id, b);
+    EXPECT_EQ(last->image.width, 24);
+    EXPECT_EQ(last->image.height, 8);
+    EXPECT_EQ(last->config.width, 24);
+}
+
+TEST_F(ExportQueueTest, ProgressReportsEtaPerTile) {
+    std::mutex mutex;
+    std::vector<ExportJobInfo> updates;
+    ExportQueue queue([&](const ExportJobInfo& info) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (info.status == ExportStatus::Running && info.tilesTotal > 0) updates.push_back(info);
+    });
+    RayTracer::Config config = makeConfig(32, 32);
+    config.threadCount = 1;
+    queue.enqueue(makeScene(), config, path("p.png"));
+    ASSERT_TRUE(queue.waitIdle(10000));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(updates.size(), 16u);
+    for (size_t i = 0; i < updates.size(); ++i) {
+        EXPECT_EQ(updates[i].tilesDone, static_cast<int>(i + 1));
+        EXPECT_GE(updates[i].etaSeconds, 0.0);
+    }
+    EXPECT_DOUBLE_EQ(updates.back().etaSeconds, 0.0);
+}
+
+TEST_F(ExportQueueTest, CancelQueuedJobSkipsIt) {
+    ExportQueue queue;
+    queue.setPaused(true);   // nothing starts while paused
+    int a = queue.enqueue(makeScene(), makeConfig(16, 16), path("a.png"));
+    int b = queue.enqueue(makeScene(), makeConfig(16, 16), path("b.png"));
+
+    EXPECT_TRUE(queue.cancel(b));
+    EXPECT_FALSE(queue.cancel(b));
+    EXPECT_FALSE(queue.cancel(12345));
+    EXPECT_EQ(queue.job(b)->status, ExportStatus::Cancelled);
+    EXPECT_EQ(queue.job(a)->status, ExportStatus::Queued);
+
+    queue.setPaused(false);
+    ASSERT_TRUE(queue.waitIdle(10000));
+    EXPECT_EQ(queue.job(a)->status, ExportStatus::Done);
+    EXPECT_TRUE(fs::exists(path("a.png")));
+    EXPECT_FALSE(fs::exists(path("b.png")));
+}
+
+TEST_F(ExportQueueTest, PauseHoldsRunningJob) {
+    // Pause from the "running" notification, before the first tile
+    ExportQueue* self = nullptr;
+    std::atomic<bool> started{false};
+    ExportQueue queue([&](const ExportJobInfo& info) {
+        if (info.status == ExportStatus::Running && !started.exchange(true)) {
+            self->setPaused(true);
+        }
+    });
+    self = &queue;
+    RayTracer::Config config = makeConfig(64, 64);
+    config.threadCount = 1;
+
+    queue.enqueue(makeScene(), config, path("a.png"));
+    while (!started.load()) std::this_thread::yield();
+    EXPECT_TRUE(queue.isPaused());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(queue.jobs().front().status, ExportStatus::Running);
+    EXPECT_EQ(queue.jobs().front().tilesDone, 0);
+    EXPECT_FALSE(queue.waitIdle(0));
+
+    queue.setPaused(false);
+    ASSERT_TRUE(queue.waitIdle(10000));
+    EXPECT_EQ(queue.jobs().front().status, ExportStatus::Done);
+    EXPECT_EQ(queue.jobs().front().tilesDone, 64);
+}
+
+TEST_F(ExportQueueTest, CancelRunningJobAndDestroyWithPendingWork) {
+    std::atomic<bool> started{false};
+    auto queue = std::make_unique<ExportQueue>([&](const ExportJobInfo& info) {
+        if (info.status == ExportStatus::Running) started.store(true);
+    });
+    RayTracer::Config big = makeConfig(256, 256);
+    big.samplesPerPixel = 16;
+    big.threadCount = 1;
+
+    int a = queue->enqueue(makeScene(), big, path("a.png"));
+    queue->enqueue(makeScene(), big, path("b.png"));
+    while (!started.load()) std::this_thread::yield();
+
+    EXPECT_TRUE(queue->cancel(a));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.reset();   // must not block on the remaining job
+    EXPECT_FALSE(fs::exists(path("a.png")));
+}
+
+TEST_F(ExportQueueTest, AccountsJobMemory) {
+    ExportQueue queue;
+    Scene scene = makeScene();
+    RayTracer::Config config = makeConfig(32, 16);
+    int id = queue.enqueue(scene, config, path("m.png"));
+    ASSERT_TRUE(queue.waitIdle(10000));
+
+    // The job's snapshot and framebuffer, as allocated
+    const MemoryUsage snapshot = MemoryFootprint::scene(Scene(scene));
+    const uint64_t framebuffer = 32u * 16u * sizeof(Color);
+    auto info = queue.job(id);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->status, ExportStatus::Done);
+    EXPECT_EQ(info->memoryEstimate, MemoryEstimate::job(scene, config).total());
+    EXPECT_EQ(info->peakMemoryBytes, snapshot.total() + framebuffer);
+    EXPECT_EQ(info->memoryBytes, 0u);
+
+    // What is left: the cached result and the queue's reused buffers
+    MemoryUsage left = queue.memory().current();
+    EXPECT_EQ(left[MemoryCategory::Framebuffer], 0u);
+    EXPECT_EQ(left[MemoryCategory::Scene], 0u);
+    EXPECT_EQ(left[MemoryCategory::Caches], snapshot.total() + framebuffer);
+    EXPECT_GE(left[MemoryCategory::Encoder], 32u * 16u * 4u);
+    EXPECT_GT(left[MemoryCategory::Renderer], 0u);
+}
+
+TEST_F(ExportQueueTest, MemoryBudgetRejectsOversizedJobs) {
+    std::mutex mutex;
+    std::vector<ExportStatus> events;
+    ExportQueue queue([&](const ExportJobInfo& info) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(info.status);
+    });
+    RayTracer::Config small = makeConfig(16, 16);
+    RayTracer::Config large = makeConfig(512, 512);
+    queue.setMemoryBudget(MemoryEstimate::job(makeScene(), small).total() * 2);
+
+    int rejected = queue.enqueue(makeScene(), large, path("large.png"));
+    int accepted = queue.enqueue(makeScene(), small, path("small.png"));
+    ASSERT_TRUE(queue.waitIdle(10000));
+
+    auto r = queue.job(rejected);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->status, ExportStatus::Failed);
+    EXPECT_FALSE(r->error.empty());
+    EXPECT_FALSE(fs::exists(path("large.png")));
+    EXPECT_EQ(queue.job(accepted)->status, ExportStatus::Done);
+    EXPECT_LE(queue.memory().peakTotal(), queue.memoryBudget());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(events.front(), ExportStatus::Failed);
+}
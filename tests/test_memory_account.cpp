@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "raytracer/memory_account.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// ── Account ─────────────────────────────────────────────────────────────────
+
+TEST(MemoryAccount, TracksCurrentAndPeakTotal) {
+    MemoryAccount account;
+    {
+        MemoryCharge scene(&account, MemoryCategory::Scene, 100);
+        MemoryCharge frame(&account, MemoryCategory::Framebuffer, 1000);
+        EXPECT_EQ(account.currentTotal(), 1100u);
+        frame.reset();
+        MemoryCharge encoder(&account, MemoryCategory::Encoder, 500);
+        EXPECT_EQ(account.currentTotal(), 600u);
+    }
+    EXPECT_EQ(account.currentTotal(), 0u);
+    EXPECT_EQ(account.peakTotal(), 1100u);
+
+    // The peak breakdown is the moment of the peak, not per-category maxima
+    MemoryUsage peak = account.peak();
+    EXPECT_EQ(peak[MemoryCategory::Scene], 100u);
+    EXPECT_EQ(peak[MemoryCategory::Framebuffer], 1000u);
+    EXPECT_EQ(peak[MemoryCategory::Encoder], 0u);
+    EXPECT_EQ(peak.total(), account.peakTotal());
+}
+
+TEST(MemoryAccount, ChargesRollUpIntoParent) {
+    MemoryAccount queue;
+    MemoryAccount a(&queue), b(&queue);
+    MemoryCharge ca(&a, MemoryCategory::Textures, 300);
+    {
+        MemoryCharge cb(&b, MemoryCategory::Textures, 200);
+        MemoryCharge moved = std::move(cb);
+        EXPECT_EQ(queue.current()[MemoryCategory::Textures], 500u);
+    }
+    EXPECT_EQ(queue.currentTotal(), 300u);
+    EXPECT_EQ(queue.peakTotal(), 500u);
+    EXPECT_EQ(b.peakTotal(), 200u);
+
+    MemoryCharge none(nullptr, MemoryCategory::Caches, 1 << 20);  // no account: no-op
+    EXPECT_EQ(queue.currentTotal(), 300u);
+}
+
+TEST(MemoryAccount, UpdatedChargeFollowsTheBuffer) {
+    MemoryAccount queue;
+    MemoryAccount job(&queue);
+    std::vector<Color> buffer(100);
+    MemoryCharge charge(&job, MemoryCategory::Renderer, MemoryFootprint::of(buffer));
+    EXPECT_EQ(job.currentTotal(), 100u * sizeof(Color));
+
+    buffer.resize(400);
+    charge.update(MemoryFootprint::of(buffer));
+    EXPECT_EQ(queue.current()[MemoryCategory::Renderer], buffer.capacity() * sizeof(Color));
+    std::vector<Color>().swap(buffer);
+    charge.update(MemoryFootprint::of(buffer));
+    EXPECT_EQ(queue.currentTotal(), 0u);
+    EXPECT_GE(queue.peakTotal(), 400u * sizeof(Color));
+}
+
+// ── Footprint ───────────────────────────────────────────────────────────────
+
+TEST(MemoryFootprint, CountsCapacityNotSize) {
+    Image image(8, 4);
+    EXPECT_EQ(MemoryFootprint::image(image), 32u * sizeof(Color));
+    image.pixels.reserve(64);
+    EXPECT_EQ(MemoryFootprint::image(image), 64u * sizeof(Color));
+
+    // A copy holds no spare capacity, which is what the estimate predicts
+    Scene scene = MeshBuilder::buildDefaultScene();
+    scene.meshes.reserve(scene.meshes.size() + 8);
+    Scene copy = scene;
+    EXPECT_GT(MemoryFootprint::scene(scene).total(), MemoryFootprint::scene(copy).total());
+    EXPECT_EQ(MemoryFootprint::scene(copy).bytes, MemoryEstimate::scene(scene).bytes);
+}
+
+// ── Estimate ────────────────────────────────────────────────────────────────
+
+TEST(MemoryEstimate, CoversSceneFramebufferAndEncoder) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config;
+    config.width = 320;
+    config.height = 200;
+
+    MemoryUsage s = MemoryEstimate::scene(scene);
+    EXPECT_GT(s[MemoryCategory::Scene], scene.meshes.size() * sizeof(Mesh));
+    EXPECT_GT(s[MemoryCategory::Textures], 0u);
+
+    MemoryUsage job = MemoryEstimate::job(scene, config);
+    EXPECT_EQ(job[MemoryCategory::Framebuffer], 320u * 200u * sizeof(Color));
+    EXPECT_GE(job[MemoryCategory::Encoder], 320u * 200u * 4u);
+    EXPECT_EQ(job[MemoryCategory::Caches], 0u);
+    EXPECT_EQ(job.total(), s.total() + job[MemoryCategory::Framebuffer] + job[MemoryCategory::Encoder]);
+}
+
+TEST(MemoryFootprint, ImageWriterChargesGivenAccount) {
+    MemoryAccount account;
+    Image image(40, 30);
+    fs::path path = fs::temp_directory_path() / "mcskin_test_memory.png";
+    ASSERT_TRUE(ImageWriter::writePNG(image, path.string(), &account));
+    EXPECT_EQ(account.currentTotal(), 0u);
+    EXPECT_EQ(account.peak()[MemoryCategory::Encoder], 40u * 30u * 4u);   // RGBA8 staging
+    fs::remove(path);
+}
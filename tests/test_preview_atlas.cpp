@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "gui/preview_atlas.h"
+#include "scene/mesh_builder.h"
+#include "scene/pose.h"
+#include <cmath>
+
+// Helper: skin where every face texel has a distinct colour
+static SkinData makeSkin() {
+    SkinData skin;
+    skin.format = SkinData::NEW_64x64;
+    int n = 0;
+    auto fill = [&n](BodyPartTexture& part, int w, int h, int d, float alpha) {
+        auto face = [&](int fw, int fh) {
+            ++n;
+            std::vector<Color> px(fw * fh);
+            for (int i = 0; i < fw * fh; ++i) {
+                px[i] = Color((n * 37 % 255) / 255.0f, (i * 5 % 255) / 255.0f,
+                              ((n + i) * 13 % 255) / 255.0f, alpha);
+            }
+            return TextureRegion(fw, fh, std::move(px));
+        };
+        part.front = face(w, h);  part.back = face(w, h);
+        part.left = face(d, h);   part.right = face(d, h);
+        part.top = face(w, d);    part.bottom = face(w, d);
+    };
+    fill(skin.head, 8, 8, 8, 1.0f);
+    fill(skin.body, 8, 12, 4, 1.0f);
+    fill(skin.rightArm, 4, 12, 4, 1.0f);
+    fill(skin.leftArm, 4, 12, 4, 1.0f);
+    fill(skin.rightLeg, 4, 12, 4, 1.0f);
+    fill(skin.leftLeg, 4, 12, 4, 1.0f);
+    fill(skin.headOuter, 8, 8, 8, 1.0f);
+    fill(skin.bodyOuter, 8, 12, 4, 0.0f);
+    fill(skin.rightArmOuter, 4, 12, 4, 0.0f);
+    fill(skin.leftArmOuter, 4, 12, 4, 0.0f);
+    fill(skin.rightLegOuter, 4, 12, 4, 0.0f);
+    fill(skin.leftLegOuter, 4, 12, 4, 0.0f);
+    return skin;
+}
+
+static Pose bentPose() {
+    Pose pose;
+    pose.head.rotX = 15.0f;
+    pose.rightArm.rotX = -40.0f;
+    pose.leftArm.rotZ = 25.0f;
+    pose.rightLeg.rotX = 30.0f;
+    pose.leftLeg.rotX = -30.0f;
+    pose.leftLeg.rotZ = 5.0f;
+    return pose;
+}
+
+TEST(PreviewAtlas, PackedRectsAreDisjointAndInBounds) {
+    std::vector<std::pair<int, int>> sizes = {
+        {8, 8}, {8, 12}, {4, 12}, {1, 1}, {8, 4}, {4, 4}, {12, 3}, {8, 8}, {2, 9},
+    };
+    const int pad = 1;
+    AtlasPacking packing = PreviewAtlas::pack(sizes, pad);
+
+    ASSERT_EQ(packing.rects.size(), sizes.size());
+    EXPECT_EQ(packing.width & (packing.width - 1), 0);
+    EXPECT_EQ(packing.height & (packing.height - 1), 0);
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        const AtlasRect& a = packing.rects[i];
+        EXPECT_EQ(a.w, sizes[i].first);
+        EXPECT_EQ(a.h, sizes[i].second);
+        EXPECT_GE(a.x - pad, 0);
+        EXPECT_GE(a.y - pad, 0);
+        EXPECT_LE(a.x + a.w + pad, packing.width);
+        EXPECT_LE(a.y + a.h + pad, packing.height);
+
+        // Padded rectangles must not overlap
+        for (size_t j = i + 1; j < sizes.size(); ++j) {
+            const AtlasRect& b = packing.rects[j];
+            bool apart = a.x + a.w + pad <= b.x - pad || b.x + b.w + pad <= a.x - pad
+                      || a.y + a.h + pad <= b.y - pad || b.y + b.h + pad <= a.y - pad;
+            EXPECT_TRUE(apart) << "rects " << i << " and " << j << " overlap";
+        }
+    }
+}
+
+TEST(PreviewAtlas, AtlasUvsSampleTheOriginalFaceTexels) {
+    Scene scene = MeshBuilder::buildScene(makeSkin());
+    PreviewGeometry geo = PreviewAtlas::build(scene);
+
+    size_t triCount = 0;
+    for (const auto& m : scene.meshes) triCount += m.triangles.size();
+    ASSERT_EQ(geo.vertexCount, static_cast<int>(triCount * 3));
+    ASSERT_EQ(geo.partSlots.size(), scene.meshes.size());
+
+    // Sample the atlas at each triangle's UV centroid (nearest filtering)
+    // and compare with the texture the raytracer would use
+    int v = 0;
+    for (const auto& mesh : scene.meshes) {
+        for (const auto& tri : mesh.triangles) {
+            const float* a = &geo.vertices[(v + 0) * PREVIEW_VERTEX_FLOATS];
+            const float* b = &geo.vertices[(v + 1) * PREVIEW_VERTEX_FLOATS];
+            const float* c = &geo.vertices[(v + 2) * PREVIEW_VERTEX_FLOATS];
+            float u = (a[6] + b[6] + c[6]) / 3.0f;
+            float w = (a[7] + b[7] + c[7]) / 3.0f;
+            int px = static_cast<int>(u * geo.atlasWidth);
+            int py = static_cast<int>(w * geo.atlasHeight);
+            const uint8_t* texel = &geo.atlasPixels[(py * geo.atlasWidth + px) * 4];
+
+            float tu = (tri.u0 + tri.u1 + tri.u2) / 3.0f;
+            float tv = (tri.v0_uv + tri.v1_uv + tri.v2_uv) / 3.0f;
+            Color expected = tri.texture->sample(tu, tv);
+            EXPECT_NEAR(texel[0], expected.r * 255.0f, 1.0f);
+            EXPECT_NEAR(texel[1], expected.g * 255.0f, 1.0f);
+            EXPECT_NEAR(texel[2], expected.b * 255.0f, 1.0f);
+            EXPECT_NEAR(texel[3], expected.a * 255.0f, 1.0f);
+            v += 3;
+        }
+    }
+}
+
+TEST(PreviewAtlas, PartTransformsReproducePosedGeometry) {
+    Scene posed = MeshBuilder::buildScene(makeSkin(), bentPose());
+    PreviewGeometry geo = PreviewAtlas::build(posed);
+    auto transforms = PreviewAtlas::partTransforms(posed);
+    ASSERT_EQ(transforms.size(), static_cast<size_t>(PREVIEW_MAX_PARTS));
+
+    int v = 0;
+    for (const auto& mesh : posed.meshes) {
+        for (const auto& tri : mesh.triangles) {
+            const Vec3 world[3] = {tri.v0, tri.v1, tri.v2};
+            for (int k = 0; k < 3; ++k, ++v) {
+                const float* vtx = &geo.vertices[v * PREVIEW_VERTEX_FLOATS];
+                const PreviewMatrix& m = transforms[static_cast<int>(vtx[8])];
+                float x = m[0] * vtx[0] + m[4] * vtx[1] + m[8] * vtx[2] + m[12];
+                float y = m[1] * vtx[0] + m[5] * vtx[1] + m[9] * vtx[2] + m[13];
+                float z = m[2] * vtx[0] + m[6] * vtx[1] + m[10] * vtx[2] + m[14];
+                EXPECT_NEAR(x, world[k].x, 1e-4f);
+                EXPECT_NEAR(y, world[k].y, 1e-4f);
+                EXPECT_NEAR(z, world[k].z, 1e-4f);
+            }
+        }
+    }
+}
+
+TEST(PreviewAtlas, PoseChangeKeepsGeometryKey) {
+    SkinData skin = makeSkin();
+    Scene rest = MeshBuilder::buildScene(skin);
+    Scene posed = MeshBuilder::buildScene(skin, bentPose());
+    EXPECT_EQ(PreviewAtlas::geometryKey(rest), PreviewAtlas::geometryKey(posed));
+
+    // ...and the uploaded buffers are identical
+    PreviewGeometry a = PreviewAtlas::build(rest);
+    PreviewGeometry b = PreviewAtlas::build(posed);
+    EXPECT_EQ(a.vertices, b.vertices);
+    EXPECT_EQ(a.atlasPixels, b.atlasPixels);
+
+    // A different skin changes it
+    SkinData other = skin;
+    other.head.front.pixels[0] = Color(0.5f, 0.5f, 0.5f, 1.0f);
+    EXPECT_NE(PreviewAtlas::geometryKey(MeshBuilder::buildScene(other)),
+              PreviewAtlas::geometryKey(rest));
+}
+
+TEST(PreviewAtlas, EmptySceneBuildsValidAtlas) {
+    Scene scene;
+    PreviewGeometry geo = PreviewAtlas::build(scene);
+    EXPECT_EQ(geo.vertexCount, 0);
+    EXPECT_GT(geo.atlasWidth, 0);
+    EXPECT_GT(geo.atlasHeight, 0);
+    EXPECT_EQ(geo.atlasPixels.size(), static_cast<size_t>(geo.atlasWidth * geo.atlasHeight * 4));
+}
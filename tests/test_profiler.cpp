@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "diagnostics/profiler.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <set>
+#include <string>
+#include <thread>
+
+static size_t countOf(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+// Profiler state is global; every test starts from a clean, disabled profiler
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Profiler::enable();
+        Profiler::disable();
+    }
+    void TearDown() override { Profiler::disable(); }
+};
+
+TEST_F(ProfilerTest, DisabledRecordsNothing) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    TileRenderer::render(scene, testRenderConfig(40, 30));
+    { ProfileZone zone("outside"); }
+    EXPECT_EQ(Profiler::eventCount(), 0u);
+}
+
+TEST_F(ProfilerTest, RenderEmitsTileAndStageEvents) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(40, 30);
+    int tiles = 0;
+
+    Profiler::enable();
+    TileRenderer::render(scene, config, [&](int, int total) { tiles = total; });
+    Profiler::disable();
+
+    std::string json = Profiler::chromeTraceJson();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_EQ(countOf(json, "\"name\":\"tile\""), static_cast<size_t>(tiles));
+    EXPECT_EQ(countOf(json, "\"name\":\"render\""), 1u);
+    EXPECT_EQ(countOf(json, "\"name\":\"setup\""), 1u);
+    EXPECT_EQ(countOf(json, "\"name\":\"progress callback\""), static_cast<size_t>(tiles));
+    EXPECT_EQ(countOf(json, "\"name\":\"wait progress lock\""), static_cast<size_t>(tiles));
+    EXPECT_NE(json.find("\"render worker 0\""), std::string::npos);
+    EXPECT_NE(json.find("\"render worker 1\""), std::string::npos);
+}
+
+TEST_F(ProfilerTest, RingBufferKeepsNewestEvents) {
+    Profiler::enable(4);
+    std::thread t([] {
+        for (int i = 0; i < 10; ++i) ProfileZone zone("step", "test", i);
+    });
+    t.join();
+    Profiler::disable();
+
+    EXPECT_EQ(Profiler::eventCount(), 4u);
+    std::string json = Profiler::chromeTraceJson();
+    EXPECT_EQ(json.find("\"value\":5}"), std::string::npos);
+    for (int i = 6; i < 10; ++i) {
+        EXPECT_NE(json.find("\"value\":" + std::to_string(i) + "}"), std::string::npos) << i;
+    }
+}
+
+TEST_F(ProfilerTest, BuffersAreReusedAcrossRenders) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(40, 30);
+
+    Profiler::enable();
+    TileRenderer::render(scene, config);
+    size_t afterFirst = Profiler::eventCount();
+    for (int i = 0; i < 5; ++i) TileRenderer::render(scene, config);
+    Profiler::disable();
+
+    // Each render spawns fresh workers; they pick up the buffers of the
+    // previous ones instead of allocating new ones, so nothing is lost
+    EXPECT_EQ(Profiler::eventCount(), afterFirst * 6);
+    std::string json = Profiler::chromeTraceJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"render\""), 6u);
+}
+
+TEST_F(ProfilerTest, ThreadNamesStayBoundedBySimultaneousThreads) {
+    Profiler::enable();
+    for (int i = 0; i < 20; ++i) {
+        std::thread t([i] {
+            Profiler::setThreadName("short-lived " + std::to_string(i));
+            ProfileZone zone("work");
+        });
+        t.join();
+    }
+    Profiler::disable();
+
+    // One at a time: they all share one buffer, one row and the last name
+    std::string json = Profiler::chromeTraceJson();
+    EXPECT_EQ(countOf(json, "\"short-lived "), 1u);
+    EXPECT_NE(json.find("\"short-lived 19\""), std::string::npos);
+    EXPECT_EQ(countOf(json, "\"name\":\"work\""), 20u);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "raytracer/progressive_renderer.h"
+#include "test_common.h"
+#include <mutex>
+#include <vector>
+
+// Background-only scene: the gradient makes every jittered sample differ
+static Scene makeScene() {
+    Scene scene;
+    scene.backgroundColor = Color(0.1f, 0.1f, 0.1f);
+    scene.light = Light{Vec3(0, 50, 50), Color(1, 1, 1), 1.0f};
+    scene.camera = Camera{Vec3(0, 18, 40), Vec3(0, 18, 0), Vec3(0, 1, 0), 60.0f};
+    return scene;
+}
+
+static RayTracer::Config makeConfig() {
+    RayTracer::Config config = testRenderConfig(24, 16);
+    config.maxBounces = 0;
+    config.tileSize = 8;
+    return config;
+}
+
+struct FrameLog {
+    std::mutex mutex;
+    std::vector<int> samples;
+    std::vector<uint64_t> generations;
+    Image last;
+
+    ProgressiveRenderer::FrameCallback callback() {
+        return [this](const Image& frame, int s, uint64_t gen) {
+            std::lock_guard<std::mutex> lock(mutex);
+            samples.push_back(s);
+            generations.push_back(gen);
+            last = frame;
+        };
+    }
+};
+
+TEST(ProgressiveRenderer, CoarsePassThenRefinesToMaxSamples) {
+    FrameLog log;
+    ProgressiveRenderer renderer(log.callback());
+    ProgressiveOptions options;
+    options.lowResDivisor = 4;
+    options.maxSamples = 5;
+
+    uint64_t gen = renderer.restart(makeScene(), makeConfig(), options);
+    ASSERT_TRUE(renderer.waitIdle(10000));
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    ASSERT_EQ(log.samples, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    for (uint64_t g : log.generations) EXPECT_EQ(g, gen);
+    EXPECT_EQ(log.last.width, 24);
+    EXPECT_EQ(log.last.height, 16);
+
+    // Framebuffer, running sums and frame were charged while the job ran
+    EXPECT_GE(renderer.memory().peak()[MemoryCategory::Framebuffer], 3u * 24u * 16u * sizeof(Color));
+    EXPECT_EQ(renderer.memory().current()[MemoryCategory::Framebuffer], 0u);
+    // The render pool outlives the job, and so does its charge
+    EXPECT_GT(renderer.memory().current()[MemoryCategory::Renderer], 0u);
+}
+
+TEST(ProgressiveRenderer, FirstRefinedFrameMatchesSingleSampleRender) {
+    FrameLog log;
+    ProgressiveRenderer renderer(log.callback());
+    ProgressiveOptions options;
+    options.lowResDivisor = 1;
+    options.maxSamples = 1;
+
+    renderer.restart(makeScene(), makeConfig(), options);
+    ASSERT_TRUE(renderer.waitIdle(10000));
+
+    Image reference = TileRenderer::render(makeScene(), makeConfig());
+    std::lock_guard<std::mutex> lock(log.mutex);
+    ASSERT_EQ(log.samples, (std::vector<int>{1}));
+    ASSERT_EQ(log.last.pixels.size(), reference.pixels.size());
+    for (size_t i = 0; i < reference.pixels.size(); ++i) {
+        EXPECT_EQ(log.last.pixels[i], reference.pixels[i]) << "pixel " << i;
+    }
+}
+
+TEST(ProgressiveRenderer, RefinementIsDeterministic) {
+    ProgressiveOptions options;
+    options.lowResDivisor = 2;
+    options.maxSamples = 4;
+
+    FrameLog a, b;
+    {
+        ProgressiveRenderer renderer(a.callback());
+        renderer.restart(makeScene(), makeConfig(), options);
+        ASSERT_TRUE(renderer.waitIdle(10000));
+    }
+    {
+        RayTracer::Config config = makeConfig();
+        config.threadCount = 1;
+        config.tileSize = 5;
+        ProgressiveRenderer renderer(b.callback());
+        renderer.restart(makeScene(), config, options);
+        ASSERT_TRUE(renderer.waitIdle(10000));
+    }
+    EXPECT_EQ(a.last.pixels, b.last.pixels);
+}
+
+TEST(ProgressiveRenderer, RestartSupersedesPreviousGeneration) {
+    FrameLog log;
+    ProgressiveRenderer renderer(log.callback());
+    ProgressiveOptions slow;
+    slow.maxSamples = 1000;
+
+    uint64_t first = renderer.restart(makeScene(), makeConfig(), slow);
+    ProgressiveOptions quick;
+    quick.maxSamples = 2;
+    uint64_t second = renderer.restart(makeScene(), makeConfig(), quick);
+    EXPECT_GT(second, first);
+    EXPECT_EQ(renderer.generation(), second);
+    ASSERT_TRUE(renderer.waitIdle(10000));
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    ASSERT_FALSE(log.generations.empty());
+    EXPECT_EQ(log.generations.back(), second);
+    EXPECT_EQ(log.samples.back(), 2);
+}
+
+TEST(ProgressiveRenderer, StopGoesIdle) {
+    FrameLog log;
+    ProgressiveRenderer renderer(log.callback());
+    ProgressiveOptions options;
+    options.maxSamples = 100000;
+
+    renderer.restart(makeScene(), makeConfig(), options);
+    renderer.stop();
+    EXPECT_TRUE(renderer.waitIdle(10000));
+}
+
+TEST(ProgressiveRenderer, RegionFramesCoverOnlyTheRegion) {
+    ProgressiveOptions options;
+    options.lowResDivisor = 3;
+    options.maxSamples = 2;
+
+    FrameLog full;
+    {
+        ProgressiveRenderer renderer(full.callback());
+        renderer.restart(makeScene(), makeConfig(), options);
+        ASSERT_TRUE(renderer.waitIdle(10000));
+    }
+
+    FrameLog log;
+    ProgressiveRenderer renderer(log.callback());
+    RayTracer::Config config = makeConfig();
+    config.regionX = 4;
+    config.regionY = 2;
+    config.regionWidth = 8;
+    config.regionHeight = 6;
+    renderer.restart(makeScene(), config, options);
+    ASSERT_TRUE(renderer.waitIdle(10000));
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    ASSERT_EQ(log.samples, (std::vector<int>{0, 1, 2}));
+    const Image& img = log.last;
+    ASSERT_EQ(img.width, 8);
+    ASSERT_EQ(img.height, 6);
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            EXPECT_EQ(img.pixels[y * 8 + x], full.last.pixels[(y + 2) * 24 + x + 4]) << x << "," << y;
+        }
+    }
+}
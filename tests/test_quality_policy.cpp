@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "raytracer/quality_policy.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+
+// Every effect the policy scales, turned up
+static RayTracer::Config makeConfig(int size) {
+    RayTracer::Config config = testRenderConfig(size, size);
+    config.maxBounces = 4;
+    config.softShadows = true;
+    config.shadowSamples = 16;
+    config.aoEnabled = true;
+    config.aoSamples = 16;
+    config.dofEnabled = true;
+    config.aperture = 0.3f;
+    return config;
+}
+
+TEST(QualityPolicy, TexelSizeScalesWithResolution) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    float small = QualityPolicy::texelPixels(scene, makeConfig(64));
+    float large = QualityPolicy::texelPixels(scene, makeConfig(1024));
+    EXPECT_GT(small, 0.0f);
+    EXPECT_NEAR(large / small, 16.0f, 1e-3f);
+
+    Scene empty;
+    empty.camera = scene.camera;
+    EXPECT_EQ(QualityPolicy::texelPixels(empty, makeConfig(64)), 0.0f);
+}
+
+TEST(QualityPolicy, OffScreenGeometryDoesNotSetTheTexelSize) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    const float before = QualityPolicy::texelPixels(scene, makeConfig(64));
+
+    // A triangle right in front of the lens but far outside the frame
+    const Camera& cam = scene.camera;
+    Vec3 forward = (cam.target - cam.position).normalize();
+    Vec3 right = forward.cross(cam.up).normalize();
+    Vec3 beside = cam.position + forward * 0.5f + right * 10.0f;
+    Triangle t{};
+    t.v0 = beside;
+    t.v1 = beside + right;
+    t.v2 = beside + forward;
+    Mesh mesh;
+    mesh.triangles.push_back(t);
+    scene.meshes.push_back(mesh);
+
+    EXPECT_FLOAT_EQ(QualityPolicy::texelPixels(scene, makeConfig(64)), before);
+}
+
+TEST(QualityPolicy, LargeOutputsKeepFullQuality) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig(1024);
+    QualityReport report;
+    RayTracer::Config out = QualityPolicy().apply(scene, config, &report);
+    EXPECT_EQ(out.shadowSamples, 16);
+    EXPECT_EQ(out.aoSamples, 16);
+    EXPECT_EQ(out.maxBounces, 4);
+    EXPECT_TRUE(out.dofEnabled);
+    EXPECT_TRUE(report.applied);
+    EXPECT_GE(report.texelPixels, 4.0f);
+}
+
+TEST(QualityPolicy, SmallOutputsScaleEffectsDown) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    QualityPolicy policy;
+    RayTracer::Config out = policy.apply(scene, makeConfig(64));
+    EXPECT_LT(out.shadowSamples, 16);
+    EXPECT_GE(out.shadowSamples, policy.minShadowSamples);
+    EXPECT_LT(out.aoSamples, 16);
+    EXPECT_GE(out.aoSamples, policy.minAoSamples);
+    EXPECT_EQ(out.maxBounces, 1);
+    EXPECT_FALSE(out.dofEnabled);   // blur circle well under a pixel
+
+    // Settings below the policy minimum are left alone
+    RayTracer::Config few = makeConfig(64);
+    few.shadowSamples = 1;
+    few.maxBounces = 0;
+    out = policy.apply(scene, few);
+    EXPECT_EQ(out.shadowSamples, 1);
+    EXPECT_EQ(out.maxBounces, 0);
+
+    // A wide aperture still blurs visibly
+    few.aperture = 20.0f;
+    EXPECT_TRUE(policy.apply(scene, few).dofEnabled);
+}
+
+TEST(QualityPolicy, RenderReportsTheChosenLevels) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig(64);
+    TileRenderer::render(scene, config);
+    EXPECT_FALSE(TileRenderer::lastStats().quality.applied);
+
+    config.autoQuality = true;
+    TileRenderer::render(scene, config);
+    const QualityReport& q = TileRenderer::lastStats().quality;
+    EXPECT_TRUE(q.applied);
+    EXPECT_EQ(q.maxBounces, 1);
+    EXPECT_LT(q.shadowSamples, 16);
+    EXPECT_FALSE(q.dofEnabled);
+
+    // The thresholds come from the config: full detail already at 64²
+    config.quality.fullDetailTexelPixels = 0.5f;
+    TileRenderer::render(scene, config);
+    const QualityReport& full = TileRenderer::lastStats().quality;
+    EXPECT_TRUE(full.applied);
+    EXPECT_EQ(full.maxBounces, config.maxBounces);
+    EXPECT_EQ(full.shadowSamples, config.shadowSamples);
+}
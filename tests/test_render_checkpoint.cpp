@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "output/render_checkpoint.h"
+#include "raytracer/memory_account.h"
+#include "raytracer/quality_policy.h"
+#include "raytracer/render_pool.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static fs::path tempPath(const std::string& name) {
+    return fs::temp_directory_path() / ("mcskin_test_" + name);
+}
+
+static RayTracer::Config makeConfig() {
+    RayTracer::Config config = testRenderConfig(40, 32, 5);
+    config.softShadows = true;
+    config.shadowSamples = 2;
+    config.tileSize = 8;
+    return config;
+}
+
+static bool sameBits(const Image& a, const Image& b) {
+    return a.width == b.width && a.height == b.height
+        && std::memcmp(a.pixels.data(), b.pixels.data(), a.pixels.size() * sizeof(Color)) == 0;
+}
+
+TEST(RenderCheckpoint, CancelledAndResumedRenderIsBitIdentical) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    const Image reference = TileRenderer::render(scene, config);
+
+    fs::path path = tempPath("resume.mcckpt");
+    fs::remove(path);
+    CheckpointOptions options;
+    options.path = path.string();
+    options.samplesPerPass = 2;
+
+    // Stop after the first pass, as a preempted process would
+    RenderControl control;
+    auto first = RenderCheckpointFile::render(scene, config, options,
+        [&](int, int) { control.cancel.store(true); }, &control);
+    ASSERT_TRUE(first.isOk()) << *first.error;
+    EXPECT_FALSE(first.value->complete);
+    EXPECT_EQ(first.value->samplesPerPixel, 2);
+    EXPECT_EQ(first.value->checkpointsWritten, 1);
+    ASSERT_TRUE(fs::exists(path));
+
+    // Resume on another thread count: only the speed changes
+    config.threadCount = 3;
+    MemoryAccount memory;
+    options.memory = &memory;
+    auto resumed = RenderCheckpointFile::render(scene, config, options);
+    ASSERT_TRUE(resumed.isOk()) << *resumed.error;
+    EXPECT_TRUE(resumed.value->complete);
+    EXPECT_EQ(resumed.value->resumedFrom, 2);
+    EXPECT_EQ(resumed.value->samplesPerPixel, 5);
+    EXPECT_TRUE(sameBits(resumed.value->image, reference));
+    EXPECT_FALSE(fs::exists(path));     // removed once complete
+
+    // Sums, pass framebuffer and pool were charged, and released on return
+    const uint64_t pixels = 40u * 32u;
+    EXPECT_EQ(memory.currentTotal(), 0u);
+    EXPECT_EQ(memory.peak()[MemoryCategory::Framebuffer], pixels * sizeof(Color));
+    EXPECT_GE(memory.peak()[MemoryCategory::Renderer], pixels * (sizeof(Color) + sizeof(uint32_t)));
+}
+
+TEST(RenderCheckpoint, PixelsAtDifferentCountsCatchUp) {
+    // A pass cut short leaves some tiles ahead: build such a state by
+    // running one pass over part of the image only
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    const Image reference = TileRenderer::render(scene, config);
+
+    RenderCheckpoint checkpoint;
+    checkpoint.fingerprint = RenderCheckpointFile::fingerprint(scene, config);
+    checkpoint.width = config.width;
+    checkpoint.height = config.height;
+    checkpoint.accumulator.totalSamples = config.samplesPerPixel;
+    RenderControl control;
+    control.accumulator = &checkpoint.accumulator;
+    RayTracer::Config partial = config;
+    partial.samplesPerPixel = 3;
+    partial.regionX = 8;
+    partial.regionY = 8;
+    partial.regionWidth = 16;
+    partial.regionHeight = 16;
+    TileRenderer::render(scene, partial, nullptr, &control);
+    EXPECT_EQ(checkpoint.accumulator.samples[0], 0u);
+    EXPECT_EQ(checkpoint.accumulator.samples[8 * config.width + 8], 3u);
+
+    fs::path path = tempPath("partial.mcckpt");
+    ASSERT_TRUE(RenderCheckpointFile::write(checkpoint, path.string()));
+    auto loaded = RenderCheckpointFile::read(path.string());
+    ASSERT_TRUE(loaded.isOk()) << *loaded.error;
+    EXPECT_EQ(loaded.value->accumulator.samples, checkpoint.accumulator.samples);
+
+    CheckpointOptions options;
+    options.path = path.string();
+    options.samplesPerPass = 4;
+    auto resumed = RenderCheckpointFile::render(scene, config, options);
+    ASSERT_TRUE(resumed.isOk()) << *resumed.error;
+    EXPECT_EQ(resumed.value->resumedFrom, 0);
+    EXPECT_TRUE(sameBits(resumed.value->image, reference));
+}
+
+TEST(RenderCheckpoint, RefusesACheckpointOfAnotherRender) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    fs::path path = tempPath("other.mcckpt");
+    fs::remove(path);
+    CheckpointOptions options;
+    options.path = path.string();
+
+    RenderControl control;
+    control.cancel.store(true);
+    ASSERT_TRUE(RenderCheckpointFile::render(scene, config, options, nullptr, &control).isOk());
+    ASSERT_TRUE(fs::exists(path));
+    const auto size = fs::file_size(path);
+
+    RayTracer::Config brighter = config;
+    brighter.aoEnabled = true;
+    EXPECT_FALSE(RenderCheckpointFile::render(scene, brighter, options).isOk());
+    Scene moved = scene;
+    moved.light.position.x += 1.0f;
+    EXPECT_FALSE(RenderCheckpointFile::render(moved, config, options).isOk());
+    EXPECT_EQ(fs::file_size(path), size);
+
+    // Truncated files are rejected
+    fs::resize_file(path, size - 7);
+    auto truncated = RenderCheckpointFile::read(path.string());
+    EXPECT_FALSE(truncated.isOk());
+    fs::remove(path);
+}
+
+TEST(RenderCheckpoint, FingerprintFollowsTheEffectsAsTraced) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    config.shadowSamples = 16;
+    config.aoEnabled = true;
+    config.aoSamples = 16;
+    config.maxBounces = 4;
+    RayTracer::Config automatic = config;
+    automatic.autoQuality = true;
+
+    // At 40x32 the policy lowers the effects: a checkpoint of the full
+    // effects is not one of the automatic render, the lowered config is
+    RayTracer::Config traced = QualityPolicy::resolve(scene, automatic);
+    traced.autoQuality = false;
+    ASSERT_LT(traced.shadowSamples, config.shadowSamples);
+    EXPECT_NE(RenderCheckpointFile::fingerprint(scene, automatic),
+              RenderCheckpointFile::fingerprint(scene, config));
+    EXPECT_EQ(RenderCheckpointFile::fingerprint(scene, automatic),
+              RenderCheckpointFile::fingerprint(scene, traced));
+}
+
+TEST(RenderCheckpoint, StalledPassIsAnErrorNotALoop) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    fs::path path = tempPath("stalled.mcckpt");
+    fs::remove(path);
+    CheckpointOptions options;
+    options.path = path.string();
+
+    // Past its deadline the control lets no worker take a tile
+    RenderControl control;
+    control.deadline = std::chrono::steady_clock::now();
+    auto result = RenderCheckpointFile::render(scene, config, options, nullptr, &control);
+    EXPECT_FALSE(result.isOk());
+    EXPECT_TRUE(fs::exists(path));      // state saved all the same
+
+    // Without the deadline it resumes and completes
+    auto resumed = RenderCheckpointFile::render(scene, config, options);
+    ASSERT_TRUE(resumed.isOk());
+    EXPECT_TRUE(resumed.value->complete);
+    fs::remove(path);
+}
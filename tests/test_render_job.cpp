@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "output/render_job.h"
+#include "output/image_writer.h"
+#include "diagnostics/profiler.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static fs::path tempPath(const std::string& name) {
+    return fs::temp_directory_path() / ("mcskin_test_" + name);
+}
+
+// Synthetic 64x64 skin: every texel distinct, outer layer half transparent
+static Rgba8Image makeSkinPixels() {
+    Rgba8Image img;
+    img.width = 64;
+    img.height = 64;
+    img.pixels.resize(64 * 64 * 4);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            uint8_t* p = &img.pixels[(y * 64 + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 4);
+            p[1] = static_cast<uint8_t>(y * 4);
+            p[2] = static_cast<uint8_t>((x ^ y) * 4);
+            p[3] = ((x + y) % 2 == 0) ? 255 : 0;
+        }
+    }
+    return img;
+}
+
+static RenderJob makeJob() {
+    Rgba8Image skin = makeSkinPixels();
+    Pose pose = getBuiltinPoses()[2];
+    auto parsed = SkinParser::parse(skin.view());
+    Scene scene = MeshBuilder::buildScene(*parsed.value, pose);
+    scene.camera.position = Vec3(12.5f, 20.25f, 40.0f);
+    scene.camera.fov = 47.3f;
+    scene.light.position = Vec3(-7.0f, 33.0f, 11.0f);
+    scene.light.color = Color(1.0f, 0.9f, 0.8f, 1.0f);
+    scene.light.radius = 2.5f;
+
+    RayTracer::Config config;
+    config.width = 48;
+    config.height = 40;
+    config.samplesPerPixel = 2;
+    config.maxBounces = 2;
+    config.tileSize = 16;
+    config.threadCount = 3;
+    config.shadowSamples = 3;
+    config.aoEnabled = true;
+    config.aoSamples = 2;
+    config.aoIntensity = 0.7f;
+    config.gradientScale = 1.3f;
+    config.bgEdge = Color(0.1f, 0.2f, 0.3f, 1.0f);
+    config.autoQuality = true;
+    config.quality.fullDetailTexelPixels = 6.5f;
+    config.quality.minAoSamples = 3;
+    return RenderJob::capture(&skin, pose, scene, config);
+}
+
+static bool sameBits(float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }
+
+// ── File ────────────────────────────────────────────────────────────────────
+
+TEST(RenderJob, RoundTripPreservesEveryField) {
+    RenderJob job = makeJob();
+    fs::path path = tempPath("roundtrip.mcjob");
+    ASSERT_TRUE(RenderJobFile::write(job, path.string()));
+
+    auto read = RenderJobFile::read(path.string());
+    ASSERT_TRUE(read.isOk()) << *read.error;
+    const RenderJob& r = *read.value;
+
+    EXPECT_EQ(r.skin.width, 64);
+    EXPECT_EQ(r.skin.height, 64);
+    EXPECT_EQ(r.skin.pixels, job.skin.pixels);
+    EXPECT_EQ(r.pose.name, job.pose.name);
+    EXPECT_TRUE(sameBits(r.pose.rightArm.rotX, job.pose.rightArm.rotX));
+    EXPECT_TRUE(sameBits(r.pose.leftLeg.rotX, job.pose.leftLeg.rotX));
+    EXPECT_TRUE(sameBits(r.camera.position.y, job.camera.position.y));
+    EXPECT_TRUE(sameBits(r.camera.fov, job.camera.fov));
+    EXPECT_TRUE(sameBits(r.light.position.x, job.light.position.x));
+    EXPECT_TRUE(sameBits(r.light.color.b, job.light.color.b));
+    EXPECT_TRUE(sameBits(r.light.radius, job.light.radius));
+    EXPECT_EQ(r.config.width, 48);
+    EXPECT_EQ(r.config.threadCount, 3);
+    EXPECT_EQ(r.config.aoEnabled, true);
+    EXPECT_TRUE(sameBits(r.config.aoIntensity, job.config.aoIntensity));
+    EXPECT_TRUE(sameBits(r.config.gradientScale, job.config.gradientScale));
+    EXPECT_TRUE(sameBits(r.config.bgEdge.g, job.config.bgEdge.g));
+    EXPECT_TRUE(r.config.autoQuality);
+    EXPECT_TRUE(sameBits(r.config.quality.fullDetailTexelPixels, 6.5f));
+    EXPECT_EQ(r.config.quality.minAoSamples, 3);
+
+    // Writing what was read gives the same bytes
+    fs::path again = tempPath("roundtrip2.mcjob");
+    ASSERT_TRUE(RenderJobFile::write(r, again.string()));
+    std::ifstream a(path, std::ios::binary), b(again, std::ios::binary);
+    std::string bytesA((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+    std::string bytesB((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(bytesA, bytesB);
+
+    fs::remove(path);
+    fs::remove(again);
+}
+
+TEST(RenderJob, RejectsDamagedFiles) {
+    RenderJob job = makeJob();
+    fs::path path = tempPath("damaged.mcjob");
+    ASSERT_TRUE(RenderJobFile::write(job, path.string()));
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    auto rewrite = [&](const std::string& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    };
+
+    rewrite(bytes.substr(0, bytes.size() - 3));
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+
+    rewrite(bytes + "x");
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+
+    std::string badMagic = bytes;
+    badMagic[0] = 'X';
+    rewrite(badMagic);
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+
+    std::string badVersion = bytes;
+    badVersion[4] = 99;
+    rewrite(badVersion);
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+
+    // Enums out of range: the config ends with 31 u32 after traversal,
+    // and tileSchedule comes right before it
+    const size_t traversalAt = bytes.size() - 4 * 32;
+    std::string badTraversal = bytes;
+    badTraversal[traversalAt] = 3;
+    rewrite(badTraversal);
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+    std::string badSchedule = bytes;
+    badSchedule[traversalAt - 4] = 2;
+    rewrite(badSchedule);
+    EXPECT_FALSE(RenderJobFile::read(path.string()).isOk());
+    std::string lastValues = bytes;
+    lastValues[traversalAt] = 2;        // Hilbert
+    lastValues[traversalAt - 4] = 1;    // CostFirst
+    rewrite(lastValues);
+    auto valid = RenderJobFile::read(path.string());
+    ASSERT_TRUE(valid.isOk()) << *valid.error;
+    EXPECT_EQ(valid.value->config.traversal, Traversal::Hilbert);
+    EXPECT_EQ(valid.value->config.tileSchedule, TileSchedule::CostFirst);
+
+    EXPECT_FALSE(RenderJobFile::read(tempPath("missing.mcjob").string()).isOk());
+    fs::remove(path);
+}
+
+// ── Replay ──────────────────────────────────────────────────────────────────
+
+TEST(RenderJob, ReplayMatchesOriginalRender) {
+    RenderJob job = makeJob();
+    auto scene = job.buildScene();
+    ASSERT_TRUE(scene.isOk()) << *scene.error;
+    Image original = TileRenderer::render(*scene.value, job.config);
+
+    fs::path path = tempPath("replay.mcjob");
+    ASSERT_TRUE(RenderJobFile::write(job, path.string()));
+    auto read = RenderJobFile::read(path.string());
+    ASSERT_TRUE(read.isOk());
+    fs::remove(path);
+
+    // Another thread count must not change a single bit
+    auto replay = RenderJobFile::replay(*read.value, 1);
+    ASSERT_TRUE(replay.isOk()) << *replay.error;
+    EXPECT_EQ(ImageWriter::toRGBA8(replay.value->image), ImageWriter::toRGBA8(original));
+    for (size_t i = 0; i < original.pixels.size(); ++i) {
+        ASSERT_TRUE(sameBits(replay.value->image.pixels[i].r, original.pixels[i].r)) << i;
+    }
+
+    const ReplayResult& r = *replay.value;
+    EXPECT_EQ(r.stats.threads, 1);
+    EXPECT_GT(r.renderSeconds, 0.0);
+    EXPECT_NE(r.traceJson.find("\"parse skin\""), std::string::npos);
+    EXPECT_NE(r.traceJson.find("\"build scene\""), std::string::npos);
+    EXPECT_NE(r.traceJson.find("\"tile\""), std::string::npos);
+    EXPECT_FALSE(Profiler::enabled());
+}
+
+TEST(RenderJob, DefaultModelWithoutSkin) {
+    RenderJob job = RenderJob::capture(nullptr, Pose{}, MeshBuilder::buildDefaultScene(), RayTracer::Config{});
+    job.config.width = 16;
+    job.config.height = 16;
+    auto scene = job.buildScene();
+    ASSERT_TRUE(scene.isOk());
+    EXPECT_EQ(scene.value->meshes.size(), MeshBuilder::buildDefaultScene().meshes.size());
+
+    fs::path path = tempPath("default.mcjob");
+    ASSERT_TRUE(RenderJobFile::write(job, path.string()));
+    auto read = RenderJobFile::read(path.string());
+    ASSERT_TRUE(read.isOk());
+    EXPECT_TRUE(read.value->skin.pixels.empty());
+    fs::remove(path);
+}
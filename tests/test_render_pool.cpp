@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "raytracer/render_pool.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+
+// Tile cost estimates and splitting on: the pool's whole job storage
+static RayTracer::Config makeConfig() {
+    RayTracer::Config config = testRenderConfig(48, 40, 2);
+    config.tileSchedule = TileSchedule::CostFirst;
+    return config;
+}
+
+TEST(RenderPool, SameImageAsRender) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    RenderPool pool;
+    Image framebuffer;
+    TileRenderer::renderInto(scene, config, framebuffer, pool);
+    EXPECT_EQ(ImageWriter::toRGBA8(framebuffer),
+              ImageWriter::toRGBA8(TileRenderer::render(scene, config)));
+
+    // A region render overwrites only the region of the framebuffer
+    Image before = framebuffer;
+    for (Color& c : framebuffer.pixels) c = Color(1.0f, 0.0f, 1.0f, 1.0f);
+    config.regionX = 8;
+    config.regionY = 4;
+    config.regionWidth = 20;
+    config.regionHeight = 12;
+    TileRenderer::renderInto(scene, config, framebuffer, pool);
+    for (int y = 0; y < config.height; ++y) {
+        for (int x = 0; x < config.width; ++x) {
+            bool inside = x >= 8 && x < 28 && y >= 4 && y < 16;
+            const Color& c = framebuffer.pixels[y * config.width + x];
+            const Color& expected = inside ? before.pixels[y * config.width + x]
+                                           : Color(1.0f, 0.0f, 1.0f, 1.0f);
+            ASSERT_EQ(c.r, expected.r) << x << "," << y;
+            ASSERT_EQ(c.g, expected.g) << x << "," << y;
+        }
+    }
+}
+
+TEST(RenderPool, CoverageIsKeptAcrossPassesOverOneView) {
+    if (!MCSKIN_RENDER_STATS) GTEST_SKIP() << "counters compiled out";
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    RenderPool pool;
+    Image framebuffer;
+
+    // The estimate rays are traced on the calling thread, the tiles on the
+    // workers: the caller's box tests count estimate work only
+    auto estimateWork = [&](const Scene& s, const RayTracer::Config& c) {
+        uint64_t before = threadCounters().boxTests;
+        TileRenderer::renderInto(s, c, framebuffer, pool);
+        return threadCounters().boxTests - before;
+    };
+    EXPECT_GT(estimateWork(scene, config), 0u);
+
+    // Progressive-style passes: other samples and effects, same view
+    RayTracer::Config pass = config;
+    pass.samplesPerPixel = 1;
+    pass.sampleOffset = 3;
+    pass.shadowSamples = 4;
+    EXPECT_EQ(estimateWork(scene, pass), 0u);
+    EXPECT_EQ(estimateWork(Scene(scene), pass), 0u);   // a copy is the same view
+
+    Scene moved = scene;
+    moved.camera.position = moved.camera.position * 0.8f;
+    EXPECT_GT(estimateWork(moved, pass), 0u);
+    RayTracer::Config resized = pass;
+    resized.width = 64;
+    EXPECT_GT(estimateWork(moved, resized), 0u);
+}
+
+TEST(RenderPool, PooledEncodingMatchesFreshBuffers) {
+    Image image(37, 23);
+    for (size_t i = 0; i < image.pixels.size(); ++i) {
+        float t = static_cast<float>(i % 97) / 96.0f;
+        image.pixels[i] = Color(t, 1.0f - t, 0.25f, 1.0f);
+    }
+    EncodeBuffer pooled;
+    for (int round = 0; round < 3; ++round) {
+        ASSERT_TRUE(ImageWriter::encodePNG(image, pooled));
+        EncodeBuffer fresh;
+        ASSERT_TRUE(ImageWriter::encodePNG(image, fresh));
+        EXPECT_EQ(pooled.png, fresh.png);
+
+        auto decoded = Rgba8Image::decode(pooled.png.data(), pooled.png.size());
+        ASSERT_TRUE(decoded.has_value());
+        EXPECT_EQ(decoded->pixels, ImageWriter::toRGBA8(image));
+    }
+    EXPECT_FALSE(ImageWriter::encodePNG(Image(), pooled));
+    EXPECT_TRUE(pooled.png.empty());
+}
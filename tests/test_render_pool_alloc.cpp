@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "raytracer/render_pool.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Steady-state allocation checks for RenderPool. The global allocation
+// functions are replaced for this binary only (mcskin_alloc_tests), so the
+// other tests keep the library's operator new.
+//
+// Every ordinary and array form of new / delete, plain and nothrow, goes
+// through malloc/free here, so any pairing the compiler or library picks
+// matches. Over-aligned (align_val_t) allocations keep the library's own
+// functions and are not counted. stb_image_write's scratch is malloc'd
+// inside each encode and not seen either.
+static std::atomic<bool> countAllocations{false};
+static std::atomic<int> allocations{0};
+
+static void* countedAlloc(std::size_t size) noexcept {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+// Tile cost estimates and splitting on: the pool's whole job storage
+static RayTracer::Config makeConfig() {
+    RayTracer::Config config = testRenderConfig(48, 40, 2);
+    config.tileSchedule = TileSchedule::CostFirst;
+    return config;
+}
+
+TEST(RenderPool, SteadyStateBatchDoesNotAllocate) {
+    const RayTracer::Config config = makeConfig();
+    std::vector<Scene> scenes(2, MeshBuilder::buildDefaultScene());
+    scenes[1].camera.position = scenes[1].camera.position * 0.8f;
+
+    RenderPool pool;
+    Image framebuffer;
+    EncodeBuffer encoder;
+    for (const Scene& scene : scenes) {         // warm up
+        TileRenderer::renderInto(scene, config, framebuffer, pool);
+        ASSERT_TRUE(ImageWriter::encodePNG(framebuffer, encoder));
+    }
+    const void* png = encoder.png.data();
+
+    allocations = 0;
+    countAllocations = true;
+    bool ok = true;
+    for (int job = 0; job < 6; ++job) {
+        TileRenderer::renderInto(scenes[job % 2], config, framebuffer, pool);
+        ok = ImageWriter::encodePNG(framebuffer, encoder) && ok;
+    }
+    countAllocations = false;
+
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(allocations.load(), 0);
+    EXPECT_EQ(encoder.png.data(), png);         // the output fit the kept capacity
+    EXPECT_EQ(pool.threads(), 2);
+    EXPECT_TRUE(TileRenderer::lastErrors().empty());
+    EXPECT_EQ(TileRenderer::lastStats().tiles, 9);
+
+    // The hook does see render(): image, tiles, threads
+    countAllocations = true;
+    TileRenderer::render(scenes[0], config);
+    countAllocations = false;
+    EXPECT_GT(allocations.load(), 0);
+}
+
+TEST(RenderPool, CurveTraversalsWithSplitTilesDoNotAllocate) {
+    std::vector<Scene> scenes(2, MeshBuilder::buildDefaultScene());
+    scenes[1].camera.position = scenes[1].camera.position * 0.8f;
+
+    for (Traversal traversal : {Traversal::Morton, Traversal::Hilbert}) {
+        // Ragged edge tiles, and more workers than tiles at the tail: the
+        // scheduler hands out split pieces of several shapes
+        RayTracer::Config config = makeConfig();
+        config.width = 75;
+        config.height = 53;
+        config.tileSize = 24;
+        config.threadCount = 4;
+        config.traversal = traversal;
+
+        RenderPool pool;
+        Image framebuffer;
+        for (const Scene& scene : scenes) {     // warm up
+            TileRenderer::renderInto(scene, config, framebuffer, pool);
+        }
+
+        allocations = 0;
+        countAllocations = true;
+        for (int job = 0; job < 6; ++job) {
+            TileRenderer::renderInto(scenes[job % 2], config, framebuffer, pool);
+        }
+        countAllocations = false;
+        EXPECT_EQ(allocations.load(), 0) << traversalName(traversal);
+        EXPECT_TRUE(TileRenderer::lastErrors().empty());
+
+        // Same pixels as a row-major render
+        RayTracer::Config rowMajor = config;
+        rowMajor.traversal = Traversal::RowMajor;
+        EXPECT_EQ(ImageWriter::toRGBA8(framebuffer),
+                  ImageWriter::toRGBA8(TileRenderer::render(scenes[1], rowMajor)))
+            << traversalName(traversal);
+    }
+}
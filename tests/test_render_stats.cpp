@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "raytracer/render_stats.h"
+#include "raytracer/tile_renderer.h"
+#include "scene/mesh_builder.h"
+#include "output/image_writer.h"
+#include "test_common.h"
+#include <atomic>
+
+static RayTracer::Config makeConfig() {
+    RayTracer::Config config = testRenderConfig(32, 24, 2);
+    config.maxBounces = 0;
+    config.tileSize = 8;
+    config.threadCount = 3;
+    return config;
+}
+
+// ── Ray counters ───────────────────────────────────────────────────────────
+
+#if MCSKIN_RENDER_STATS
+
+TEST(RenderStats, CountsOnePrimaryRayPerSample) {
+    Scene scene;
+    scene.camera = Camera{Vec3(0, 18, 40), Vec3(0, 18, 0), Vec3(0, 1, 0), 60.0f};
+    RayTracer::Config config = makeConfig();
+
+    RenderMonitor monitor;
+    RenderControl control;
+    control.monitor = &monitor;
+    TileRenderer::render(scene, config, nullptr, &control);
+
+    RenderStatsSnapshot s = monitor.snapshot();
+    EXPECT_EQ(s.rays[RayKind::Primary], 32u * 24u * 2u);
+    // Nothing to hit: no secondary rays
+    EXPECT_EQ(s.rays[RayKind::Shadow], 0u);
+    EXPECT_EQ(s.rays[RayKind::AO], 0u);
+    EXPECT_EQ(s.rays[RayKind::Reflection], 0u);
+    EXPECT_EQ(s.rays.total(), s.rays[RayKind::Primary]);
+}
+
+TEST(RenderStats, CountsSecondaryRaysByKind) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = makeConfig();
+    config.aoEnabled = true;
+    config.maxBounces = 2;
+
+    RenderMonitor monitor;
+    RenderControl control;
+    control.monitor = &monitor;
+    TileRenderer::render(scene, config, nullptr, &control);
+
+    RenderStatsSnapshot s = monitor.snapshot();
+    EXPECT_GT(s.rays[RayKind::Shadow], 0u);
+    EXPECT_GT(s.rays[RayKind::AO], 0u);
+    EXPECT_GT(s.rays[RayKind::Reflection], 0u);
+    EXPECT_GT(s.mraysPerSecond(), 0.0);
+}
+
+// Opaque skin whose outer layer is a checkerboard of transparent texels
+static Scene makeCheckerScene() {
+    Image img(64, 64);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            bool outer = (y < 16 && x >= 32) || (y >= 32 && y < 48) ||
+                         (y >= 48 && (x < 16 || x >= 48));
+            float a = outer && (x + y) % 2 ? 0.0f : 1.0f;
+            img.pixels[y * 64 + x] = Color(x / 64.0f, y / 64.0f, 0.5f, a);
+        }
+    }
+    std::vector<uint8_t> rgba = ImageWriter::toRGBA8(img);
+    return MeshBuilder::buildScene(*SkinParser::parse(Rgba8View{rgba.data(), 64, 64}).value);
+}
+
+TEST(RenderStats, LastStatsMergesWorkCounters) {
+    Scene scene = makeCheckerScene();
+    RayTracer::Config config = makeConfig();
+    config.maxBounces = 2;
+    TileRenderer::render(scene, config);
+
+    const RenderStats& stats = TileRenderer::lastStats();
+    const WorkCounters& c = stats.counters;
+    EXPECT_EQ(c.rays[RayKind::Primary], 32u * 24u * 2u);
+    // Every scene intersection tests every mesh's box once: one per
+    // traceRay() call, shadow ray and AO ray
+    uint64_t traces = 0;
+    for (uint64_t n : c.traceDepth) traces += n;
+    EXPECT_EQ(c.boxTests, (traces + c.rays[RayKind::Shadow] + c.rays[RayKind::AO])
+                              * scene.meshes.size());
+    EXPECT_GT(c.textureSamples, 0u);
+    EXPECT_GT(c.transparentMisses, 0u);     // outer layer has transparent texels
+    EXPECT_GT(c.backFaceFallbacks, 0u);
+    // One depth-0 trace per primary ray; reflections fill the deeper bins
+    EXPECT_EQ(c.traceDepth[0], c.rays[RayKind::Primary]);
+    EXPECT_EQ(c.traceDepth[1] + c.traceDepth[2], c.rays[RayKind::Reflection]);
+}
+
+#else
+
+TEST(RenderStats, CountersCompiledOut) {
+    TileRenderer::render(MeshBuilder::buildDefaultScene(), makeConfig());
+    EXPECT_EQ(TileRenderer::lastStats().counters.rays.total(), 0u);
+    EXPECT_EQ(TileRenderer::lastStats().counters.boxTests, 0u);
+}
+
+#endif
+
+TEST(RenderStats, LastStatsPhaseTimes) {
+    Scene scene;
+    RayTracer::Config config = makeConfig();
+    std::atomic<int> callbacks{0};
+    TileRenderer::render(scene, config, [&](int, int) { ++callbacks; });
+
+    const RenderStats& stats = TileRenderer::lastStats();
+    EXPECT_EQ(stats.tiles, 12);
+    EXPECT_EQ(stats.threads, 3);
+    EXPECT_GT(stats.totalSeconds, 0.0);
+    EXPECT_GT(stats.traceSeconds, 0.0);
+    EXPECT_GE(stats.tailSeconds, 0.0);
+    EXPECT_LE(stats.tailSeconds, stats.totalSeconds);
+    EXPECT_DOUBLE_EQ(stats.pausedSeconds, 0.0);
+    EXPECT_EQ(callbacks.load(), 12);
+}
+
+// ── Monitor ────────────────────────────────────────────────────────────────
+
+TEST(RenderStats, MonitorTracksTilesAndThreads) {
+    Scene scene;
+    RayTracer::Config config = makeConfig();
+
+    RenderMonitor monitor;
+    RenderControl control;
+    control.monitor = &monitor;
+    TileRenderer::render(scene, config, nullptr, &control);
+
+    RenderStatsSnapshot s = monitor.snapshot();
+    EXPECT_EQ(s.tilesTotal, 12);   // 4x3 tiles of 8px
+    EXPECT_EQ(s.tilesDone, 12);
+    EXPECT_EQ(s.threadCount, 3);
+    EXPECT_EQ(s.activeThreads, 0);
+    EXPECT_DOUBLE_EQ(s.etaSeconds, 0.0);
+}
+
+TEST(RenderStats, EtaFromMeanTileTime) {
+    RenderMonitor monitor;
+    EXPECT_LT(monitor.snapshot().etaSeconds, 0.0);   // unknown before the first tile
+
+    monitor.begin(10, 2);
+    for (int i = 0; i < 4; ++i) {
+        monitor.tileStarted();
+        monitor.tileFinished(0.5, RayCounts());
+    }
+
+    // 6 tiles left at 0.5 s each, on 2 workers
+    RenderStatsSnapshot s = monitor.snapshot();
+    EXPECT_DOUBLE_EQ(s.meanTileSeconds, 0.5);
+    EXPECT_DOUBLE_EQ(s.etaSeconds, 1.5);
+}
+
+TEST(RenderStats, EtaFromEstimatedCost) {
+    // Costliest first: two tiles took 1 s each for 8 of 10 cost units
+    RenderMonitor monitor;
+    monitor.begin(10, 2, 10.0);
+    for (int i = 0; i < 2; ++i) {
+        monitor.tileStarted();
+        monitor.tileFinished(1.0, RayCounts(), 4.0);
+    }
+    // A split tile counts once, with its last piece
+    monitor.tileStarted();
+    monitor.tileFinished(0.0, RayCounts(), 0.0, false);
+
+    RenderStatsSnapshot s = monitor.snapshot();
+    EXPECT_EQ(s.tilesDone, 2);
+    EXPECT_DOUBLE_EQ(s.etaSeconds, 2.0 * 2.0 / 8.0 / 2.0);
+}
+
+#ifdef __linux__
+TEST(RenderStats, ReportsProcessMemory) {
+    EXPECT_GT(RenderMonitor::processMemoryBytes(), 0u);
+}
+#endif
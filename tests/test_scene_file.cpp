@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "scene/scene_file.h"
+#include "scene/mesh_builder.h"
+#include "scene/pose.h"
+#include "raytracer/tile_renderer.h"
+#include <cstdio>
+#include <fstream>
+
+// Helper: a 64x64 skin with a coordinate-derived pattern and a partially
+// transparent outer layer so that outer meshes are emitted.
+static SkinData makePatternSkin() {
+    Image img(64, 64);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            float a = ((x + y) % 3 == 0) ? 0.0f : 1.0f;
+            img.pixels[y * 64 + x] = Color(x / 63.0f, y / 63.0f, (x ^ y) / 63.0f, a);
+        }
+    }
+    std::string path = "/tmp/test_scene_file_skin.png";
+    img.savePNG(path);
+    auto result = SkinParser::parse(path);
+    std::remove(path.c_str());
+    return *result.value;
+}
+
+static std::string tempPath(const std::string& name) {
+    return "/tmp/" + name + ".mcscene";
+}
+
+TEST(SceneFile, RoundTripPreservesMeshes) {
+    Scene scene = MeshBuilder::buildScene(makePatternSkin(), getBuiltinPoses()[1]);
+    std::string path = tempPath("roundtrip");
+    ASSERT_TRUE(SceneFile::write(scene, path));
+
+    auto opened = SceneFile::open(path);
+    ASSERT_TRUE(opened.isOk()) << *opened.error;
+    const MappedScene& mapped = *opened.value;
+
+    ASSERT_EQ(mapped.meshCount(), scene.meshes.size());
+    for (uint32_t i = 0; i < mapped.meshCount(); ++i) {
+        const Mesh& src = scene.meshes[i];
+        const SceneFileMesh& rec = mapped.mesh(i);
+        EXPECT_EQ((rec.flags & SceneFileMesh::OUTER_LAYER) != 0, src.isOuterLayer);
+        EXPECT_EQ((rec.flags & SceneFileMesh::ROTATED) != 0, src.hasRotation);
+        for (int f = 0; f < 6; ++f) {
+            const TextureRegion& tex = src.ownedTextures[f];
+            const SceneFileFace& face = rec.faces[f];
+            ASSERT_EQ(face.width, tex.width);
+            ASSERT_EQ(face.height, tex.height);
+            const Color* texels = mapped.texels(face);
+            for (int p = 0; p < tex.width * tex.height; ++p) {
+                EXPECT_EQ(texels[p], tex.pixels[p]);
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SceneFile, LoadedSceneRendersIdentically) {
+    Scene scene = MeshBuilder::buildScene(makePatternSkin(), getBuiltinPoses()[3]);
+    std::string path = tempPath("render");
+    ASSERT_TRUE(SceneFile::write(scene, path));
+
+    auto opened = SceneFile::open(path);
+    ASSERT_TRUE(opened.isOk());
+    Scene loaded = opened.value->toScene();
+
+    RayTracer::Config config;
+    config.width = 24;
+    config.height = 24;
+    config.maxBounces = 1;
+    config.tileSize = 8;
+    config.threadCount = 1;
+    config.shadowSamples = 2;
+
+    Image a = TileRenderer::render(scene, config);
+    Image b = TileRenderer::render(loaded, config);
+    ASSERT_EQ(a.pixels.size(), b.pixels.size());
+    for (size_t i = 0; i < a.pixels.size(); ++i) {
+        EXPECT_EQ(a.pixels[i], b.pixels[i]) << "pixel " << i;
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(SceneFile, RejectsInvalidFiles) {
+    EXPECT_FALSE(SceneFile::open("/tmp/definitely_missing.mcscene").isOk());
+
+    std::string path = tempPath("garbage");
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string junk(sizeof(SceneFileHeader) + 32, 'x');
+        out.write(junk.data(), static_cast<std::streamsize>(junk.size()));
+    }
+    auto result = SceneFile::open(path);
+    ASSERT_FALSE(result.isOk());
+    EXPECT_NE(result.error->find("Not a scene file"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(SceneFile, RejectsTruncatedFile) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    std::string path = tempPath("truncated");
+    ASSERT_TRUE(SceneFile::write(scene, path));
+
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    EXPECT_FALSE(SceneFile::open(path).isOk());
+    std::remove(path.c_str());
+}
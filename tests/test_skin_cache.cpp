@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "skin/skin_cache.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class SkinCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = (fs::temp_directory_path() / "mcskin_cache_test").string();
+        fs::remove_all(dir_);
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    static std::vector<uint8_t> bytes(const std::string& s) {
+        return std::vector<uint8_t>(s.begin(), s.end());
+    }
+
+    std::string dir_;
+};
+
+TEST_F(SkinCacheTest, MissOnEmptyCache) {
+    SkinCache cache(dir_);
+    EXPECT_TRUE(fs::is_directory(dir_));
+    EXPECT_FALSE(cache.lookup("skin:http://x/1", 60).has_value());
+}
+
+TEST_F(SkinCacheTest, StoreThenLookupHonoursTtl) {
+    SkinCache cache(dir_);
+    auto data = bytes("\x89PNG fake skin bytes");
+    ASSERT_TRUE(cache.store("skin:http://x/1", data.data(), data.size(), "\"abc\"", 1000));
+
+    auto fresh = cache.lookup("skin:http://x/1", 60, 1030);
+    ASSERT_TRUE(fresh.has_value());
+    EXPECT_TRUE(fresh->fresh);
+    EXPECT_EQ(fresh->data, data);
+    EXPECT_EQ(fresh->etag, "\"abc\"");
+    EXPECT_EQ(fresh->storedAt, 1000);
+
+    // Past the TTL the entry is still returned, but stale, for revalidation
+    auto stale = cache.lookup("skin:http://x/1", 60, 1060);
+    ASSERT_TRUE(stale.has_value());
+    EXPECT_FALSE(stale->fresh);
+    EXPECT_EQ(stale->data, data);
+}
+
+TEST_F(SkinCacheTest, TouchRefreshesWithoutRewritingData) {
+    SkinCache cache(dir_);
+    auto data = bytes("profile json");
+    ASSERT_TRUE(cache.store("profile:1234", data.data(), data.size(), "W/\"v1\"", 1000));
+
+    EXPECT_FALSE(cache.lookup("profile:1234", 10, 2000)->fresh);
+    ASSERT_TRUE(cache.touch("profile:1234", 2000));
+    auto entry = cache.lookup("profile:1234", 10, 2005);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_TRUE(entry->fresh);
+    EXPECT_EQ(entry->data, data);
+    EXPECT_EQ(entry->etag, "W/\"v1\"");
+
+    EXPECT_FALSE(cache.touch("profile:missing", 2000));
+}
+
+TEST_F(SkinCacheTest, ReplaceAndRemove) {
+    SkinCache cache(dir_);
+    auto a = bytes("first");
+    auto b = bytes("second, longer value");
+    ASSERT_TRUE(cache.store("uuid:notch", a.data(), a.size()));
+    ASSERT_TRUE(cache.store("uuid:notch", b.data(), b.size()));
+    EXPECT_EQ(cache.lookup("uuid:notch", 60)->data, b);
+
+    // Entries persist across instances
+    SkinCache reopened(dir_);
+    EXPECT_EQ(reopened.lookup("uuid:notch", 60)->data, b);
+
+    reopened.remove("uuid:notch");
+    EXPECT_FALSE(cache.lookup("uuid:notch", 60).has_value());
+}
+
+TEST_F(SkinCacheTest, CorruptEntryIsAMiss) {
+    SkinCache cache(dir_);
+    auto data = bytes("payload");
+    ASSERT_TRUE(cache.store("skin:k", data.data(), data.size()));
+
+    for (const auto& entry : fs::directory_iterator(dir_)) {
+        std::ofstream(entry.path(), std::ios::binary | std::ios::trunc) << "junk";
+    }
+    EXPECT_FALSE(cache.lookup("skin:k", 60).has_value());
+}
+
+TEST_F(SkinCacheTest, LengthsDisagreeingWithFileSizeAreAMiss) {
+    SkinCache cache(dir_);
+    auto data = bytes("payload");
+    ASSERT_TRUE(cache.store("skin:k", data.data(), data.size(), "\"e1\""));
+    ASSERT_TRUE(cache.store("skin:k", data.data(), data.size(), "\"e2\""));
+
+    // Temp files are renamed away, so the entry is the only file
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir_)) files.push_back(entry.path());
+    ASSERT_EQ(files.size(), 1u);
+    const fs::path path = files[0];
+
+    // A data length of 2^62 in the header must not size a buffer
+    {
+        std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t huge = uint64_t(1) << 62;
+        f.seekp(24);
+        f.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    EXPECT_FALSE(cache.lookup("skin:k", 60).has_value());
+
+    ASSERT_TRUE(cache.store("skin:k", data.data(), data.size()));
+    ASSERT_TRUE(cache.lookup("skin:k", 60).has_value());
+    fs::resize_file(path, fs::file_size(path) - 3);
+    EXPECT_FALSE(cache.lookup("skin:k", 60).has_value());
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "skin/skin_ingest.h"
+#include "skin/skin_pack.h"
+#include "scene/mesh_builder.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// Helper: opaque skin image with a pattern; outer-layer regions cleared
+// unless `hat` is set (then the hat front is painted)
+static Image makeSkin(int height, int seed, bool hat) {
+    Image img(64, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            img.pixels[y * 64 + x] = Color((x * 4 + seed) % 256 / 255.0f,
+                                           (y * 4) % 256 / 255.0f,
+                                           seed % 256 / 255.0f, 1.0f);
+        }
+    }
+    // Clear every outer-layer block so only `hat` decides the mask
+    auto clear = [&](int x0, int y0, int w, int h) {
+        for (int y = y0; y < y0 + h && y < height; ++y)
+            for (int x = x0; x < x0 + w; ++x)
+                img.pixels[y * 64 + x] = Color(0, 0, 0, 0);
+    };
+    clear(32, 0, 32, 16);
+    if (height == 64) {
+        clear(0, 32, 56, 16);   // right pants, jacket, right sleeve
+        clear(0, 48, 16, 16);   // left pants
+        clear(48, 48, 16, 16);  // left sleeve
+    }
+    if (hat) {
+        img.pixels[8 * 64 + 40] = Color(1, 0, 0, 1);  // hat front
+    }
+    return img;
+}
+
+class SkinIngestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / "mcskin_ingest_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_ / "nested");
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    std::string file(const std::string& name) const { return (dir_ / name).string(); }
+
+    fs::path dir_;
+};
+
+TEST_F(SkinIngestTest, CollectsPngFilesRecursivelyAndSorted) {
+    makeSkin(64, 1, false).savePNG(file("b.png"));
+    makeSkin(64, 2, false).savePNG(file("nested/a.PNG"));
+    std::ofstream(file("notes.txt")) << "not a skin";
+
+    std::vector<std::string> missing;
+    auto files = SkinIngest::collectPngFiles({dir_.string(), file("gone.png")}, &missing);
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0], file("b.png"));
+    EXPECT_EQ(files[1], file("nested/a.PNG"));
+    ASSERT_EQ(missing.size(), 1u);
+    EXPECT_EQ(missing[0], file("gone.png"));
+}
+
+TEST_F(SkinIngestTest, ClassifiesFormatOuterLayerAndErrors) {
+    makeSkin(64, 1, true).savePNG(file("hat.png"));
+    makeSkin(64, 2, false).savePNG(file("plain.png"));
+    makeSkin(32, 3, false).savePNG(file("legacy.png"));
+    Image(32, 32).savePNG(file("small.png"));
+    std::ofstream(file("broken.png")) << "garbage";
+
+    std::vector<std::string> paths = {
+        file("hat.png"), file("plain.png"), file("legacy.png"),
+        file("small.png"), file("broken.png"), file("missing.png"),
+    };
+    auto skins = SkinIngest::run(paths, 3);
+    ASSERT_EQ(skins.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) EXPECT_EQ(skins[i].path, paths[i]);
+
+    EXPECT_TRUE(skins[0].valid);
+    EXPECT_EQ(skins[0].format, SkinData::NEW_64x64);
+    EXPECT_EQ(skins[0].outerMask, OUTER_HEAD);
+
+    EXPECT_TRUE(skins[1].valid);
+    EXPECT_EQ(skins[1].outerMask, 0);
+
+    EXPECT_TRUE(skins[2].valid);
+    EXPECT_EQ(skins[2].format, SkinData::OLD_64x32);
+
+    EXPECT_FALSE(skins[3].valid);
+    EXPECT_NE(skins[3].error.find("Invalid skin dimensions"), std::string::npos);
+    EXPECT_FALSE(skins[4].valid);
+    EXPECT_FALSE(skins[5].valid);
+
+    SkinCorpusStats stats = SkinIngest::summarize(skins);
+    EXPECT_EQ(stats.total, 6u);
+    EXPECT_EQ(stats.valid, 3u);
+    EXPECT_EQ(stats.invalid, 3u);
+    EXPECT_EQ(stats.modern, 2u);
+    EXPECT_EQ(stats.legacy, 1u);
+    EXPECT_EQ(stats.withOuterLayer, 1u);
+    EXPECT_EQ(stats.transparentOuter, 2u);
+    EXPECT_EQ(stats.duplicates, 0u);
+}
+
+TEST_F(SkinIngestTest, OuterMaskMatchesMeshBuilderDecision) {
+    Image img = makeSkin(64, 4, true);
+    img.savePNG(file("skin.png"));
+    auto parsed = SkinParser::parse(file("skin.png"));
+    ASSERT_TRUE(parsed.isOk());
+
+    uint8_t mask = SkinIngest::outerLayerMask(*parsed.value);
+    EXPECT_EQ((mask & OUTER_HEAD) != 0, !MeshBuilder::isFullyTransparent(parsed.value->headOuter));
+    EXPECT_EQ((mask & OUTER_BODY) != 0, !MeshBuilder::isFullyTransparent(parsed.value->bodyOuter));
+}
+
+TEST_F(SkinIngestTest, ContentHashMatchesSkinPackAndDetectsDuplicates) {
+    makeSkin(64, 7, false).savePNG(file("one.png"));
+    makeSkin(64, 7, false).savePNG(file("two.png"));
+    makeSkin(64, 8, false).savePNG(file("three.png"));
+
+    auto skins = SkinIngest::run({file("one.png"), file("two.png"), file("three.png")}, 2);
+    EXPECT_EQ(skins[0].contentHash, skins[1].contentHash);
+    EXPECT_NE(skins[0].contentHash, skins[2].contentHash);
+    EXPECT_EQ(SkinIngest::summarize(skins).duplicates, 1u);
+
+    std::string packPath = file("pack.mcpack");
+    SkinPackBuilder builder;
+    ASSERT_TRUE(builder.open(packPath));
+    ASSERT_TRUE(builder.addFile("one", file("one.png")).isOk());
+    ASSERT_TRUE(builder.finish());
+    auto pack = SkinPack::open(packPath);
+    ASSERT_TRUE(pack.isOk());
+    EXPECT_EQ(pack.value->item(0).contentHash, skins[0].contentHash);
+}
+
+TEST_F(SkinIngestTest, IndexRoundTripKeepsValidSkinsOnly) {
+    makeSkin(64, 1, true).savePNG(file("hat.png"));
+    makeSkin(32, 2, false).savePNG(file("legacy.png"));
+    std::ofstream(file("broken.png")) << "garbage";
+
+    auto skins = SkinIngest::run({file("hat.png"), file("broken.png"), file("legacy.png")});
+    std::string indexPath = file("skins.mcidx");
+    ASSERT_TRUE(SkinIndex::write(skins, indexPath));
+
+    auto index = SkinIndex::open(indexPath);
+    ASSERT_TRUE(index.isOk()) << *index.error;
+    ASSERT_EQ(index.value->size(), 2u);
+    EXPECT_EQ(index.value->path(0), file("hat.png"));
+    EXPECT_EQ(index.value->record(0).outerMask, OUTER_HEAD);
+    EXPECT_EQ(index.value->record(0).contentHash, skins[0].contentHash);
+    EXPECT_EQ(index.value->record(0).fileSize, skins[0].fileSize);
+    EXPECT_EQ(index.value->path(1), file("legacy.png"));
+    EXPECT_EQ(index.value->record(1).format, SkinData::OLD_64x32);
+
+    std::ofstream(file("junk.mcidx")) << std::string(128, 'x');
+    EXPECT_FALSE(SkinIndex::open(file("junk.mcidx")).isOk());
+    EXPECT_FALSE(SkinIndex::open(file("nope.mcidx")).isOk());
+}
+
+TEST_F(SkinIngestTest, IndexRefusesPathsItCannotRecord) {
+    makeSkin(64, 1, true).savePNG(file("hat.png"));
+    auto skins = SkinIngest::run({file("hat.png")});
+    ASSERT_TRUE(skins[0].valid);
+
+    // Path lengths are uint16_t: a longer path fails the write instead of
+    // silently leaving the skin out
+    SkinMetadata longPath = skins[0];
+    longPath.path = std::string(0x10000, 'p');
+    skins.push_back(longPath);
+    EXPECT_FALSE(SkinIndex::write(skins, file("skins.mcidx")));
+
+    skins.back().path.resize(0xFFFF);
+    ASSERT_TRUE(SkinIndex::write(skins, file("skins.mcidx")));
+    auto index = SkinIndex::open(file("skins.mcidx"));
+    ASSERT_TRUE(index.isOk()) << *index.error;
+    ASSERT_EQ(index.value->size(), 2u);
+    EXPECT_EQ(index.value->path(1).size(), 0xFFFFu);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "skin/skin_pack.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// Helper: RGBA8 skin pixels with a pattern derived from (x, y, seed)
+static std::vector<uint8_t> makeSkinPixels(int height, int seed) {
+    std::vector<uint8_t> px(64 * height * 4);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            uint8_t* p = &px[(y * 64 + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 4 + seed);
+            p[1] = static_cast<uint8_t>(y * 4 + seed * 3);
+            p[2] = static_cast<uint8_t>((x ^ y) + seed * 7);
+            p[3] = 255;
+        }
+    }
+    return px;
+}
+
+static std::string packPath(const std::string& name) {
+    return "/tmp/" + name + ".mcpack";
+}
+
+TEST(SkinPack, BuildAndLookupByName) {
+    auto a = makeSkinPixels(64, 1);
+    auto b = makeSkinPixels(32, 2);
+    auto c = makeSkinPixels(64, 3);
+
+    std::string path = packPath("lookup");
+    SkinPackBuilder builder;
+    ASSERT_TRUE(builder.open(path));
+    ASSERT_TRUE(builder.add("Notch", {a.data(), 64, 64}).isOk());
+    ASSERT_TRUE(builder.add("legacy", {b.data(), 64, 32}).isOk());
+    ASSERT_TRUE(builder.add("jeb_", {c.data(), 64, 64}).isOk());
+    ASSERT_TRUE(builder.finish());
+
+    auto pack = SkinPack::open(path);
+    ASSERT_TRUE(pack.isOk()) << *pack.error;
+    ASSERT_EQ(pack.value->size(), 3u);
+
+    auto idx = pack.value->find("legacy");
+    ASSERT_TRUE(idx.has_value());
+    SkinPackItem item = pack.value->item(*idx);
+    EXPECT_EQ(item.name, "legacy");
+    EXPECT_EQ(item.pixels.width, 64);
+    EXPECT_EQ(item.pixels.height, 32);
+    EXPECT_EQ(0, std::memcmp(item.pixels.data, b.data(), b.size()));
+
+    EXPECT_FALSE(pack.value->find("nobody").has_value());
+
+    std::remove(path.c_str());
+}
+
+TEST(SkinPack, SequentialIterationFollowsInsertionOrder) {
+    // 40 entries: the builder's index grows twice
+    std::string path = packPath("sequential");
+    SkinPackBuilder builder;
+    ASSERT_TRUE(builder.open(path));
+    std::vector<std::vector<uint8_t>> skins;
+    for (int i = 0; i < 40; ++i) {
+        skins.push_back(makeSkinPixels(64, i));
+        ASSERT_TRUE(builder.add("player" + std::to_string(i), {skins.back().data(), 64, 64}).isOk());
+    }
+    EXPECT_FALSE(builder.add("player17", {skins[0].data(), 64, 64}).isOk());
+    ASSERT_TRUE(builder.finish());
+
+    auto pack = SkinPack::open(path);
+    ASSERT_TRUE(pack.isOk());
+    pack.value->adviseSequential();
+
+    const uint8_t* prevEnd = nullptr;
+    for (size_t i = 0; i < pack.value->size(); ++i) {
+        SkinPackItem item = pack.value->item(i);
+        EXPECT_EQ(item.name, "player" + std::to_string(i));
+        EXPECT_EQ(0, std::memcmp(item.pixels.data, skins[i].data(), skins[i].size()));
+        // Texel blocks are laid out back to back
+        if (prevEnd) {
+            EXPECT_EQ(item.pixels.data, prevEnd);
+        }
+        prevEnd = item.pixels.data + skins[i].size();
+        EXPECT_EQ(pack.value->find(item.name), i);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(SkinPack, ParseEntryMatchesParseFromFile) {
+    auto px = makeSkinPixels(64, 5);
+    std::string path = packPath("parse");
+    SkinPackBuilder builder;
+    ASSERT_TRUE(builder.open(path));
+    ASSERT_TRUE(builder.add("skin", {px.data(), 64, 64}).isOk());
+    ASSERT_TRUE(builder.finish());
+
+    // Reference: the same pixels through the PNG path
+    Image img(64, 64);
+    for (int i = 0; i < 64 * 64; ++i) {
+        img.pixels[i] = Color(px[i * 4] / 255.0f, px[i * 4 + 1] / 255.0f,
+                              px[i * 4 + 2] / 255.0f, px[i * 4 + 3] / 255.0f);
+    }
+    std::string pngPath = "/tmp/test_skin_pack_ref.png";
+    img.savePNG(pngPath);
+    auto expected = SkinParser::parse(pngPath);
+    ASSERT_TRUE(expected.isOk());
+
+    auto pack = SkinPack::open(path);
+    ASSERT_TRUE(pack.isOk());
+    auto parsed = pack.value->parse(0);
+    ASSERT_TRUE(parsed.isOk());
+    EXPECT_EQ(parsed.value->format, SkinData::NEW_64x64);
+
+    const TextureRegion& got = parsed.value->head.front;
+    const TextureRegion& want = expected.value->head.front;
+    ASSERT_EQ(got.pixels.size(), want.pixels.size());
+    for (size_t i = 0; i < got.pixels.size(); ++i) {
+        EXPECT_EQ(got.pixels[i], want.pixels[i]);
+    }
+
+    EXPECT_FALSE(pack.value->parse(1).isOk());
+
+    std::remove(path.c_str());
+    std::remove(pngPath.c_str());
+}
+
+TEST(SkinPack, BuilderRejectsInvalidEntries) {
+    auto px = makeSkinPixels(64, 0);
+    SkinPackBuilder builder;
+    EXPECT_FALSE(builder.add("early", {px.data(), 64, 64}).isOk());   // not open
+
+    std::string path = packPath("invalid");
+    ASSERT_TRUE(builder.open(path));
+    EXPECT_FALSE(builder.add("", {px.data(), 64, 64}).isOk());
+    EXPECT_FALSE(builder.add("wide", {px.data(), 128, 32}).isOk());
+    EXPECT_FALSE(builder.add("null", {nullptr, 64, 64}).isOk());
+    EXPECT_TRUE(builder.add("dup", {px.data(), 64, 64}).isOk());
+    EXPECT_FALSE(builder.add("dup", {px.data(), 64, 64}).isOk());
+    EXPECT_EQ(builder.size(), 1u);
+    std::remove(path.c_str());
+}
+
+TEST(SkinPack, UnfinishedPackIsRejected) {
+    auto px = makeSkinPixels(64, 0);
+    std::string path = packPath("unfinished");
+    {
+        SkinPackBuilder builder;
+        ASSERT_TRUE(builder.open(path));
+        ASSERT_TRUE(builder.add("skin", {px.data(), 64, 64}).isOk());
+    }
+    EXPECT_FALSE(SkinPack::open(path).isOk());
+    std::remove(path.c_str());
+}
+
+TEST(SkinPack, OpenRejectsGarbage) {
+    EXPECT_FALSE(SkinPack::open("/tmp/definitely_missing.mcpack").isOk());
+
+    std::string path = packPath("garbage");
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string junk(256, 'z');
+        out.write(junk.data(), static_cast<std::streamsize>(junk.size()));
+    }
+    EXPECT_FALSE(SkinPack::open(path).isOk());
+    std::remove(path.c_str());
+}
+
+TEST(SkinPack, EmptyPackIsValid) {
+    SkinPackBuilder builder;
+    std::string path = packPath("empty");
+    ASSERT_TRUE(builder.open(path));
+    ASSERT_TRUE(builder.finish());
+
+    auto pack = SkinPack::open(path);
+    ASSERT_TRUE(pack.isOk());
+    EXPECT_EQ(pack.value->size(), 0u);
+    EXPECT_FALSE(pack.value->find("anyone").has_value());
+    std::remove(path.c_str());
+}
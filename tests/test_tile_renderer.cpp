@@ -157,3 +157,114 @@ TEST(TileRenderer, NullProgressCallbackIsOk) {
     Image img = TileRenderer::render(scene, config, nullptr);
     EXPECT_EQ(img.width, 8);
 }
+
+TEST(TileRenderer, OutputIndependentOfTileLayout) {
+    // Samples are seeded per pixel, so tile size must not change the image
+    Scene scene = makeSimpleScene();
+    RayTracer::Config a;
+    a.width = 24;
+    a.height = 20;
+    a.maxBounces = 0;
+    a.samplesPerPixel = 4;
+    a.tileSize = 8;
+    a.threadCount = 3;
+
+    RayTracer::Config b = a;
+    b.tileSize = 5;
+    b.threadCount = 1;
+
+    Image imgA = TileRenderer::render(scene, a);
+    Image imgB = TileRenderer::render(scene, b);
+    ASSERT_EQ(imgA.pixels.size(), imgB.pixels.size());
+    for (size_t i = 0; i < imgA.pixels.size(); ++i) {
+        EXPECT_EQ(imgA.pixels[i], imgB.pixels[i]) << "pixel " << i;
+    }
+}
+
+TEST(TileRenderer, CancelStopsPickingUpTiles) {
+    Scene scene = makeSimpleScene();
+    RayTracer::Config config;
+    config.width = 64;
+    config.height = 64;
+    config.maxBounces = 0;
+    config.tileSize = 8;
+    config.threadCount = 1;
+
+    // Cancel from the progress callback after the first tile
+    RenderControl control;
+    int completed = 0;
+    Image img = TileRenderer::render(scene, config, [&](int done, int) {
+        completed = done;
+        control.cancel.store(true);
+    }, &control);
+
+    EXPECT_EQ(completed, 1);
+    EXPECT_EQ(img.width, 64);
+    EXPECT_EQ(img.height, 64);
+}
+
+// ── Render region tests ────────────────────────────────────────────────────
+
+TEST(TileRenderer, RenderRegionClampsToImage) {
+    RayTracer::Config config;
+    config.width = 100;
+    config.height = 50;
+
+    Tile full = TileRenderer::renderRegion(config);
+    EXPECT_EQ(full.x, 0);  EXPECT_EQ(full.y, 0);
+    EXPECT_EQ(full.width, 100); EXPECT_EQ(full.height, 50);
+
+    config.regionX = 90;
+    config.regionY = -10;
+    config.regionWidth = 30;
+    config.regionHeight = 20;
+    Tile r = TileRenderer::renderRegion(config);
+    EXPECT_EQ(r.x, 90); EXPECT_EQ(r.y, 0);
+    EXPECT_EQ(r.width, 10); EXPECT_EQ(r.height, 10);
+}
+
+TEST(TileRenderer, RegionRenderMatchesFullRenderInsideRegion) {
+    Scene scene = makeSimpleScene();
+    RayTracer::Config full;
+    full.width = 40;
+    full.height = 30;
+    full.maxBounces = 0;
+    full.samplesPerPixel = 3;
+    full.tileSize = 16;
+    full.threadCount = 2;
+
+    RayTracer::Config region = full;
+    region.regionX = 10;
+    region.regionY = 5;
+    region.regionWidth = 12;
+    region.regionHeight = 9;
+
+    // 12×9 at (10,5) touches tiles (0,0) and (1,0) of the 16-pixel grid
+    int total = 0;
+    Image imgFull = TileRenderer::render(scene, full);
+    Image imgRegion = TileRenderer::render(scene, region, [&](int, int t) { total = t; });
+    EXPECT_EQ(total, 2);
+
+    for (int y = 0; y < full.height; ++y) {
+        for (int x = 0; x < full.width; ++x) {
+            const Color& c = imgRegion.pixels[y * full.width + x];
+            bool inside = x >= 10 && x < 22 && y >= 5 && y < 14;
+            if (inside) {
+                EXPECT_EQ(c, imgFull.pixels[y * full.width + x]) << x << "," << y;
+            } else {
+                EXPECT_EQ(c, Color()) << x << "," << y;
+            }
+        }
+    }
+
+    // Compositing the region over the full render reproduces the full render
+    Image base = imgFull;
+    for (auto& p : base.pixels) p = Color(1, 0, 1);
+    for (int y = 5; y < 14; ++y)
+        for (int x = 10; x < 22; ++x) base.pixels[y * full.width + x] = Color(0, 1, 0);
+    TileRenderer::compositeRegion(base, imgRegion, region);
+    for (int y = 5; y < 14; ++y)
+        for (int x = 10; x < 22; ++x)
+            EXPECT_EQ(base.pixels[y * full.width + x], imgFull.pixels[y * full.width + x]);
+    EXPECT_EQ(base.pixels[0], Color(1, 0, 1));
+}
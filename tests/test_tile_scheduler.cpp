@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "raytracer/tile_scheduler.h"
+#include "raytracer/tile_renderer.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include "test_common.h"
+#include <algorithm>
+#include <mutex>
+
+TEST(TileScheduler, CostFirstTakesCostliestTilesFirst) {
+    std::vector<Tile> tiles = TileRenderer::generateTiles(32, 8, 8);
+    std::vector<double> costs = {1.0, 5.0, 3.0, 5.0};
+
+    TileScheduler inOrder(tiles, costs, TileSchedule::InOrder, 1);
+    TileScheduler costFirst(tiles, costs, TileSchedule::CostFirst, 1);
+    std::vector<int> a, b;
+    ScheduledTile t;
+    while (inOrder.next(t)) a.push_back(t.index);
+    while (costFirst.next(t)) b.push_back(t.index);
+    EXPECT_EQ(a, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(b, (std::vector<int>{1, 3, 2, 0}));   // ties keep grid order
+}
+
+TEST(TileScheduler, SplitsTailTilesForIdleWorkers) {
+    std::vector<Tile> tiles = {Tile{0, 0, 32, 32}, Tile{32, 0, 8, 8}};
+    TileScheduler scheduler(tiles, {10.0, 1.0}, TileSchedule::CostFirst, 4, 8);
+
+    std::vector<ScheduledTile> pieces;
+    ScheduledTile t;
+    while (scheduler.next(t)) pieces.push_back(t);
+    EXPECT_GT(scheduler.splits(), 0);
+    EXPECT_GT(pieces.size(), 4u);
+
+    // The pieces of tile 0 cover it exactly once, none smaller than 8 px
+    int area = 0;
+    for (const ScheduledTile& p : pieces) {
+        if (p.index != 0) continue;
+        EXPECT_GE(p.tile.width, 8);
+        EXPECT_GE(p.tile.height, 8);
+        area += p.tile.width * p.tile.height;
+    }
+    EXPECT_EQ(area, 32 * 32);
+
+    // Only the last piece of a tile completes it
+    int completed = 0;
+    for (const ScheduledTile& p : pieces) {
+        if (scheduler.finish(p.index)) ++completed;
+    }
+    EXPECT_EQ(completed, 2);
+}
+
+TEST(TileScheduler, ShapesCoverEveryPieceHandedOut) {
+    // Ragged shapes: odd halves leave thin remainder pieces
+    std::vector<Tile> tiles = {Tile{0, 0, 37, 29}, Tile{37, 0, 19, 8}, Tile{0, 29, 5, 5}};
+    TileScheduler scheduler(tiles, {30.0, 5.0, 1.0}, TileSchedule::CostFirst, 8, 4);
+    const auto shapes = TileScheduler::shapes(tiles, 4);
+
+    ScheduledTile t;
+    int pieces = 0;
+    while (scheduler.next(t)) {
+        ++pieces;
+        auto shape = std::make_pair(t.tile.width, t.tile.height);
+        EXPECT_NE(std::find(shapes.begin(), shapes.end(), shape), shapes.end())
+            << t.tile.width << "x" << t.tile.height;
+    }
+    EXPECT_GT(scheduler.splits(), 1);
+    EXPECT_GT(pieces, 8);
+}
+
+TEST(TileScheduler, TilesOverTheCharacterCostMore) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config = testRenderConfig(64, 64);
+    config.aoEnabled = true;
+    std::vector<Tile> tiles = TileRenderer::generateTiles(64, 64, 16);
+    std::vector<double> costs = TileScheduler::estimateCosts(scene, config, tiles);
+    ASSERT_EQ(costs.size(), tiles.size());
+
+    // Corner tiles are background, the centre column is the character
+    double corner = costs[0];
+    double centre = costs[1 * 4 + 1];
+    EXPECT_GT(corner, 0.0);
+    EXPECT_GT(centre, 2.0 * corner);
+}
+
+TEST(TileScheduler, ScheduleDoesNotChangeTheImage) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config a = testRenderConfig(72, 40, 2);
+    a.tileSize = 8;
+    a.threadCount = 3;
+    a.tileSchedule = TileSchedule::InOrder;
+    RayTracer::Config b = a;
+    b.tileSchedule = TileSchedule::CostFirst;
+    b.tileSize = 32;        // few large tiles: the tail gets split
+
+    std::mutex mutex;
+    std::vector<int> progress;
+    CostMap cost;
+    RenderControl control;
+    control.costMap = &cost;
+    Image ordered = TileRenderer::render(scene, a);
+    Image scheduled = TileRenderer::render(scene, b, [&](int done, int total) {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.push_back(done);
+        EXPECT_EQ(total, 6);
+    }, &control);
+    EXPECT_EQ(ImageWriter::toRGBA8(ordered), ImageWriter::toRGBA8(scheduled));
+
+    // Progress counts grid tiles, however they were split
+    ASSERT_EQ(progress.size(), 6u);
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    ASSERT_EQ(cost.tiles.size(), 6u);
+    for (const TileCost& tc : cost.tiles) EXPECT_GE(tc.thread, 0);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "raytracer/traversal.h"
+#include "raytracer/tile_renderer.h"
+#include "output/image_writer.h"
+#include "scene/mesh_builder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+TEST(Traversal, MortonInterleavesBits) {
+    EXPECT_EQ(mortonIndex(0, 0), 0u);
+    EXPECT_EQ(mortonIndex(1, 0), 1u);
+    EXPECT_EQ(mortonIndex(0, 1), 2u);
+    EXPECT_EQ(mortonIndex(1, 1), 3u);
+    EXPECT_EQ(mortonIndex(2, 0), 4u);
+    EXPECT_EQ(mortonIndex(7, 7), 63u);
+}
+
+TEST(Traversal, HilbertStepsToANeighbourEveryTime) {
+    auto cells = traversalOrder(16, 16, Traversal::Hilbert);
+    ASSERT_EQ(cells.size(), 256u);
+    EXPECT_EQ(cells.front(), std::make_pair(0, 0));
+    for (size_t i = 1; i < cells.size(); ++i) {
+        int step = std::abs(cells[i].first - cells[i - 1].first)
+                 + std::abs(cells[i].second - cells[i - 1].second);
+        EXPECT_EQ(step, 1) << "at " << i;
+    }
+}
+
+TEST(Traversal, EveryOrderVisitsEachCellOnce) {
+    for (Traversal t : {Traversal::RowMajor, Traversal::Morton, Traversal::Hilbert}) {
+        auto cells = traversalOrder(13, 5, t);   // not a power-of-two square
+        std::set<std::pair<int, int>> unique(cells.begin(), cells.end());
+        EXPECT_EQ(cells.size(), 65u) << traversalName(t);
+        EXPECT_EQ(unique.size(), 65u) << traversalName(t);
+        for (const auto& [x, y] : cells) {
+            EXPECT_TRUE(x >= 0 && x < 13 && y >= 0 && y < 5);
+        }
+    }
+    EXPECT_TRUE(traversalOrder(0, 5, Traversal::Hilbert).empty());
+}
+
+TEST(Traversal, TilesFollowTheCurve) {
+    auto tiles = TileRenderer::generateTiles(64, 64, 16, Traversal::Morton);
+    ASSERT_EQ(tiles.size(), 16u);
+    EXPECT_EQ(tiles[1].x, 16);
+    EXPECT_EQ(tiles[1].y, 0);
+    EXPECT_EQ(tiles[2].x, 0);
+    EXPECT_EQ(tiles[2].y, 16);
+}
+
+TEST(Traversal, OrderDoesNotChangeTheImage) {
+    Scene scene = MeshBuilder::buildDefaultScene();
+    RayTracer::Config config;
+    config.width = 50;
+    config.height = 36;
+    config.samplesPerPixel = 2;
+    config.maxBounces = 1;
+    config.tileSize = 16;
+    config.threadCount = 2;
+    std::vector<uint8_t> reference = ImageWriter::toRGBA8(TileRenderer::render(scene, config));
+    for (Traversal t : {Traversal::Morton, Traversal::Hilbert}) {
+        config.traversal = t;
+        EXPECT_EQ(ImageWriter::toRGBA8(TileRenderer::render(scene, config)), reference)
+            << traversalName(t);
+    }
+}